@@ -160,6 +160,7 @@ static NVWindowController* openWith(NSArray<NVWindowController*> *windows,
     options.cacheInitialCapacity = 1;
     options.cacheEvictionThreshold = 8;
     options.cacheEvictionPreserve = 2;
+    options.glyphColorClasses = [NVPreferences glyphColorClasses];
 
     contextManager = [[NVRenderContextManager alloc] initWithOptions:options delegate:self];
 }
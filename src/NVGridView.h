@@ -38,6 +38,10 @@ NS_ASSUME_NONNULL_BEGIN
 /// - [desiredFrameSize:] changes accordingly.
 @property (nonatomic) const nvim::grid *grid;
 
+/// The keypress latency tracker, may be null.
+/// If set, the view reports the draw tick of every grid it presents.
+@property (nonatomic, nullable) nvim::latency_tracker *latencyTracker;
+
 /// The view's font family.
 /// The view's scale factor is also set by the font's scale factor. Changing a
 /// view's font may cause the view's cell size to change.
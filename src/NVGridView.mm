@@ -10,11 +10,13 @@
 #import <QuartzCore/CAMetalLayer.h>
 #import <Metal/Metal.h>
 #import "NVGridView.h"
+#include "frame_builder.hpp"
 #include "shader_types.hpp"
 
 /// Utility class to help manage Metal buffers.
 /// The class provides two additional abstractions over a MTLBuffer:
-///   1. A low overhead locking mechanism.
+///   1. A low overhead locking mechanism, counting the command buffers using
+///      the buffer. The buffer may only be written while it has no users.
 ///   2. A means to coalesce multiple allocations into a single MTLBuffer.
 class mtlbuffer {
 private:
@@ -23,7 +25,7 @@ private:
     char *ptr;
     size_t length;
     size_t capacity;
-    std::atomic_flag in_use;
+    std::atomic<uint32_t> users;
 
     static constexpr size_t align_up(size_t val, size_t alignment) {
         return (val + alignment - 1) & -alignment;
@@ -43,6 +45,7 @@ public:
         ptr = nullptr;
         length = 0;
         capacity = 0;
+        users = 0;
     }
 
     /// Creates the underlying MTLBuffer.
@@ -52,8 +55,9 @@ public:
     ///
     /// If the existing buffer is on the same device, and is of sufficient
     /// length, it is reused. Otherwise a new buffer is allocated and the
-    /// existing buffer is freed. Calling this function invalidates any
-    /// previously allocated memory regions.
+    /// existing buffer is freed. Buffers grow geometrically, so a slowly
+    /// growing size doesn't cause a reallocation every frame. Calling this
+    /// function invalidates any previously allocated memory regions.
     void create(id<MTLDevice> device, size_t size) {
         length = 0;
 
@@ -62,6 +66,8 @@ public:
             size = std::max(1048576ul, align_up(size, 8));
         } else if (size <= capacity) {
             return;
+        } else {
+            size = align_up(std::max(size, capacity + (capacity / 2)), 8);
         }
 
         buffer = [device newBufferWithLength:size
@@ -94,121 +100,78 @@ public:
         [buffer didModifyRange:NSMakeRange(start, length)];
     }
 
-    /// Try to acquire the buffers lock. Returns immediately.
+    /// Try to acquire the buffers lock, for writing. Returns immediately.
     ///
     /// Note: Calling this function in a loop amounts to an inefficient, and
     /// more importantly, incorrect, spinlock implementation. Don't do it.
     ///
     /// @returns True if the lock was acquired successfully, otherwise false.
     bool try_lock() {
-        return in_use.test_and_set() == false;
+        uint32_t expected = 0;
+        return users.compare_exchange_strong(expected, 1);
+    }
+
+    /// Acquires the buffers lock, for reading. The buffer is only read by the
+    /// GPU, so any number of command buffers may share it.
+    void share() {
+        users.fetch_add(1);
     }
 
     /// Release the buffers lock. May be called from any thread.
     void unlock() {
-        in_use.clear();
+        users.fetch_sub(1);
     }
 };
 
-/// Adjusts the color attributes of cells under a block cursor.
-class AdjustedGrid {
-private:
-    struct Range {
-        const nvim::cell *begin;
-        int16_t rowBegin;
-        int16_t rowEnd;
-        int16_t colBegin;
-        int16_t colEnd;
-    };
-
-    nvim::cell adjustedCells[2];
-    Range ranges[4];
-    size_t rangesCount;
-
-public:
-    AdjustedGrid(const nvim::grid *grid, const nvim::cursor &cursor) {
-        ranges[0].begin = grid->begin();
-        ranges[0].rowBegin = 0;
-        ranges[0].colBegin = 0;
-
-        // If we're not dealing with a block cursor, no adjusments need to be
-        // made. We can iterate the grid in one swoop.
-        if (cursor.shape() != nvim::cursor_shape::block) {
-            rangesCount = 1;
-            ranges[0].rowEnd = grid->height();
-            ranges[0].colEnd = grid->width();
-            return;
-        }
+/// Adapts a glyph_manager and font_family to frame_builder's glyph source
+/// interface. See frame_builder::build().
+struct GlyphSource {
+    glyph_manager *manager;
+    const font_family *font;
 
-        // We need to adjust the cursor cells.
-        // Grid's are immutable, so we make a copy of the adjusted cells.
-        const nvim::cell *cursorCell = &cursor.cell();
-        size_t cursorWidth = cursor.width();
+    bool find(const nvim::cell &cell, simd_short2 gridpos, glyph_data *data) const {
+        return manager->find(*font, cell, gridpos, data);
+    }
 
-        adjustedCells[0] = cursorCell[0].recolored(cursor.foreground(),
-                                                   cursor.background(),
-                                                   cursor.special());
+    glyph_data get(const nvim::cell &cell, simd_short2 gridpos) {
+        return manager->get(*font, cell, gridpos);
+    }
+};
 
-        if (cursorWidth == 2) {
-            adjustedCells[1] = cursorCell[1].recolored(cursor.foreground(),
-                                                       cursor.background(),
-                                                       cursor.special());
-        }
+/// Builds frame_builder's bands on the user interactive global queue.
+static void buildBands(size_t count, void *context, void (*function)(void*, size_t)) {
+    dispatch_apply_f(count, dispatch_get_global_queue(QOS_CLASS_USER_INTERACTIVE, 0),
+                     context, function);
+}
 
-        // When iterating over the grid, we need to swap out cursor cells with
-        // our adjusted cells. The iteration order required to do that is
-        // stored in an array of four Range objects.
-        rangesCount = 4;
-
-        // Start with full rows up until the cursor row.
-        ranges[0].rowEnd = cursor.row();
-        ranges[0].colEnd = grid->width();
-
-        // Iterate from the start over the cursor row till the cursor column.
-        ranges[1].begin    = cursorCell - cursor.col();
-        ranges[1].rowBegin = cursor.row();
-        ranges[1].rowEnd   = cursor.row() + 1;
-        ranges[1].colBegin = 0;
-        ranges[1].colEnd   = cursor.col();
-
-        // We're at the cursor cells. Iterate over the adjusted cells instead.
-        ranges[2].begin    = adjustedCells;
-        ranges[2].rowBegin = cursor.row();
-        ranges[2].rowEnd   = cursor.row() + 1;
-        ranges[2].colBegin = cursor.col();
-        ranges[2].colEnd   = cursor.col() + cursorWidth;
-
-        // Start from after the cursor cells and finish off the grid.
-        ranges[3].begin    = cursorCell + cursorWidth;
-        ranges[3].rowBegin = cursor.row();
-        ranges[3].rowEnd   = grid->height();
-        ranges[3].colBegin = cursor.col() + cursorWidth;
-        ranges[3].colEnd   = grid->width();
-    }
+/// The instance data of the last fully built frame.
+///
+/// Grid instances are built without the cursor, the cursor is drawn on top of
+/// them as an overlay. When only the cursor changes, for example when it
+/// blinks, the grid instances are reused and only the overlay is rebuilt.
+/// The overlay has its own buffers, see OverlayFrame, so a reused grid buffer
+/// is only ever read, and can be shared with frames the GPU is still drawing.
+struct GridFrame {
+    mtlbuffer::region backgrounds;
+    mtlbuffer::region glyphs;
+    mtlbuffer::region glyphColors;
+    mtlbuffer::region lines;
+    frame_counts counts;
+    size_t bufferIndex;
+    size_t evictionCount;
+    bool valid;
+};
 
-    /// Iterate over the cursor adjusted grid.
-    /// Calls the function object callback once for every cell in ascending
-    /// order. The callback is invoked with three arguments:
-    ///   1. The cell's row (int16_t).
-    ///   2. The cell's column (int16_t).
-    ///   3. A const pointer to the cell (const nvim::cell*).
-    /// The return value of the callback is ignored.
-    template<typename Callable>
-    void forEach(Callable callback) {
-        for (size_t i=0; i<rangesCount; ++i) {
-            const Range &range = ranges[i];
-            const nvim::cell *cell = range.begin;
-            int16_t col = range.colBegin;
-
-            for (int16_t row = range.rowBegin; row < range.rowEnd; ++row) {
-                for (; col < range.colEnd; ++col, ++cell) {
-                    callback(row, col, cell);
-                }
-
-                col = 0;
-            }
-        }
-    }
+/// The uniforms and cursor overlay instances of a frame.
+///
+/// They're written every frame, alternating between two small buffers, so a
+/// frame never has to wait for the GPU to finish drawing the last one.
+struct OverlayFrame {
+    mtlbuffer::region uniforms;
+    mtlbuffer::region backgrounds;
+    mtlbuffer::region glyphs;
+    mtlbuffer::region glyphColors;
+    mtlbuffer::region lines;
 };
 
 @implementation NVGridView {
@@ -225,22 +188,24 @@ public:
     glyph_manager *glyphManager;
     font_family fontFamily;
     mtlbuffer buffers[3];
+    mtlbuffer overlayBuffers[2];
     nvim::cursor cursor;
     const nvim::grid *grid;
+    nvim::latency_tracker *latencyTracker;
 
     NSSize backingCellSize;
     simd_float2 cellSize;
     simd_float2 baselineTranslate;
     uint32_t cursorLineThickness;
-    line_metrics underline;
-    line_metrics undercurl;
-    line_metrics strikethrough;
+    frame_builder frameBuilder;
+    GridFrame gridFrame;
 
     dispatch_source_t blinkTimer;
     bool blinkTimerActive;
     bool inactive;
 
     uint64_t frameIndex;
+    uint64_t overlayIndex;
 }
 
 - (instancetype)init {
@@ -267,6 +232,7 @@ public:
     glyphManager             = context.glyphManager;
 
     metalLayer.device = device;
+    gridFrame.valid = false;
 }
 
 - (NVRenderContext *)renderContext {
@@ -314,6 +280,7 @@ static void blinkCursorToggleOn(void *context);
 
 - (void)setGrid:(const nvim::grid *)newGrid {
     [self setNeedsDisplay:YES];
+    gridFrame.valid = false;
 
     grid = newGrid;
     cursor = newGrid->cursor();
@@ -347,6 +314,14 @@ static void blinkCursorToggleOn(void *context);
     return grid;
 }
 
+- (void)setLatencyTracker:(nvim::latency_tracker *)tracker {
+    latencyTracker = tracker;
+}
+
+- (nvim::latency_tracker *)latencyTracker {
+    return latencyTracker;
+}
+
 - (void)setInactive {
     if (inactive) {
         return;
@@ -427,18 +402,23 @@ static void blinkCursorToggleOn(void *context) {
         underlineTranslate = floor(underlinePos - 0.5);
     }
 
+    line_metrics strikethrough;
     strikethrough.period = 0;
     strikethrough.thickness = lineThickness;
     strikethrough.ytranslate = ascent / 3;
 
+    line_metrics underline;
     underline.period = 0;
     underline.thickness = lineThickness;
     underline.ytranslate = underlineTranslate;
 
+    line_metrics undercurl;
     undercurl.period = 2 * font.scale_factor();
     undercurl.thickness = 2 * font.scale_factor();
     undercurl.ytranslate = underlineTranslate;
 
+    frameBuilder = frame_builder(underline, undercurl, strikethrough);
+    gridFrame.valid = false;
     cursorLineThickness = 1 * font.scale_factor();
     [metalLayer setContentsScale:font.scale_factor()];
 }
@@ -447,47 +427,184 @@ static void blinkCursorToggleOn(void *context) {
     return fontFamily;
 }
 
-- (void)displayLayer:(CALayer*)layer {
-    const CGSize drawableSize = [metalLayer drawableSize];
-    const uint64_t index = frameIndex % 3;
-    mtlbuffer &buffer = buffers[index];
+/// Draws count instances from region, if there are any.
+static void drawInstances(id<MTLRenderCommandEncoder> commandEncoder,
+                          id<MTLRenderPipelineState> pipeline,
+                          mtlbuffer::region region,
+                          size_t count) {
+    if (count) {
+        [commandEncoder setRenderPipelineState:pipeline];
+        [commandEncoder setVertexBufferOffset:region.offset atIndex:1];
+        [commandEncoder drawPrimitives:MTLPrimitiveTypeTriangleStrip
+                           vertexStart:0
+                           vertexCount:4
+                         instanceCount:count];
+    }
+}
 
-    // If we fail to acquire the buffer, drop this frame and try again on the
-    // next draw loop iteration. This should be rare.
-    if (!buffer.try_lock()) {
-        [self setNeedsDisplay:YES];
-        return;
+/// Draws count glyphs from glyphs, with their colors from colors.
+static void drawGlyphs(id<MTLRenderCommandEncoder> commandEncoder,
+                       id<MTLRenderPipelineState> pipeline,
+                       mtlbuffer::region glyphs,
+                       mtlbuffer::region colors,
+                       size_t count) {
+    if (count) {
+        [commandEncoder setVertexBufferOffset:colors.offset atIndex:2];
+        drawInstances(commandEncoder, pipeline, glyphs, count);
     }
+}
 
-    // Allocate enough memory for the worst case scenario, where every cell has
-    // a glyph, a strikethrough, and an underline / undercurl. It takes two
-    // line_data objects to handle a cell with both a strikethrough and an
-    // underline / undercurl.
+/// Builds the grid instances into buffers[index] and updates gridFrame.
+- (void)buildGridFrame:(size_t)index {
+    nvim::trace_span span("frame_build");
+    mtlbuffer &buffer = buffers[index];
+
+    // Count the instances first, so each region is sized exactly. Background
+    // spans are usually a small fraction of the cells, sizing for the worst
+    // case, a span per cell, would mostly allocate memory that's never
+    // written. Large grids count their bands in parallel, and the build
+    // reuses those bands, see frame_builder for details.
     //
-    // We're using a lot of memory to handle our line data, but most grids have
-    // very few lines. Maybe this could be reworked.
-    const size_t gridSize = grid->cells_size();
+    // Glyph colors are only needed to tint color classed glyphs. Without
+    // color classes, their regions are empty. See glyph_colors.
+    const adjusted_grid frameGrid(*grid);
+    const frame_counts frameCounts = frameBuilder.count(frameGrid, buildBands);
+    const size_t glyphColorSize = glyphManager->color_classes() ? sizeof(glyph_colors) : 0;
+    const size_t backgroundBufferSize = sizeof(background_data) * frameCounts.backgrounds;
+    const size_t glyphBufferSize      = sizeof(glyph_data) * frameCounts.glyphs;
+    const size_t glyphColorBufferSize = glyphColorSize * frameCounts.glyphs;
+    const size_t lineBufferSize       = sizeof(line_data) * frameCounts.lines;
+
+    // Pad to account for over allocations caused by alignment.
+    const size_t bufferSize = (256 * 4) + backgroundBufferSize
+                                        + glyphBufferSize
+                                        + glyphColorBufferSize
+                                        + lineBufferSize;
+
+    buffer.create(device, bufferSize);
+    gridFrame.backgrounds = buffer.allocate(backgroundBufferSize);
+    gridFrame.glyphs      = buffer.allocate(glyphBufferSize);
+    gridFrame.glyphColors = buffer.allocate(glyphColorBufferSize);
+    gridFrame.lines       = buffer.allocate(lineBufferSize);
+
+    auto backgrounds = static_cast<background_data*>(gridFrame.backgrounds.ptr);
+    auto glyphs      = static_cast<glyph_data*>(gridFrame.glyphs.ptr);
+    auto colors      = glyphColorSize ? static_cast<glyph_colors*>(gridFrame.glyphColors.ptr) : nullptr;
+    auto lines       = static_cast<line_data*>(gridFrame.lines.ptr);
+
+    GlyphSource glyphSource{glyphManager, &fontFamily};
+
+    gridFrame.counts = frameBuilder.build(frameGrid, backgrounds, glyphs, colors,
+                                          lines, glyphSource, buildBands);
+
+    const frame_counts &counts = gridFrame.counts;
+    buffer.update(gridFrame.backgrounds.offset,
+                  gridFrame.glyphs.offset + (sizeof(glyph_data) * counts.glyphs) -
+                  gridFrame.backgrounds.offset);
+
+    if (colors && counts.glyphs) {
+        buffer.update(gridFrame.glyphColors.offset, glyphColorSize * counts.glyphs);
+    }
+
+    if (counts.lines) {
+        buffer.update(gridFrame.lines.offset, sizeof(line_data) * counts.lines);
+    }
+
+    gridFrame.bufferIndex = index;
+    gridFrame.evictionCount = glyphManager->eviction_count();
+    gridFrame.valid = true;
+}
+
+/// Allocates the uniforms and cursor overlay from overlayBuffers[index].
+- (OverlayFrame)allocateOverlay:(size_t)index {
+    mtlbuffer &buffer = overlayBuffers[index];
+
+    const size_t glyphColorSize = glyphManager->color_classes() ? sizeof(glyph_colors) : 0;
     const size_t uniformBufferSize    = sizeof(uniform_data);
-    const size_t backgroundBufferSize = gridSize * sizeof(uint32_t);
-    const size_t glyphBufferSize      = gridSize * sizeof(glyph_data);
-    const size_t lineBufferSize       = gridSize * sizeof(line_data) * 2;
+    const size_t backgroundBufferSize = sizeof(background_data) * frame_builder::max_cursor_counts.backgrounds;
+    const size_t glyphBufferSize      = sizeof(glyph_data) * frame_builder::max_cursor_counts.glyphs;
+    const size_t glyphColorBufferSize = glyphColorSize * frame_builder::max_cursor_counts.glyphs;
+    const size_t lineBufferSize       = sizeof(line_data) * frame_builder::max_cursor_counts.lines;
 
     // Pad to account for over allocations caused by alignment.
-    const size_t bufferSize = (256 * 4) + uniformBufferSize
+    const size_t bufferSize = (256 * 5) + uniformBufferSize
                                         + backgroundBufferSize
                                         + glyphBufferSize
+                                        + glyphColorBufferSize
                                         + lineBufferSize;
 
     buffer.create(device, bufferSize);
-    auto uniformBuffer    = buffer.allocate(uniformBufferSize);
-    auto backgroundBuffer = buffer.allocate(backgroundBufferSize);
-    auto glyphBuffer      = buffer.allocate(glyphBufferSize);
-    auto lineBuffer       = buffer.allocate(lineBufferSize);
 
-    auto uniforms    = static_cast<uniform_data*>(uniformBuffer.ptr);
-    auto backgrounds = static_cast<uint32_t*>(backgroundBuffer.ptr);
-    auto glyphs      = static_cast<glyph_data*>(glyphBuffer.ptr);
-    auto lines       = static_cast<line_data*>(lineBuffer.ptr);
+    OverlayFrame overlay;
+    overlay.uniforms    = buffer.allocate(uniformBufferSize);
+    overlay.backgrounds = buffer.allocate(backgroundBufferSize);
+    overlay.glyphs      = buffer.allocate(glyphBufferSize);
+    overlay.glyphColors = buffer.allocate(glyphColorBufferSize);
+    overlay.lines       = buffer.allocate(lineBufferSize);
+    return overlay;
+}
+
+/// Returns the pixel bounds of the cursor's cells, clipped to the drawable.
+/// Edges are rounded like the rasterizer rounds instance quads.
+static MTLScissorRect cursorScissorRect(const nvim::cursor &cursor,
+                                        simd_float2 cellSize,
+                                        CGSize drawableSize) {
+    auto clip = [](double position, double limit) -> NSUInteger {
+        return std::clamp<double>(std::lround(position), 0, limit);
+    };
+
+    NSUInteger left   = clip(cursor.col() * cellSize.x, drawableSize.width);
+    NSUInteger top    = clip(cursor.row() * cellSize.y, drawableSize.height);
+    NSUInteger right  = clip((cursor.col() + cursor.width()) * cellSize.x, drawableSize.width);
+    NSUInteger bottom = clip((cursor.row() + 1) * cellSize.y, drawableSize.height);
+
+    return MTLScissorRect{left, top, right - left, bottom - top};
+}
+
+- (void)displayLayer:(CALayer*)layer {
+    // If the grid hasn't changed since the last frame, and no glyphs have been
+    // evicted since, we can reuse its grid instances. We'll only need to
+    // redraw the cursor overlay. This keeps blinking cursors cheap.
+    const bool reuse = gridFrame.valid &&
+                       gridFrame.evictionCount == glyphManager->eviction_count();
+
+    const size_t index = reuse ? gridFrame.bufferIndex : frameIndex % 3;
+    const size_t overlay = overlayIndex % 2;
+    mtlbuffer &buffer = buffers[index];
+    mtlbuffer &overlayBuffer = overlayBuffers[overlay];
+
+    // A reused grid buffer is only read, so it's shared with any frames the
+    // GPU is still drawing. The buffers we write to have to be free. If we
+    // fail to acquire them, drop this frame and try again on the next draw
+    // loop iteration. This should be rare.
+    if (!overlayBuffer.try_lock()) {
+        [self setNeedsDisplay:YES];
+        return;
+    }
+
+    if (reuse) {
+        buffer.share();
+    } else if (!buffer.try_lock()) {
+        overlayBuffer.unlock();
+        [self setNeedsDisplay:YES];
+        return;
+    }
+
+    if (!reuse) {
+        [self buildGridFrame:index];
+        frameIndex += 1;
+    }
+
+    overlayIndex += 1;
+
+    const OverlayFrame overlayFrame = [self allocateOverlay:overlay];
+    const CGSize drawableSize = [metalLayer drawableSize];
+    auto uniforms          = static_cast<uniform_data*>(overlayFrame.uniforms.ptr);
+    auto cursorBackgrounds = static_cast<background_data*>(overlayFrame.backgrounds.ptr);
+    auto cursorGlyphs      = static_cast<glyph_data*>(overlayFrame.glyphs.ptr);
+    auto cursorGlyphColors = glyphManager->color_classes() ?
+                             static_cast<glyph_colors*>(overlayFrame.glyphColors.ptr) : nullptr;
+    auto cursorLines       = static_cast<line_data*>(overlayFrame.lines.ptr);
 
     const simd_float2 pixelSize = simd_make_float2(2.0, -2.0) /
                                   simd_make_float2(drawableSize.width, drawableSize.height);
@@ -496,54 +613,20 @@ static void blinkCursorToggleOn(void *context) {
     uniforms->cell_pixel_size   = cellSize;
     uniforms->cell_size         = cellSize * pixelSize;
     uniforms->baseline          = baselineTranslate;
-    uniforms->grid_width        = static_cast<uint32_t>(grid->width());
     uniforms->cursor_position   = simd_make_short2(cursor.col(), cursor.row());
     uniforms->cursor_color      = cursor.background();
     uniforms->cursor_line_width = cursorLineThickness;
     uniforms->cursor_cell_width = cursor.width();
 
-    glyph_data *glyphsBegin = glyphs;
-    line_data *linesBegin = lines;
-    simd_short2 undercurlNext = simd_make_short2(-1, -1);
-    uint16_t undercurlPosition = 0;
-
-    AdjustedGrid(grid, cursor).forEach([&](int16_t row, int16_t col, const nvim::cell *cell) {
-        simd_short2 gridpos = simd_make_short2(col, row);
-        *backgrounds++ = cell->background();
-
-        if (cell->has_line_emphasis()) {
-            nvim::rgb_color color = cell->special();
-
-            // Undercurls and underlines are mutually exclusive. We'll make
-            // undercurls take priority, they usually represent errors,
-            // so users won't appreciate them being hidden.
-            if (cell->has_undercurl()) {
-                if (simd_equal(undercurlNext, gridpos)) {
-                    undercurlPosition += 1;
-                } else {
-                    undercurlPosition = 0;
-                }
-
-                undercurlNext = simd_make_short2(col + 1, row);
-                *lines++ = line_data(gridpos, color, undercurl, undercurlPosition);
-            } else if (cell->has_underline()) {
-                *lines++ = line_data(gridpos, color, underline);
-            }
-
-            if (cell->has_strikethrough()) {
-                *lines++ = line_data(gridpos, color, strikethrough);
-            }
-        }
-
-        if (!cell->empty()) {
-            glyph_rect glyph = glyphManager->get(fontFamily, *cell);
-            *glyphs++ = glyph_data(gridpos, cell->width(), glyph);
-        }
+    frame_counts cursorCounts = frameBuilder.build_cursor(cursor, grid->width(), cursorBackgrounds,
+                                                          cursorGlyphs, cursorGlyphColors,
+                                                          cursorLines,
+                                                          [&](const nvim::cell &cell, simd_short2 gridpos) {
+        return glyphManager->get(fontFamily, cell, gridpos);
     });
 
-    size_t glyphsCount = glyphs - glyphsBegin;
-    size_t linesCount = lines - linesBegin;
-    buffer.update(0, glyphBuffer.offset + (sizeof(glyph_data) * glyphsCount));
+    overlayBuffer.update(0, overlayFrame.lines.offset + (sizeof(line_data) * cursorCounts.lines));
+    const frame_counts &counts = gridFrame.counts;
 
     id<CAMetalDrawable> drawable = [metalLayer nextDrawable];
     MTLRenderPassDescriptor *desc = [MTLRenderPassDescriptor renderPassDescriptor];
@@ -555,33 +638,34 @@ static void blinkCursorToggleOn(void *context) {
     id<MTLCommandBuffer> commandBuffer = [commandQueue commandBuffer];
     id<MTLRenderCommandEncoder> commandEncoder = [commandBuffer renderCommandEncoderWithDescriptor:desc];
 
-    [commandEncoder setRenderPipelineState:backgroundRenderPipeline];
-    [commandEncoder setVertexBuffer:buffer.get() offset:uniformBuffer.offset atIndex:0];
-    [commandEncoder setVertexBuffer:buffer.get() offset:backgroundBuffer.offset atIndex:1];
-    [commandEncoder drawPrimitives:MTLPrimitiveTypeTriangleStrip
-                       vertexStart:0
-                       vertexCount:4
-                     instanceCount:gridSize];
-
-    if (glyphsCount) {
-        [commandEncoder setRenderPipelineState:glyphRenderPipeline];
-        [commandEncoder setVertexBufferOffset:glyphBuffer.offset atIndex:1];
-        [commandEncoder setFragmentTexture:glyphManager->texture() atIndex:0];
-        [commandEncoder drawPrimitives:MTLPrimitiveTypeTriangleStrip
-                           vertexStart:0
-                           vertexCount:4
-                         instanceCount:glyphsCount];
-    }
-
-    if (linesCount) {
-        buffer.update(lineBuffer.offset, sizeof(line_data) * linesCount);
-
-        [commandEncoder setRenderPipelineState:lineRenderPipeline];
-        [commandEncoder setVertexBufferOffset:lineBuffer.offset atIndex:1];
-        [commandEncoder drawPrimitives:MTLPrimitiveTypeTriangleStrip
-                           vertexStart:0
-                           vertexCount:4
-                         instanceCount:linesCount];
+    [commandEncoder setVertexBuffer:overlayBuffer.get() offset:overlayFrame.uniforms.offset atIndex:0];
+    [commandEncoder setVertexBuffer:buffer.get() offset:gridFrame.backgrounds.offset atIndex:1];
+    [commandEncoder setVertexBuffer:buffer.get() offset:gridFrame.glyphColors.offset atIndex:2];
+    [commandEncoder setFragmentTexture:glyphManager->texture() atIndex:0];
+
+    // Draw the grid, then draw the cursor overlay on top of it.
+    drawInstances(commandEncoder, backgroundRenderPipeline, gridFrame.backgrounds, counts.backgrounds);
+    drawGlyphs(commandEncoder, glyphRenderPipeline, gridFrame.glyphs, gridFrame.glyphColors, counts.glyphs);
+    drawInstances(commandEncoder, lineRenderPipeline, gridFrame.lines, counts.lines);
+
+    // The overlay redraws the cursor's cells, and nothing else. Clip it to
+    // them, so its background doesn't cover anything the grid drew in the
+    // neighbouring cells, and its lines don't extend into the row below.
+    // Neighbouring instances that reach into the cursor's cells are part of
+    // the overlay, see frame_builder::build_cursor().
+    MTLScissorRect cursorRect = cursorScissorRect(cursor, cellSize, drawableSize);
+
+    if (cursorCounts.backgrounds && cursorRect.width && cursorRect.height) {
+        [commandEncoder setScissorRect:cursorRect];
+        [commandEncoder setVertexBuffer:overlayBuffer.get() offset:overlayFrame.backgrounds.offset atIndex:1];
+        [commandEncoder setVertexBuffer:overlayBuffer.get() offset:overlayFrame.glyphColors.offset atIndex:2];
+
+        drawInstances(commandEncoder, backgroundRenderPipeline, overlayFrame.backgrounds, cursorCounts.backgrounds);
+        drawGlyphs(commandEncoder, glyphRenderPipeline, overlayFrame.glyphs, overlayFrame.glyphColors, cursorCounts.glyphs);
+        drawInstances(commandEncoder, lineRenderPipeline, overlayFrame.lines, cursorCounts.lines);
+
+        [commandEncoder setScissorRect:MTLScissorRect{0, 0, (NSUInteger)drawableSize.width,
+                                                            (NSUInteger)drawableSize.height}];
     }
 
     switch (cursor.shape()) {
@@ -613,19 +697,25 @@ static void blinkCursorToggleOn(void *context) {
             break;
 
         case nvim::cursor_shape::block:
-            break; // Block cursors are handled with AdjustedGrids.
+            break; // Block cursors are handled by the cursor overlay.
     }
 
     [commandEncoder endEncoding];
     [commandBuffer addCompletedHandler:^(id<MTLCommandBuffer> commandBuffer) {
         self->buffers[index].unlock();
+        self->overlayBuffers[overlay].unlock();
     }];
 
+    const uint64_t presentStart = nvim::trace_clock();
     [commandBuffer commit];
     [commandBuffer waitUntilScheduled];
     [drawable present];
+    nvim::trace_record("present", presentStart, nvim::trace_clock());
+
+    if (latencyTracker) {
+        latencyTracker->present(grid->tick());
+    }
 
-    frameIndex += 1;
     glyphManager->evict();
 }
 
@@ -17,6 +17,10 @@ NS_ASSUME_NONNULL_BEGIN
 + (BOOL)titlebarAppearsTransparent;
 + (BOOL)externalizeTabline;
 
+/// Share rasterized glyphs between cells with similar colors.
+/// Not exposed in the preferences window, set with defaults write.
++ (BOOL)glyphColorClasses;
+
 @end
 
 /// Window controller for the preferences window.
@@ -11,6 +11,7 @@
 
 static NSString * const kTitlebarAppearsTransparent = @"NVPreferencesTitlebarAppearsTransparent";
 static NSString * const kExternalizeTabline = @"NVPreferencesExternalizeTabline";
+static NSString * const kGlyphColorClasses = @"NVPreferencesGlyphColorClasses";
 
 static BOOL getBooleanPreference(NSString *key, BOOL defaultValue) {
     NSUserDefaults *defaults = [NSUserDefaults standardUserDefaults];
@@ -38,6 +39,10 @@ static void setBooleanPreference(NSString *key, BOOL value) {
     return getBooleanPreference(kExternalizeTabline, YES);
 }
 
++ (BOOL)glyphColorClasses {
+    return getBooleanPreference(kGlyphColorClasses, NO);
+}
+
 @end
 
 @interface NVPreferencesController()
@@ -84,6 +84,10 @@ struct NVRenderContextOptions {
     /// The number of cache pages to preserve when a texture cache is evicted.
     /// This number should be less than cacheEvictionThreshold.
     size_t cacheEvictionPreserve;
+
+    /// If true, glyphs are shared between cells with similar colors and tinted
+    /// when rendered. See color_class.hpp.
+    bool glyphColorClasses;
 };
 
 /// @protocol NVMetalDeviceDelegate
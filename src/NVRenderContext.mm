@@ -87,7 +87,8 @@ static inline MTLRenderPipelineDescriptor* blendedPipelineDescriptor() {
     glyphManager = glyph_manager(rasterizer,
                                  std::move(textureCache),
                                  options->cacheEvictionThreshold,
-                                 options->cacheEvictionPreserve);
+                                 options->cacheEvictionPreserve,
+                                 options->glyphColorClasses);
 
     return self;
 }
@@ -406,6 +406,7 @@ static std::pair<arc_ptr<CTFontDescriptorRef>, CGFloat> getFontDescriptor(nvim::
     gridView = [[NVGridView alloc] init];
     gridView.font = fontManager->get(fontDescriptor.get(), fontSize, scaleFactor);
     gridView.grid = grid;
+    gridView.latencyTracker = &nvim.get_latency_tracker();
 
     lastGridSize = grid->size();
     NSSize cellSize = gridView.cellSize;
@@ -496,7 +497,32 @@ static std::pair<arc_ptr<CTFontDescriptorRef>, CGFloat> getFontDescriptor(nvim::
     [self initialRedraw];
 }
 
+#if NVIM_MAC_CAPTURE
+/// Starts an RPC capture if the NVIM_MAC_CAPTURE_DIR environment variable is
+/// set. Each connection is captured to its own file in that directory.
+/// Only Debug builds define NVIM_MAC_CAPTURE, release builds never capture.
+static void startCaptureIfRequested(nvim::process &nvim) {
+    static uint32_t captureCount = 0;
+    const char *directory = getenv("NVIM_MAC_CAPTURE_DIR");
+
+    if (!directory) {
+        return;
+    }
+
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/capture-%d-%u.nvrpc",
+             directory, getpid(), captureCount++);
+
+    if (int error = nvim.start_capture(path)) {
+        os_log_error(rpc, "Capture error: %s: %i: %s\n", path, error, strerror(error));
+    }
+}
+#else
+static void startCaptureIfRequested(nvim::process &nvim) {}
+#endif
+
 - (int)connect:(NSString *)addr {
+    startCaptureIfRequested(nvim);
     int error = nvim.connect([addr UTF8String]);
 
     if (error) {
@@ -515,6 +541,7 @@ static std::pair<arc_ptr<CTFontDescriptorRef>, CGFloat> getFontDescriptor(nvim::
     const char *workingDir = [directory UTF8String];
     const char *path = [nvimExecutable UTF8String];
 
+    startCaptureIfRequested(nvim);
     int error = nvim.spawn(path, argv, (const char**)environ, workingDir);
 
     if (error) {
@@ -915,13 +942,6 @@ static void handleMouseDragEvents(void *context) {
     [self mouseUp:event button:MouseButtonOther];
 }
 
-static void scrollEvent(nvim::process &nvim, size_t count, std::string_view direction,
-                        std::string_view modifiers, nvim::grid_point location) {
-    for (size_t i=0; i<count; ++i) {
-        nvim.input_mouse("wheel", direction, modifiers, location.row, location.column);
-    }
-}
-
 - (void)scrollWheel:(NSEvent *)event {
     NSEventModifierFlags modifierFlags = [event modifierFlags];
     CGFloat deltaX = [event scrollingDeltaX];
@@ -968,33 +988,37 @@ static void scrollEvent(nvim::process &nvim, size_t count, std::string_view dire
         }
     }
 
+    if (!deltaX && !deltaY) {
+        return;
+    }
+
     input_modifiers modifiers = input_modifiers(modifierFlags);
 
+    // A fast trackpad flick scrolls many lines per event. They're sent as
+    // nvim_input_mouse requests, fast calls on the interactive lane, so a
+    // scroll isn't queued behind a paste or other bulk requests.
     if (deltaY > 0) {
-        scrollEvent(nvim, deltaY, "up", modifiers, location);
+        nvim.input_mouse("wheel", "up", modifiers, location.row, location.column, deltaY);
     } else if (deltaY < 0) {
-        scrollEvent(nvim, -deltaY, "down", modifiers, location);
+        nvim.input_mouse("wheel", "down", modifiers, location.row, location.column, -deltaY);
     }
 
     if (deltaX > 0) {
-        scrollEvent(nvim, deltaX, "left", modifiers, location);
+        nvim.input_mouse("wheel", "left", modifiers, location.row, location.column, deltaX);
     } else if (deltaX < 0) {
-        scrollEvent(nvim, -deltaX, "right", modifiers, location);
+        nvim.input_mouse("wheel", "right", modifiers, location.row, location.column, -deltaX);
     }
 }
 
-static bool is_error(const msg::object &error, std::string_view error_string) {
-    if (error.is<msg::array>()) {
-        msg::array array = error.get<msg::array>();
+/// Writes the current buffer, asking where to save it if it doesn't have a name.
+static nvim::task writeOrSaveAs(NVWindowController *controller, nvim::process &nvim) {
+    auto written = co_await nvim.request<void>(dispatch_get_main_queue(),
+                                               DISPATCH_TIME_FOREVER,
+                                               "nvim_command", "write");
 
-        if (array.size() == 2 &&
-            array[1].is<msg::string>() &&
-            array[1].get<msg::string>() == error_string) {
-            return true;
-        }
+    if (written.error == "Vim(write):E32: No file name") {
+        [controller saveDocumentAs:nil];
     }
-
-    return false;
 }
 
 - (IBAction)newDocument:(id)sender {
@@ -1078,14 +1102,7 @@ static inline bool canSave(nvim::process &nvim) {
         return NSBeep();
     }
 
-    nvim.command("write", [self](const msg::object &error,
-                                 const msg::object &result, bool timed_out) {
-        if (is_error(error, "Vim(write):E32: No file name")) {
-            dispatch_async(dispatch_get_main_queue(), ^{
-                [self saveDocumentAs:nil];
-            });
-        }
-    });
+    writeOrSaveAs(self, nvim);
 }
 
 - (IBAction)saveDocumentAs:(id)sender {
@@ -1341,7 +1358,8 @@ static std::string joinURLs(NSArray<NSURL*> *urls, char delim) {
 
     if (is_terminal_mode(mode) || is_command_line_mode(mode)) {
         std::string filenames = joinURLs(urls, ' ');
-        nvim.paste(std::string_view(filenames.data(), filenames.size() - 1));
+        filenames.pop_back();
+        nvim.paste(std::move(filenames));
         return YES;
     }
 
@@ -1651,56 +1669,61 @@ static inline bool shouldShowTabLine(size_t tabsCount, nvim::showtabline showtab
 // We forward the messages and ensure they execute in the main thread.
 namespace nvim {
 
+/// Calls function with controller on the main queue.
+static void async_main(void *controller, dispatch_function_t function) {
+    dispatch_async_f(dispatch_get_main_queue(), controller, function);
+}
+
 void window_controller::close() {
-    dispatch_async_f(dispatch_get_main_queue(), controller, [](void *context) {
+    async_main(controller, [](void *context) {
         [(__bridge NVWindowController*)context close];
     });
 }
 
 void window_controller::shutdown() {
-    dispatch_async_f(dispatch_get_main_queue(), controller, [](void *context) {
+    async_main(controller, [](void *context) {
         [(__bridge NVWindowController*)context shutdown];
     });
 }
 
 void window_controller::redraw() {
-    dispatch_async_f(dispatch_get_main_queue(), controller, [](void *context) {
+    async_main(controller, [](void *context) {
         [(__bridge NVWindowController*)context redraw];
     });
 }
 
 void window_controller::title_set() {
-    dispatch_async_f(dispatch_get_main_queue(), controller, [](void *context) {
+    async_main(controller, [](void *context) {
         [(__bridge NVWindowController*)context titleDidChange];
     });
 }
 
 void window_controller::font_set() {
-    dispatch_async_f(dispatch_get_main_queue(), controller, [](void *context) {
+    async_main(controller, [](void *context) {
         [(__bridge NVWindowController*)context fontDidChange];
     });
 }
 
 void window_controller::options_set() {
-    dispatch_async_f(dispatch_get_main_queue(), controller, [](void *context) {
+    async_main(controller, [](void *context) {
         [(__bridge NVWindowController*)context optionsDidChange];
     });
 }
 
 void window_controller::showtabline_set() {
-    dispatch_async_f(dispatch_get_main_queue(), controller, [](void *context) {
+    async_main(controller, [](void *context) {
         [(__bridge NVWindowController*)context optionShowTabLineDidChange];
     });
 }
 
 void window_controller::tabline_update() {
-    dispatch_async_f(dispatch_get_main_queue(), controller, [](void *context) {
+    async_main(controller, [](void *context) {
         [(__bridge NVWindowController*)context tabLineUpdate];
     });
 }
 
 void window_controller::colorscheme_update() {
-    dispatch_async_f(dispatch_get_main_queue(), controller, [](void *context) {
+    async_main(controller, [](void *context) {
         [(__bridge NVWindowController*)context colorschemeUpdate];
     });
 }
@@ -0,0 +1,540 @@
+//
+//  Neovim Mac
+//  cell.hpp
+//
+//  Copyright © 2020 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef CELL_HPP
+#define CELL_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "msgpack.hpp"
+
+namespace nvim {
+
+class ui_controller;
+
+/// Represents a Neovim RGB color.
+/// RGBA memory layout. Colors are in the sRGB color space.
+class rgb_color {
+private:
+    uint32_t value;
+
+    struct default_tag_type {};
+    static constexpr uint32_t is_default_bit = (1 << 31);
+
+public:
+    static constexpr default_tag_type default_tag{};
+
+    /// Default initialized rgb_color. All components are zero.
+    rgb_color() {
+        value = 0;
+    }
+
+    /// Constructs an rgb_color from Neovim's packed 32bit integer format.
+    explicit rgb_color(uint32_t rgb) {
+        // Memory layout conversion: BGR -> RGB.
+        value = __builtin_bswap32(rgb << 8);
+    }
+
+    /// Constructs an rgb_color with the default tag set.
+    explicit rgb_color(uint32_t rgb, default_tag_type) : rgb_color(rgb) {
+        value |= is_default_bit;
+    };
+
+    /// Constructs an rgb_color from a red, green, and blue color component.
+    explicit rgb_color(uint32_t red, uint32_t green, uint32_t blue) {
+        value = (blue << 16) | (green << 8) | red;
+    }
+
+    /// True if the default flag was set, otherwise false.
+    bool is_default() const {
+        return value & is_default_bit;
+    }
+
+    /// The red color component.
+    uint8_t red() const {
+        return value & 0xFF;
+    }
+
+    /// The green color component.
+    uint8_t green() const {
+        return (value >> 8) & 0xFF;
+    }
+
+    /// The blue color component.
+    uint8_t blue() const {
+        return (value >> 16) & 0xFF;
+    }
+
+    /// RGB value. The 8 highest bits are zero.
+    uint32_t rgb() const {
+        return value & 0xFFFFFF;
+    }
+
+    /// Returns an RGBA value with an alpha value of 255.
+    uint32_t opaque() const {
+        return value | 0xFF000000;
+    }
+
+    /// Raw 32bit value. The 8 highest bits are undefined.
+    operator uint32_t() const {
+        return value;
+    }
+};
+
+struct cell_attributes {
+    enum flag : uint16_t {
+        bold          = 1 << 0,
+        italic        = 1 << 1,
+        emoji         = 1 << 2,
+        underline     = 1 << 3,
+        undercurl     = 1 << 4,
+        strikethrough = 1 << 5,
+        doublewidth   = 1 << 6,
+        reverse       = 1 << 7
+    };
+
+    rgb_color background;
+    rgb_color foreground;
+    rgb_color special;
+    uint16_t flags;
+};
+
+/// Cell attributes that affect font rendering.
+enum class font_attributes {
+    none,
+    bold,
+    italic,
+    bold_italic
+};
+
+/// A sequence of Unicode code points that represent a single grapheme.
+/// Holds up to six (maxcombine in Neovim) UTF-8 encoded code points.
+using grapheme_cluster = std::array<char, 24>;
+
+/// A grid cell.
+/// A cell consists of a grapheme and various attributes that control their
+/// appearance.
+class cell {
+private:
+    grapheme_cluster text;
+    uint16_t size;
+    cell_attributes attrs;
+
+    friend class ui_controller;
+
+public:
+    /// Zero initialized cell.
+    cell(): text{}, size{}, attrs{} {}
+
+    /// Constructs a cell with the given text and attributes.
+    ///
+    /// @param cell_text    UTF-8 encoded text representing a single grapheme.
+    /// @param cell_attrs   The new cell's attributes.
+    ///
+    /// Note: Text is stored in a grapheme_cluster and is trimmed if needed.
+    cell(msg::string cell_text, const cell_attributes *cell_attrs) {
+        text = {};
+        attrs = *cell_attrs;
+
+        if (cell_text.size() == 1 && *cell_text.data() == ' ') {
+            size = 0;
+        } else {
+            size = std::min(cell_text.size(), sizeof(grapheme_cluster));
+
+            for (size_t i=0; i<size; ++i) {
+                text[i] = cell_text[i];
+            }
+        }
+    }
+
+    /// The cell's grapheme as a grapheme_cluster.
+    grapheme_cluster grapheme() const {
+        return text;
+    }
+
+    /// The cell's grapheme as a std::string_view.
+    std::string_view grapheme_view() const {
+        return std::string_view(text.data(), size);
+    }
+
+    /// True if the cell is empty, false otherwise.
+    /// A cell is considered empty if it is entirely white space, or if it does
+    /// not have an associated grapheme.
+    bool empty() const {
+        return size == 0;
+    }
+
+    /// Returns the cell's attributes.
+    const cell_attributes& attributes() const {
+        return attrs;
+    }
+
+    /// Returns the cell's foreground color.
+    rgb_color foreground() const {
+        return attrs.foreground;
+    }
+
+    /// Returns the cell's background color.
+    rgb_color background() const {
+        return attrs.background;
+    }
+
+    /// Returns the cell's special (underline, undercurl, strikethrough) color.
+    rgb_color special() const {
+        return attrs.special;
+    }
+
+    /// Returns the cell's font attributes.
+    nvim::font_attributes font_attributes() const {
+        static constexpr uint16_t mask = cell_attributes::bold |
+                                         cell_attributes::italic;
+
+        return static_cast<enum font_attributes>(attrs.flags & mask);
+    }
+
+    /// True if the cell has an underline, undercurl, or strikethrough.
+    bool has_line_emphasis() const {
+        return attrs.flags & (cell_attributes::underline |
+                              cell_attributes::undercurl |
+                              cell_attributes::strikethrough);
+    }
+
+    /// True if the cell is underlined, false otherwise.
+    bool has_underline() const {
+        return attrs.flags & cell_attributes::underline;
+    }
+
+    /// True if the cell has an undercurl, false otherwise.
+    bool has_undercurl() const {
+        return attrs.flags & cell_attributes::undercurl;
+    }
+
+    /// True if the cell has been stroke through, false otherwise.
+    bool has_strikethrough() const {
+        return attrs.flags & cell_attributes::strikethrough;
+    }
+
+    /// The number of lines drawn for the cell, between 0 and 2. Underlines and
+    /// undercurls are mutually exclusive, strikethroughs add a second line.
+    uint32_t line_emphasis_count() const {
+        return (bool)(attrs.flags & (cell_attributes::underline |
+                                     cell_attributes::undercurl)) +
+               (bool)(attrs.flags & cell_attributes::strikethrough);
+    }
+
+    /// Returns 1 for single width characters, 2 for full width characters.
+    uint32_t width() const {
+        return (bool)(attrs.flags & cell_attributes::doublewidth) + 1;
+    }
+
+    /// Returns a newly constructed cell with the given color attributes.
+    cell recolored(rgb_color foreground,
+                   rgb_color background,
+                   rgb_color special) const {
+        nvim::cell ret = *this;
+        ret.attrs.foreground = foreground;
+        ret.attrs.background = background;
+        ret.attrs.special = special;
+        return ret;
+    }
+};
+
+enum class cursor_shape : uint8_t {
+    block,
+    horizontal,
+    vertical,
+    block_outline
+};
+
+struct cursor_attributes {
+    rgb_color foreground;
+    rgb_color background;
+    rgb_color special;
+    cursor_shape shape;
+    bool blinks;
+    uint16_t shortname;
+    uint16_t percentage;
+    uint16_t blinkwait;
+    uint16_t blinkon;
+    uint16_t blinkoff;
+};
+
+struct grid_size {
+    int32_t width;
+    int32_t height;
+};
+
+inline bool operator==(const grid_size &left, const grid_size &right) {
+    return memcmp(&left, &right, sizeof(grid_size)) == 0;
+}
+
+inline bool operator!=(const grid_size &left, const grid_size &right) {
+    return memcmp(&left, &right, sizeof(grid_size)) != 0;
+}
+
+struct grid_point {
+    int32_t row;
+    int32_t column;
+};
+
+inline bool operator==(const grid_point &left, const grid_point &right) {
+    return memcmp(&left, &right, sizeof(grid_point)) == 0;
+}
+
+inline bool operator!=(const grid_point &left, const grid_point &right) {
+    return memcmp(&left, &right, sizeof(grid_point)) != 0;
+}
+
+/// A grid's cursor.
+///
+/// Every grid has an associated cursor. A cursor consists of a grid position,
+/// an underlying cell, and various cursor attributes. Attributes control the
+/// appearance and behavior of the cursor.
+class cursor {
+private:
+    cursor_attributes attrs_;
+    size_t row_;
+    size_t col_;
+    const nvim::cell *ptr_;
+
+public:
+    /// A default constructed cursor should only be assigned to or destroyed.
+    /// This constructor is only provided because Objective-C++ requires C++
+    /// instance variables to be default constructible.
+    cursor(): attrs_(), row_(0), col_(0), ptr_(nullptr) {}
+
+    /// Construct a new cursor object.
+    /// @param row      The row position of the cursor.
+    /// @param col      The column position of the cursor.
+    /// @param ptr      A pointer to the cursor's underlying cell.
+    /// @param attrs    The cursor's attributes.
+    cursor(size_t row, size_t col, const nvim::cell *ptr, cursor_attributes attrs):
+        attrs_(attrs), row_(row), col_(col), ptr_(ptr) {
+        if (attrs_.special.is_default()) {
+            attrs_.special = ptr->special();
+        }
+
+        if (attrs_.background.is_default()) {
+            if (attrs_.foreground.is_default()) {
+                attrs_.background = ptr->foreground();
+                attrs_.foreground = ptr->background();
+                return;
+            }
+
+            attrs_.background = ptr->background();
+        }
+
+        if (attrs_.foreground.is_default()) {
+            attrs_.foreground = ptr->foreground();
+        }
+    }
+
+    /// A reference to the underlying cell.
+    const nvim::cell& cell() const {
+        return *ptr_;
+    }
+
+    /// The width of the underlying cell.
+    uint32_t width() const {
+        return ptr_->width();
+    }
+
+    /// Get the cursor shape.
+    cursor_shape shape() const {
+        return attrs_.shape;
+    }
+
+    /// Set the cursor shape.
+    void shape(cursor_shape new_shape) {
+        attrs_.shape = new_shape;
+    }
+
+    /// The cursor's row in its parent grid.
+    size_t row() const {
+        return row_;
+    }
+
+    /// The cursor's column in its parent grid.
+    size_t col() const {
+        return col_;
+    }
+
+    /// The cursor's background color.
+    rgb_color background() const {
+        return attrs_.background;
+    }
+
+    /// The cursor's foreground color.
+    rgb_color foreground() const {
+        return attrs_.foreground;
+    }
+
+    /// The cursor's underline, undercurl, and strikethrough color.
+    rgb_color special() const {
+        return attrs_.special;
+    }
+
+    /// True if the cursor should blink, false otherwise.
+    bool blinks() const {
+        return attrs_.blinks;
+    }
+
+    /// The delay in ms before the cursor starts blinking.
+    uint16_t blinkwait() const {
+        return attrs_.blinkwait;
+    }
+
+    /// The time in ms that the cursor is not shown.
+    uint16_t blinkoff() const {
+        return attrs_.blinkoff;
+    }
+
+    /// The time in ms that the cursor is shown.
+    uint16_t blinkon() const {
+        return attrs_.blinkon;
+    }
+
+    /// Make the cursor invisible.
+    /// When the cursor is invisible, shape() returns a value outside the range
+    /// of the cursor_shape enum.
+    void toggle_off() {
+        attrs_.shape = static_cast<cursor_shape>((uint8_t)attrs_.shape | 128);
+    }
+
+    /// Make the cursor visible.
+    void toggle_on() {
+        attrs_.shape = static_cast<cursor_shape>((uint8_t)attrs_.shape & 127);
+    }
+
+    /// Toggles the cursor's visbility.
+    void toggle() {
+        attrs_.shape = static_cast<cursor_shape>((uint8_t)attrs_.shape ^ 128);
+    }
+};
+
+/// A grid of cells.
+///
+/// Grid's are conceptually a 2d array of cells. They are created and updated
+/// by a ui_controller in response to redraw events.
+class grid {
+private:
+    std::vector<cell> cells;
+    std::vector<uint32_t> row_emphasis;
+    size_t emphasis_total;
+    size_t grid_width;
+    size_t grid_height;
+    cursor_attributes cursor_attrs;
+    size_t cursor_row;
+    size_t cursor_col;
+    uint64_t draw_tick;
+
+    friend class ui_controller;
+
+    /// Adjusts the line emphasis count of the given row by delta.
+    void add_row_emphasis(size_t row, long delta) {
+        row_emphasis[row] += delta;
+        emphasis_total += delta;
+    }
+
+    /// Recounts the line emphasis count of the given row.
+    void count_row_emphasis(size_t row) {
+        const cell *begin = get(row, 0);
+        const cell *end = begin + grid_width;
+        uint32_t count = 0;
+
+        for (const cell *cell = begin; cell != end; ++cell) {
+            count += cell->line_emphasis_count();
+        }
+
+        emphasis_total -= row_emphasis[row];
+        emphasis_total += count;
+        row_emphasis[row] = count;
+    }
+
+public:
+    grid():
+        emphasis_total(0),
+        grid_width(0),
+        grid_height(0),
+        cursor_row(0),
+        cursor_col(0),
+        draw_tick(0) {}
+
+    const cell* begin() const {
+        return cells.data();
+    }
+
+    const cell* end() const {
+        return cells.data() + cells.size();
+    }
+
+    /// A pointer to the cell at the given row and column.
+    cell* get(size_t row, size_t col) {
+        return cells.data() + (row * grid_width) + col;
+    }
+
+    /// A const pointer to the cell at the given row and column position.
+    const cell* get(size_t row, size_t col) const {
+        return cells.data() + (row * grid_width) + col;
+    }
+
+    /// Returns the grid's cursor.
+    nvim::cursor cursor() const {
+        return nvim::cursor(cursor_row,
+                            cursor_col,
+                            get(cursor_row, cursor_col),
+                            cursor_attrs);
+    }
+
+    /// Returns the grid's draw tick, the number of flushes it reflects.
+    /// Newer grids have larger ticks.
+    uint64_t tick() const {
+        return draw_tick;
+    }
+
+    /// Returns the grid's width.
+    size_t width() const {
+        return grid_width;
+    }
+
+    /// Returns the grid's height.
+    size_t height() const {
+        return grid_height;
+    }
+
+    /// Returns The grid's size.
+    nvim::grid_size size() const {
+        return nvim::grid_size{(int32_t)grid_width, (int32_t)grid_height};
+    }
+
+    /// The total number of cells in grid, equal to width() * height().
+    size_t cells_size() const {
+        return cells.size();
+    }
+
+    /// The total number of lines (underlines, undercurls, strikethroughs)
+    /// drawn for the grid. See cell::line_emphasis_count().
+    size_t line_emphasis_count() const {
+        return emphasis_total;
+    }
+
+    /// The number of lines drawn for the given row.
+    size_t line_emphasis_count(size_t row) const {
+        return row_emphasis[row];
+    }
+};
+
+} // namespace nvim
+
+#endif // CELL_HPP
@@ -9,10 +9,14 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include "circular_buffer.hpp"
+
+// The Mach VM backend. See circular_buffer_memfd.cpp for the Linux backend.
+#if defined(__APPLE__)
+
 #include <mach/mach.h>
 #include <mach/mach_vm.h>
 #include <sanitizer/asan_interface.h>
-#include "circular_buffer.hpp"
 
 // Allocates a mirrored buffer, that is a virtual memory region size * 2 bytes
 // long. The second half of which is remapped to the first. Size must be a
@@ -70,12 +74,14 @@ void circular_buffer::deallocate_mirrored(void *ptr, size_t size) {
     }
 }
 
+#endif // __APPLE__
+
 void circular_buffer::resize(size_t size) {
-    assert(size >= vm_page_size && (size & (size - 1)) == 0);
+    assert(size >= page_size() && (size & (size - 1)) == 0);
 
     char *new_buffer = static_cast<char*>(allocate_mirrored(size));
     memcpy(new_buffer, data(), length);
-    deallocate_mirrored(buffer, buffsize);
+    if (buffer) deallocate_mirrored(buffer, buffsize);
 
     buffer   = new_buffer;
     index    = 0;
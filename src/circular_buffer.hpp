@@ -10,9 +10,15 @@
 #ifndef CIRCULAR_BUFFER_HPP
 #define CIRCULAR_BUFFER_HPP
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+
+#if defined(__APPLE__)
 #include <mach/vm_page_size.h>
+#else
+#include <unistd.h>
+#endif
 
 #define UNLIKELY(x) __builtin_expect((x), 0)
 
@@ -29,9 +35,20 @@ private:
     size_t length;
     size_t buffsize;
 
+    // Implemented per platform, see circular_buffer.cpp for macOS and
+    // circular_buffer_memfd.cpp for Linux.
     static void* allocate_mirrored(size_t size);
     static void deallocate_mirrored(void *ptr, size_t size);
 
+    static size_t page_size() {
+#if defined(__APPLE__)
+        return vm_page_size;
+#else
+        static const size_t size = sysconf(_SC_PAGESIZE);
+        return size;
+#endif
+    }
+
     // Round up to the nearest power of 2 greater than or equal to page size
     static size_t round_up_capacity(size_t val) {
         --val;
@@ -40,7 +57,7 @@ private:
             val |= val >> i;
         }
 
-        return mach_vm_round_page(val + 1);
+        return std::max(val + 1, page_size());
     }
 
     void resize(size_t size);
@@ -74,7 +91,7 @@ public:
         if (buffsize < other.length) {
             if (buffer) deallocate_mirrored(buffer, buffsize);
 
-            buffsize = mach_vm_round_page(other.length);
+            buffsize = round_up_capacity(other.length);
             buffer   = static_cast<char*>(allocate_mirrored(buffsize));
         }
 
@@ -169,6 +186,18 @@ public:
         }
     }
 
+    /// Decrease the capacity of the buffer to the smallest capacity that is
+    /// greater than or equal to new_capacity and size(). The buffer is
+    /// reallocated, pointers into it are invalidated. Complexity: Linear in
+    /// size().
+    void shrink(size_t new_capacity) {
+        const size_t rounded = round_up_capacity(std::max(new_capacity, length));
+
+        if (rounded < buffsize) {
+            resize(rounded);
+        }
+    }
+
     /// Append byte to the end of the buffer. Complexity: Constant amortized.
     void push_back(unsigned char byte) {
         if (UNLIKELY(length == buffsize)) {
@@ -190,6 +219,26 @@ public:
         length += size;
     }
 
+    /// Returns a pointer to at least size bytes of writable space following
+    /// the end of the buffer. Because the buffer is mirrored, this space is
+    /// always contiguous. Bytes written there are not part of the buffer until
+    /// they're committed. Complexity: Constant, unless the buffer needs to
+    /// grow, in which case linear in size().
+    char* prepare(size_t size) {
+        if (UNLIKELY(size > buffsize - length)) {
+            resize(round_up_capacity(std::max(length + size, buffsize * 2)));
+        }
+
+        return end();
+    }
+
+    /// Appends size bytes written to the space returned by prepare() to the
+    /// end of the buffer. Complexity: Constant.
+    void commit(size_t size) {
+        assert(size <= buffsize - length);
+        length += size;
+    }
+
     /// Consume size bytes from the start of the buffer. This marks the region
     /// as safe to overwrite with new data. Complexity: Constant.
     void consume(size_t size) {
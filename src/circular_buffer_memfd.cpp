@@ -0,0 +1,133 @@
+//
+//  Neovim Mac
+//  circular_buffer_memfd.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+// The memfd backend. See circular_buffer.cpp for the Mach VM backend.
+#if defined(__linux__)
+
+#include <cstdint>
+#include <cstdlib>
+#include <sanitizer/asan_interface.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "circular_buffer.hpp"
+
+// Define CIRCULAR_BUFFER_HUGE_PAGES to back large buffers with huge pages.
+// Huge pages have to be reserved by the system administrator, see
+// vm.nr_hugepages. If none are available we fall back to regular pages.
+#if defined(CIRCULAR_BUFFER_HUGE_PAGES)
+static constexpr size_t huge_page_size = 2 * 1024 * 1024;
+#endif
+
+// Maps the same size bytes of fd twice, back to back, at an address aligned to
+// alignment. Returns nullptr on failure.
+static void* map_mirrored(int fd, size_t size, size_t alignment) {
+    // Reserve enough address space to align the mapping, the file is then
+    // mapped over the reservation. Once the file mappings are in place, no
+    // other thread can map anything into the middle of our region.
+    const size_t reserved = size * 2 + alignment;
+    void *reservation = mmap(nullptr, reserved, PROT_NONE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if (reservation == MAP_FAILED) {
+        return nullptr;
+    }
+
+    const uintptr_t start = reinterpret_cast<uintptr_t>(reservation);
+    const uintptr_t aligned = (start + alignment - 1) & ~(alignment - 1);
+    char *addr = reinterpret_cast<char*>(aligned);
+
+    void *first = mmap(addr, size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_FIXED, fd, 0);
+
+    void *second = first == MAP_FAILED ? MAP_FAILED :
+                   mmap(addr + size, size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_FIXED, fd, 0);
+
+    if (second == MAP_FAILED) {
+        munmap(reservation, reserved);
+        return nullptr;
+    }
+
+    // Trim the unused ends of the reservation.
+    if (aligned != start) {
+        munmap(reservation, aligned - start);
+    }
+
+    const uintptr_t end = start + reserved;
+    const uintptr_t mapped_end = aligned + size * 2;
+
+    if (mapped_end != end) {
+        munmap(reinterpret_cast<void*>(mapped_end), end - mapped_end);
+    }
+
+    return addr;
+}
+
+// Creates an anonymous file of the given size and maps it twice. Returns
+// nullptr on failure.
+static void* allocate_memfd(size_t size, unsigned int flags, size_t alignment) {
+    int fd = memfd_create("circular_buffer", MFD_CLOEXEC | flags);
+
+    if (fd == -1) {
+        return nullptr;
+    }
+
+    void *addr = nullptr;
+
+    if (ftruncate(fd, size) == 0) {
+        addr = map_mirrored(fd, size, alignment);
+    }
+
+    // The mappings keep the file alive.
+    close(fd);
+    return addr;
+}
+
+// Allocates a mirrored buffer, that is a virtual memory region size * 2 bytes
+// long. Both halves map the same memory. Size must be a multiple of the
+// systems page size. Aborts on failure.
+void* circular_buffer::allocate_mirrored(size_t size) {
+    assert(size % page_size() == 0);
+
+#if defined(CIRCULAR_BUFFER_HUGE_PAGES)
+    if (size >= huge_page_size && size % huge_page_size == 0) {
+        if (void *addr = allocate_memfd(size, MFD_HUGETLB, huge_page_size)) {
+            return addr;
+        }
+    }
+#endif
+
+    void *addr = allocate_memfd(size, 0, page_size());
+
+    if (!addr) {
+        std::abort();
+    }
+
+    return addr;
+}
+
+// Deallocates a pointer allocated with allocate_mirrored(). Size should be the
+// same value passed to allocate_mirrored(). Aborts on failure.
+void circular_buffer::deallocate_mirrored(void *ptr, size_t size) {
+    // In debug builds ptr is not deallocated, instead it's marked as
+    // inaccessible, this helps catch use after frees.
+#ifdef DEBUG
+    ASAN_POISON_MEMORY_REGION(ptr, size * 2);
+    int error = mprotect(ptr, size * 2, PROT_NONE);
+#else
+    int error = munmap(ptr, size * 2);
+#endif
+
+    if (error) {
+        std::abort();
+    }
+}
+
+#endif // __linux__
@@ -0,0 +1,55 @@
+//
+//  Neovim Mac
+//  color_class.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <cstdio>
+#include "color_class.hpp"
+
+size_t color_class_stats::key_hash::operator()(const key_type &key) const {
+    // FNV-1a. Stats collection isn't on the render path, so we favor hash
+    // quality over speed here.
+    const unsigned char *bytes = reinterpret_cast<const unsigned char*>(&key);
+    size_t hash = 14695981039346656037ull;
+
+    for (size_t i=0; i<sizeof(key_type); ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+
+    return hash;
+}
+
+void color_class_stats::add(const nvim::cell &cell) {
+    if (cell.empty()) {
+        return;
+    }
+
+    key_type key;
+    key.graphemes = cell.grapheme();
+    key.background = cell.background().opaque();
+    key.foreground = cell.foreground().opaque();
+    key.font = static_cast<uint32_t>(cell.font_attributes());
+    exact.insert(key);
+
+    if (color_class cls = color_class::make(cell)) {
+        key.background = cls.background().opaque();
+        key.foreground = cls.foreground().opaque();
+    }
+
+    classed.insert(key);
+}
+
+std::string color_class_stats::report() const {
+    double saved = exact.size() ? 100.0 * saved_entries() / exact.size() : 0;
+    char buffer[128];
+
+    snprintf(buffer, sizeof(buffer),
+             "glyph entries: %zu exact, %zu with color classes, %zu saved (%.1f%%)",
+             exact_entries(), class_entries(), saved_entries(), saved);
+
+    return buffer;
+}
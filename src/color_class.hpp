@@ -0,0 +1,214 @@
+//
+//  Neovim Mac
+//  color_class.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef COLOR_CLASS_HPP
+#define COLOR_CLASS_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+#include "cell.hpp"
+#include "color_class_types.hpp"
+
+/// A glyph color class.
+///
+/// CoreText dilates glyphs differently depending on their foreground and
+/// background colors, so glyphs are normally rasterized and cached once per
+/// color pair. Color classes trade a little accuracy for fewer cache entries.
+/// Colors are quantized into GLYPH_COLOR_CLASS_LEVELS luminance levels, and
+/// glyphs are rasterized once per level pair using a representative grey for
+/// each level. The glyph shader recovers per channel coverage from the
+/// representative colors and tints the glyph with the cell's actual colors.
+///
+/// Color pairs whose colors quantize to the same level have too little
+/// contrast to recover coverage from. Such pairs have no color class and are
+/// rasterized with their exact colors.
+class color_class {
+private:
+    uint16_t value;
+
+    explicit color_class(uint16_t value): value(value) {}
+
+    static nvim::rgb_color grey(uint32_t level) {
+        uint32_t component = glyph_color_class_grey(level);
+        return nvim::rgb_color(component, component, component);
+    }
+
+public:
+    /// A null color class. Glyphs are rasterized with their exact colors.
+    color_class(): value(GLYPH_NO_COLOR_CLASS) {}
+
+    /// Returns the luminance level of color.
+    /// Uses integer Rec. 709 luma weights on the gamma encoded components.
+    static uint32_t level(nvim::rgb_color color) {
+        uint32_t luma = (54  * color.red()   +
+                         183 * color.green() +
+                         19  * color.blue()) >> 8;
+
+        return (luma * GLYPH_COLOR_CLASS_LEVELS) >> 8;
+    }
+
+    /// Returns the color class of a foreground and background color pair.
+    /// The returned class is null if both colors have the same level.
+    static color_class make(nvim::rgb_color foreground,
+                            nvim::rgb_color background) {
+        uint32_t fg_level = level(foreground);
+        uint32_t bg_level = level(background);
+
+        if (fg_level == bg_level) {
+            return color_class();
+        }
+
+        return color_class(glyph_color_class_make(fg_level, bg_level));
+    }
+
+    /// Returns the color class of a cell, or a null class if the cell's text
+    /// can not be tinted. See eligible().
+    static color_class make(const nvim::cell &cell) {
+        if (!eligible(cell.grapheme_view())) {
+            return color_class();
+        }
+
+        return make(cell.foreground(), cell.background());
+    }
+
+    /// True if text can be rendered using a color class.
+    ///
+    /// Color glyphs, like emoji, can't be tinted. Rather than asking CoreText,
+    /// we conservatively accept text made up entirely of code points from
+    /// blocks without emoji:
+    ///   - Below U+2000: Latin, Greek, Cyrillic, and most other scripts.
+    ///   - U+2500 to U+259F: Box drawing and block elements.
+    ///   - U+E000 to U+F8FF: The private use area, used by powerline and
+    ///     other patched fonts for their symbols.
+    /// U+2000 to U+2BFF mixes symbols with emoji, like U+2122 and U+2600 to
+    /// U+27BF, so the rest of it is excluded, as are variation selectors and
+    /// everything above U+FFFF.
+    static bool eligible(std::string_view text) {
+        for (size_t i=0; i<text.size(); ++i) {
+            unsigned char byte = text[i];
+
+            // ASCII, continuation bytes, and lead bytes below U+2000.
+            if (byte < 0xE2) {
+                continue;
+            }
+
+            if (i + 2 >= text.size()) {
+                return false;
+            }
+
+            unsigned char second = text[i + 1];
+            unsigned char third = text[i + 2];
+
+            bool box_drawing = byte == 0xE2 && (second == 0x94 || second == 0x95 ||
+                                                (second == 0x96 && third < 0xA0));
+
+            bool private_use = byte == 0xEE || (byte == 0xEF && second < 0xA4);
+
+            if (!box_drawing && !private_use) {
+                return false;
+            }
+
+            i += 2;
+        }
+
+        return true;
+    }
+
+    /// True if this is not a null color class.
+    explicit operator bool() const {
+        return value != GLYPH_NO_COLOR_CLASS;
+    }
+
+    /// The class index written to glyph_data::color_class.
+    uint16_t index() const {
+        return value;
+    }
+
+    /// The representative foreground color glyphs are rasterized with.
+    nvim::rgb_color foreground() const {
+        return grey(value >> 4);
+    }
+
+    /// The representative background color glyphs are rasterized with.
+    nvim::rgb_color background() const {
+        return grey(value & 0xF);
+    }
+};
+
+/// Measures the glyph cache entries saved by color classes.
+///
+/// Counts the unique glyph cache entries needed to render a set of cells with
+/// and without color classes. Fonts are identified by their font attributes,
+/// so stats should only be collected for cells rendered with a single font
+/// family. Empty cells are ignored, they don't have glyphs.
+class color_class_stats {
+private:
+    struct key_type {
+        nvim::grapheme_cluster graphemes;
+        uint32_t background;
+        uint32_t foreground;
+        uint32_t font;
+    };
+
+    struct key_hash {
+        size_t operator()(const key_type &key) const;
+    };
+
+    struct key_equal {
+        bool operator()(const key_type &left, const key_type &right) const {
+            return memcmp(&left, &right, sizeof(key_type)) == 0;
+        }
+    };
+
+    using key_set = std::unordered_set<key_type, key_hash, key_equal>;
+
+    key_set exact;
+    key_set classed;
+
+public:
+    /// Adds a cell to the stats.
+    void add(const nvim::cell &cell);
+
+    /// Adds a range of cells to the stats, for example a grid's cells.
+    void add(const nvim::cell *begin, const nvim::cell *end) {
+        for (const nvim::cell *cell = begin; cell != end; ++cell) {
+            add(*cell);
+        }
+    }
+
+    /// The number of unique glyph entries needed without color classes.
+    size_t exact_entries() const {
+        return exact.size();
+    }
+
+    /// The number of unique glyph entries needed with color classes.
+    size_t class_entries() const {
+        return classed.size();
+    }
+
+    /// The number of glyph entries saved by color classes.
+    size_t saved_entries() const {
+        return exact.size() - classed.size();
+    }
+
+    /// Returns a one line summary of the entries needed and saved.
+    std::string report() const;
+
+    /// Resets the stats.
+    void clear() {
+        exact.clear();
+        classed.clear();
+    }
+};
+
+#endif // COLOR_CLASS_HPP
@@ -0,0 +1,38 @@
+//
+//  Neovim Mac
+//  color_class_types.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef COLOR_CLASS_TYPES_HPP
+#define COLOR_CLASS_TYPES_HPP
+
+// Shared by the glyph shader and color_class.hpp, so it doesn't depend on
+// simd or on the Metal standard library.
+
+#ifndef __METAL_VERSION__
+#include <stdint.h>
+#endif
+
+/// The number of luminance levels used by glyph color classes.
+/// See color_class.hpp for more information.
+#define GLYPH_COLOR_CLASS_LEVELS 4
+
+/// Marks glyphs that were rasterized with their exact colors.
+#define GLYPH_NO_COLOR_CLASS 0xFFFF
+
+/// Returns the color class index of a foreground and background level pair.
+static inline uint16_t glyph_color_class_make(uint32_t fg_level, uint32_t bg_level) {
+    return static_cast<uint16_t>((fg_level << 4) | bg_level);
+}
+
+/// Returns the representative grey of a luminance level as an 8 bit component.
+/// Representative greys are in the middle of their level's luminance range.
+static inline uint32_t glyph_color_class_grey(uint32_t level) {
+    return ((2 * level + 1) * 255) / (2 * GLYPH_COLOR_CLASS_LEVELS);
+}
+
+#endif // COLOR_CLASS_TYPES_HPP
@@ -16,6 +16,7 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include "color_class.hpp"
 #include "shader_types.hpp"
 #include "ui.hpp"
 
@@ -443,12 +444,27 @@ private:
 
     size_t evict_threshold;
     size_t evict_preserve;
+    size_t evictions;
+    bool use_color_classes;
     glyph_rasterizer *rasterizer;
     glyph_texture_cache texture_cache;
     glyph_map map;
 
     void do_evict();
 
+    color_class cell_color_class(const nvim::cell &cell) const {
+        return use_color_classes ? color_class::make(cell) : color_class();
+    }
+
+    /// The glyph's colors are written separately, see glyph_colors. A null
+    /// color class has the index GLYPH_NO_COLOR_CLASS.
+    static glyph_data make_glyph_data(simd_short2 grid_position,
+                                      const nvim::cell &cell,
+                                      glyph_rect rect,
+                                      color_class cls) {
+        return glyph_data(grid_position, cell.width(), rect, cls.index());
+    }
+
 public:
     /// Default constructed objects should only be assigned to or destroyed.
     /// This constructor is only provided because Objective-C++ requires C++
@@ -462,14 +478,19 @@ public:
     /// @param evict_preserve   The number of texture cache pages preserved
     ///                         on eviction. This number should be less than
     ///                         evict_threshold.
+    /// @param color_classes    If true, glyphs are shared between colors of
+    ///                         the same color class. See color_class.hpp.
     glyph_manager(glyph_rasterizer *rasterizer,
                   glyph_texture_cache texture_cache,
                   size_t evict_threshold,
-                  size_t evict_preserve):
+                  size_t evict_preserve,
+                  bool color_classes = false):
         rasterizer(rasterizer),
         texture_cache(std::move(texture_cache)),
         evict_threshold(evict_threshold),
-        evict_preserve(evict_preserve) {}
+        evict_preserve(evict_preserve),
+        evictions(0),
+        use_color_classes(color_classes) {}
 
     /// Returns a cached glyph with the given attributes.
     /// @param font         The font.
@@ -511,6 +532,50 @@ public:
         return get(font, cell, cell.background(), cell.foreground());
     }
 
+    /// Returns the glyph_data for the given cell.
+    /// If color classes are enabled and the cell has a color class, the glyph
+    /// is rasterized using the class colors and tinted by the glyph shader.
+    glyph_data get(const font_family &font_family,
+                   const nvim::cell &cell,
+                   simd_short2 grid_position) {
+        CTFontRef font = font_family.get(cell.font_attributes());
+        color_class cls = cell_color_class(cell);
+
+        if (cls) {
+            glyph_rect rect = get(font, cell, cls.background(), cls.foreground());
+            return make_glyph_data(grid_position, cell, rect, cls);
+        }
+
+        glyph_rect rect = get(font, cell, cell.background(), cell.foreground());
+        return make_glyph_data(grid_position, cell, rect, cls);
+    }
+
+    /// Looks up the glyph_data for the given cell without rasterizing.
+    ///
+    /// Unlike get(), this function does not modify the glyph manager. It may be
+    /// called concurrently from multiple threads, provided no other thread is
+    /// calling a non-const member function.
+    ///
+    /// @returns True if the glyph was cached, otherwise false. On failure,
+    ///          data is not modified.
+    bool find(const font_family &font_family,
+              const nvim::cell &cell,
+              simd_short2 grid_position,
+              glyph_data *data) const {
+        CTFontRef font = font_family.get(cell.font_attributes());
+        color_class cls = cell_color_class(cell);
+
+        key_type key = cls ? key_type(font, cell.grapheme(), cls.background(), cls.foreground()) :
+                             key_type(font, cell.grapheme(), cell.background(), cell.foreground());
+
+        if (auto iter = map.find(key); iter != map.end()) {
+            *data = make_glyph_data(grid_position, cell, iter->second, cls);
+            return true;
+        }
+
+        return false;
+    }
+
     /// Returns the Metal texture containing the cached glyphs.
     id<MTLTexture> texture() const {
         return texture_cache.metal_texture();
@@ -522,9 +587,22 @@ public:
     /// n is the evict_preserve value passed to the constructor.
     void evict() {
         if (texture_cache.pages_capacity() > evict_threshold) {
+            evictions += 1;
             do_evict();
         }
     }
+
+    /// True if glyphs are shared between colors of the same color class.
+    /// Color classed glyphs are drawn with a glyph_colors stream.
+    bool color_classes() const {
+        return use_color_classes;
+    }
+
+    /// The number of times the cache has been evicted. Glyph data obtained
+    /// before an eviction may refer to evicted or moved cache pages.
+    size_t eviction_count() const {
+        return evictions;
+    }
 };
 
 #endif // GLYPH_HPP
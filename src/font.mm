@@ -206,6 +206,7 @@ glyph_bitmap glyph_rasterizer::rasterize(CTFontRef font,
                                          nvim::rgb_color background,
                                          nvim::rgb_color foreground,
                                          std::string_view text) {
+    nvim::trace_span span("glyph_rasterize");
     CGContextSetTextPosition(context.get(), midx, midy);
     arc_ptr line = make_line(font, foreground, text);
 
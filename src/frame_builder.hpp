@@ -0,0 +1,697 @@
+//
+//  Neovim Mac
+//  frame_builder.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef FRAME_BUILDER_HPP
+#define FRAME_BUILDER_HPP
+
+#include <algorithm>
+#include <vector>
+
+#include "cell.hpp"
+#include "shader_types.hpp"
+
+/// Adjusts the color attributes of cells under a block cursor.
+class adjusted_grid {
+private:
+    struct range {
+        const nvim::cell *begin;
+        int16_t row_begin;
+        int16_t row_end;
+        int16_t col_begin;
+        int16_t col_end;
+    };
+
+    nvim::cell adjusted_cells[2];
+    range ranges[4];
+    size_t ranges_count;
+    size_t grid_width;
+    size_t grid_height;
+    const nvim::grid *source;
+
+public:
+    /// Constructs an adjusted grid.
+    /// @param cells    The grid's cells in row major order.
+    /// @param width    The grid's width.
+    /// @param height   The grid's height.
+    /// @param cursor   The grid's cursor. Must point into cells.
+    adjusted_grid(const nvim::cell *cells, size_t width, size_t height,
+                  const nvim::cursor &cursor): grid_width(width),
+                                               grid_height(height),
+                                               source(nullptr) {
+        ranges[0].begin = cells;
+        ranges[0].row_begin = 0;
+        ranges[0].col_begin = 0;
+
+        // If we're not dealing with a block cursor, no adjusments need to be
+        // made. We can iterate the grid in one swoop.
+        if (cursor.shape() != nvim::cursor_shape::block) {
+            ranges_count = 1;
+            ranges[0].row_end = height;
+            ranges[0].col_end = width;
+            return;
+        }
+
+        // We need to adjust the cursor cells.
+        // Grid's are immutable, so we make a copy of the adjusted cells.
+        const nvim::cell *cursor_cell = &cursor.cell();
+        size_t cursor_width = cursor.width();
+
+        adjusted_cells[0] = cursor_cell[0].recolored(cursor.foreground(),
+                                                     cursor.background(),
+                                                     cursor.special());
+
+        if (cursor_width == 2) {
+            adjusted_cells[1] = cursor_cell[1].recolored(cursor.foreground(),
+                                                         cursor.background(),
+                                                         cursor.special());
+        }
+
+        // When iterating over the grid, we need to swap out cursor cells with
+        // our adjusted cells. The iteration order required to do that is
+        // stored in an array of four range objects.
+        ranges_count = 4;
+
+        // Start with full rows up until the cursor row.
+        ranges[0].row_end = cursor.row();
+        ranges[0].col_end = width;
+
+        // Iterate from the start over the cursor row till the cursor column.
+        ranges[1].begin     = cursor_cell - cursor.col();
+        ranges[1].row_begin = cursor.row();
+        ranges[1].row_end   = cursor.row() + 1;
+        ranges[1].col_begin = 0;
+        ranges[1].col_end   = cursor.col();
+
+        // We're at the cursor cells. Iterate over the adjusted cells instead.
+        ranges[2].begin     = adjusted_cells;
+        ranges[2].row_begin = cursor.row();
+        ranges[2].row_end   = cursor.row() + 1;
+        ranges[2].col_begin = cursor.col();
+        ranges[2].col_end   = cursor.col() + cursor_width;
+
+        // Start from after the cursor cells and finish off the grid.
+        ranges[3].begin     = cursor_cell + cursor_width;
+        ranges[3].row_begin = cursor.row();
+        ranges[3].row_end   = height;
+        ranges[3].col_begin = cursor.col() + cursor_width;
+        ranges[3].col_end   = width;
+    }
+
+    /// Constructs an adjusted grid from a grid and its cursor.
+    adjusted_grid(const nvim::grid &grid, const nvim::cursor &cursor):
+        adjusted_grid(grid.begin(), grid.width(), grid.height(), cursor) {
+        source = &grid;
+    }
+
+    /// Constructs an adjusted grid without a cursor. No cells are adjusted.
+    adjusted_grid(const nvim::cell *cells, size_t width, size_t height):
+        ranges_count(1), grid_width(width), grid_height(height), source(nullptr) {
+        ranges[0].begin = cells;
+        ranges[0].row_begin = 0;
+        ranges[0].row_end = height;
+        ranges[0].col_begin = 0;
+        ranges[0].col_end = width;
+    }
+
+    /// Constructs an adjusted grid from a grid, ignoring its cursor.
+    explicit adjusted_grid(const nvim::grid &grid):
+        adjusted_grid(grid.begin(), grid.width(), grid.height()) {
+        source = &grid;
+    }
+
+    /// The grid's width.
+    size_t width() const {
+        return grid_width;
+    }
+
+    /// The grid's height.
+    size_t height() const {
+        return grid_height;
+    }
+
+    /// The number of lines drawn for the rows [row_begin, row_end). Cursor
+    /// adjustments only change colors, so this is the same as the underlying
+    /// grid's count. Uses the grid's per row counts if constructed from a
+    /// nvim::grid, otherwise counts the cells.
+    size_t line_emphasis_count(size_t row_begin, size_t row_end) const {
+        size_t count = 0;
+
+        if (source) {
+            for (size_t row = row_begin; row < row_end; ++row) {
+                count += source->line_emphasis_count(row);
+            }
+        } else {
+            for_each(row_begin, row_end, [&](int16_t, int16_t, const nvim::cell *cell) {
+                count += cell->line_emphasis_count();
+            });
+        }
+
+        return count;
+    }
+
+    /// Iterate over the rows [row_begin, row_end) of the cursor adjusted grid.
+    /// Calls the function object callback once for every cell in ascending
+    /// order. The callback is invoked with three arguments:
+    ///   1. The cell's row (int16_t).
+    ///   2. The cell's column (int16_t).
+    ///   3. A const pointer to the cell (const nvim::cell*).
+    /// The return value of the callback is ignored.
+    template<typename Callable>
+    void for_each(size_t row_begin, size_t row_end, Callable callback) const {
+        for (size_t i=0; i<ranges_count; ++i) {
+            const range &range = ranges[i];
+            const int16_t first = std::max<int16_t>(range.row_begin, row_begin);
+            const int16_t last = std::min<int16_t>(range.row_end, row_end);
+
+            if (first >= last) {
+                continue;
+            }
+
+            const nvim::cell *cell = range.begin;
+            int16_t col = range.col_begin;
+
+            // Skip the rows before first. The range's first row starts at
+            // col_begin, the following rows are col_end cells long.
+            if (first > range.row_begin) {
+                cell += (range.col_end - range.col_begin) +
+                        (first - range.row_begin - 1) * range.col_end;
+                col = 0;
+            }
+
+            for (int16_t row = first; row < last; ++row) {
+                for (; col < range.col_end; ++col, ++cell) {
+                    callback(row, col, cell);
+                }
+
+                col = 0;
+            }
+        }
+    }
+
+    /// Iterate over every cell of the cursor adjusted grid.
+    /// Equivalent to for_each(0, height(), callback).
+    template<typename Callable>
+    void for_each(Callable callback) const {
+        for_each(0, grid_height, callback);
+    }
+};
+
+/// Calls function(context, index) for every index in [0, count), possibly in
+/// parallel. Returns once every call has returned. On macOS, this is
+/// dispatch_apply_f() with a concurrent queue.
+using parallel_for = void (*)(size_t count, void *context,
+                              void (*function)(void *context, size_t index));
+
+/// The number of instances written by a frame_builder.
+struct frame_counts {
+    size_t backgrounds;
+    size_t glyphs;
+    size_t lines;
+};
+
+/// Builds the instance data used to render a grid.
+///
+/// Backgrounds are run length encoded. Adjacent cells on the same row with the
+/// same background color are merged into a single background_data span, so the
+/// number of background instances is proportional to the number of color
+/// changes, rather than the number of cells.
+///
+/// Large grids are split into bands of rows and built in parallel. Bands first
+/// count their instances, background spans and glyphs by scanning their cells,
+/// lines from the grid's per row counts. The counts are returned to the caller,
+/// who can size the output buffers exactly. A prefix sum over the band counts
+/// gives each band's offset into the output buffers, and each band then writes
+/// its instances directly into place. Rows are independent of each other,
+/// undercurl continuations never cross a row boundary, so splitting on rows
+/// doesn't change the output.
+///
+/// The frame builder has no Metal, CoreText or libdispatch dependencies.
+/// Glyphs are obtained through a caller provided function object or glyph
+/// source, and bands are run by a caller provided parallel_for.
+class frame_builder {
+private:
+    /// A glyph a band couldn't find without rasterizing.
+    struct glyph_miss {
+        size_t index;
+        const nvim::cell *cell;
+        simd_short2 grid_position;
+    };
+
+    /// A band of rows, its instance counts and its offsets into the output.
+    struct band {
+        size_t row_begin;
+        size_t row_end;
+        std::vector<glyph_miss> misses;
+        frame_counts counts;
+        frame_counts offsets;
+    };
+
+    line_metrics underline;
+    line_metrics undercurl;
+    line_metrics strikethrough;
+    std::vector<band> bands;
+
+    /// Invokes func(index) for every index in [0, count) with parallel.
+    template<typename Func>
+    static void apply(size_t count, parallel_for parallel, Func &func) {
+        parallel(count, &func, [](void *context, size_t index) {
+            (*static_cast<Func*>(context))(index);
+        });
+    }
+
+    /// Writes the line_data for a cell with line emphasis.
+    line_data* write_lines(const nvim::cell &cell,
+                           simd_short2 gridpos,
+                           uint16_t undercurl_position,
+                           line_data *lines) const {
+        nvim::rgb_color color = cell.special();
+
+        // Undercurls and underlines are mutually exclusive. We'll make
+        // undercurls take priority, they usually represent errors,
+        // so users won't appreciate them being hidden.
+        if (cell.has_undercurl()) {
+            *lines++ = line_data(gridpos, color, undercurl, undercurl_position);
+        } else if (cell.has_underline()) {
+            *lines++ = line_data(gridpos, color, underline);
+        }
+
+        if (cell.has_strikethrough()) {
+            *lines++ = line_data(gridpos, color, strikethrough);
+        }
+
+        return lines;
+    }
+
+    /// Returns the position of cell in its row's run of undercurled cells, the
+    /// number of undercurled cells directly to its left. col is its column.
+    static uint16_t undercurl_run(const nvim::cell *cell, size_t col) {
+        const nvim::cell *row_begin = cell - col;
+        uint16_t position = 0;
+
+        for (; cell != row_begin && cell[-1].has_undercurl(); --cell) {
+            position += 1;
+        }
+
+        return position;
+    }
+
+    /// Counts the instances build_rows() writes for the given rows.
+    static frame_counts count_rows(const adjusted_grid &grid,
+                                   size_t row_begin,
+                                   size_t row_end) {
+        frame_counts counts = {};
+        int16_t span_row = -1;
+        uint32_t span_color = 0;
+
+        grid.for_each(row_begin, row_end, [&](int16_t row, int16_t col,
+                                              const nvim::cell *cell) {
+            uint32_t background = cell->background().opaque();
+
+            if (span_row != row || span_color != background) {
+                span_row = row;
+                span_color = background;
+                counts.backgrounds += 1;
+            }
+
+            counts.glyphs += !cell->empty();
+        });
+
+        counts.lines = grid.line_emphasis_count(row_begin, row_end);
+        return counts;
+    }
+
+    template<typename GlyphFunc>
+    frame_counts build_rows(const adjusted_grid &grid,
+                            size_t row_begin,
+                            size_t row_end,
+                            background_data *backgrounds,
+                            glyph_data *glyphs,
+                            glyph_colors *colors,
+                            line_data *lines,
+                            GlyphFunc &&get_glyph) const {
+        background_data *backgrounds_begin = backgrounds;
+        glyph_data *glyphs_begin = glyphs;
+        line_data *lines_begin = lines;
+        simd_short2 undercurl_next = simd_make_short2(-1, -1);
+        uint16_t undercurl_position = 0;
+
+        // The current background span. It's only written out once it ends.
+        background_data span(simd_make_short2(-1, -1), 0, 0);
+
+        grid.for_each(row_begin, row_end, [&](int16_t row, int16_t col,
+                                              const nvim::cell *cell) {
+            simd_short2 gridpos = simd_make_short2(col, row);
+            uint32_t background = cell->background().opaque();
+
+            if (span.grid_position.y == row && span.color == background) {
+                span.length += 1;
+            } else {
+                if (span.length) {
+                    *backgrounds++ = span;
+                }
+
+                span = background_data(gridpos, 1, background);
+            }
+
+            if (cell->has_line_emphasis()) {
+                if (cell->has_undercurl()) {
+                    if (simd_equal(undercurl_next, gridpos)) {
+                        undercurl_position += 1;
+                    } else {
+                        undercurl_position = 0;
+                    }
+
+                    undercurl_next = simd_make_short2(col + 1, row);
+                }
+
+                lines = write_lines(*cell, gridpos, undercurl_position, lines);
+            }
+
+            if (!cell->empty()) {
+                if (colors) {
+                    *colors++ = glyph_colors(cell->foreground().opaque(),
+                                             cell->background().opaque());
+                }
+
+                *glyphs++ = get_glyph(*cell, gridpos);
+            }
+        });
+
+        if (span.length) {
+            *backgrounds++ = span;
+        }
+
+        frame_counts counts;
+        counts.backgrounds = backgrounds - backgrounds_begin;
+        counts.glyphs = glyphs - glyphs_begin;
+        counts.lines = lines - lines_begin;
+        return counts;
+    }
+
+public:
+    /// Grids with fewer cells than this are built on the calling thread.
+    static constexpr size_t min_band_cells = 16384;
+
+    /// The maximum number of bands a grid is split into.
+    static constexpr size_t max_bands = 16;
+
+    /// The maximum number of instances written by build_cursor().
+    static constexpr frame_counts max_cursor_counts = {1, 3, 8};
+
+    frame_builder() = default;
+
+    /// Constructs a frame builder.
+    /// @param underline        Underline metrics.
+    /// @param undercurl        Undercurl metrics.
+    /// @param strikethrough    Strikethrough metrics.
+    frame_builder(line_metrics underline,
+                  line_metrics undercurl,
+                  line_metrics strikethrough):
+        underline(underline),
+        undercurl(undercurl),
+        strikethrough(strikethrough) {}
+
+    /// The maximum number of background spans needed to draw a grid.
+    static size_t max_backgrounds(size_t cells_count) {
+        return cells_count;
+    }
+
+    /// The maximum number of glyphs needed to draw a grid.
+    static size_t max_glyphs(size_t cells_count) {
+        return cells_count;
+    }
+
+    /// The maximum number of lines needed to draw a grid. It takes two
+    /// line_data objects to handle a cell with both a strikethrough and an
+    /// underline / undercurl. Prefer nvim::grid::line_emphasis_count(), it's
+    /// the exact number of lines needed.
+    static size_t max_lines(size_t cells_count) {
+        return cells_count * 2;
+    }
+
+    /// Writes the instance data for grid on the calling thread.
+    ///
+    /// @param grid         The cursor adjusted grid.
+    /// @param backgrounds  Output for background spans. Must have room for
+    ///                     max_backgrounds() objects.
+    /// @param glyphs       Output for glyphs. Must have room for max_glyphs()
+    ///                     objects.
+    /// @param colors       Output for glyph colors, an entry per glyph, see
+    ///                     glyph_colors. May be null if color classes are
+    ///                     disabled.
+    /// @param lines        Output for lines. Must have room for one object per
+    ///                     line emphasis, see nvim::grid::line_emphasis_count().
+    /// @param get_glyph    Function object returning the glyph_data of a
+    ///                     non-empty cell. Invoked with two arguments:
+    ///                       1. The cell (const nvim::cell&).
+    ///                       2. The cell's grid position (simd_short2).
+    ///
+    /// The output buffers are written sequentially and never read from, they
+    /// may point to write combined memory.
+    ///
+    /// @returns The number of instances written.
+    template<typename GlyphFunc>
+    frame_counts build(const adjusted_grid &grid,
+                       background_data *backgrounds,
+                       glyph_data *glyphs,
+                       glyph_colors *colors,
+                       line_data *lines,
+                       GlyphFunc &&get_glyph) const {
+        return build_rows(grid, 0, grid.height(), backgrounds, glyphs, colors,
+                          lines, std::forward<GlyphFunc>(get_glyph));
+    }
+
+    /// Counts the instances build() writes for grid, so its output buffers can
+    /// be sized exactly. Large grids are split into bands and counted in
+    /// parallel. The bands are kept for the following build().
+    ///
+    /// @param grid     The cursor adjusted grid.
+    /// @param parallel Runs the bands, see parallel_for.
+    ///
+    /// @returns The number of instances build() writes.
+    frame_counts count(const adjusted_grid &grid, parallel_for parallel) {
+        const size_t width = grid.width();
+        const size_t height = grid.height();
+        const size_t band_count = std::max<size_t>(std::min({(width * height) / min_band_cells,
+                                                             max_bands, height}), 1);
+
+        const size_t band_rows = (height + band_count - 1) / band_count;
+        bands.resize(band_count);
+
+        auto count_band = [&](size_t index) {
+            band &band = bands[index];
+            band.row_begin = std::min(index * band_rows, height);
+            band.row_end = std::min(band.row_begin + band_rows, height);
+            band.counts = count_rows(grid, band.row_begin, band.row_end);
+        };
+
+        if (band_count == 1) {
+            count_band(0);
+        } else {
+            apply(band_count, parallel, count_band);
+        }
+
+        // Each band's output offsets are the sum of the counts before it.
+        frame_counts total = {};
+
+        for (band &band : bands) {
+            band.offsets = total;
+            total.backgrounds += band.counts.backgrounds;
+            total.glyphs += band.counts.glyphs;
+            total.lines += band.counts.lines;
+        }
+
+        return total;
+    }
+
+    /// Writes the instance data for grid, building large grids in parallel.
+    /// Must follow a count() of the same grid, its bands are the ones built.
+    ///
+    /// The output parameters are the same as the single threaded build(), but
+    /// only need room for the instances count() returned. Glyphs are obtained
+    /// from glyph_source, which must provide two member functions:
+    ///
+    ///     // Thread safe lookup, returns false if the glyph isn't cached.
+    ///     bool find(const nvim::cell&, simd_short2, glyph_data*) const;
+    ///
+    ///     // Returns the glyph, rasterizing it if needed.
+    ///     glyph_data get(const nvim::cell&, simd_short2);
+    ///
+    /// Bands only call find(). Glyphs that were not found are resolved with
+    /// get() on the calling thread once every band has finished.
+    ///
+    /// @param parallel Runs the bands, see parallel_for.
+    template<typename GlyphSource>
+    frame_counts build(const adjusted_grid &grid,
+                       background_data *backgrounds,
+                       glyph_data *glyphs,
+                       glyph_colors *colors,
+                       line_data *lines,
+                       GlyphSource &glyph_source,
+                       parallel_for parallel) {
+        if (bands.size() <= 1) {
+            return build(grid, backgrounds, glyphs, colors, lines,
+                         [&](const nvim::cell &cell, simd_short2 gridpos) {
+                return glyph_source.get(cell, gridpos);
+            });
+        }
+
+        auto build_band = [&](size_t index) {
+            band &band = bands[index];
+            band.misses.clear();
+
+            size_t glyph_index = band.offsets.glyphs;
+
+            build_rows(grid, band.row_begin, band.row_end,
+                       backgrounds + band.offsets.backgrounds,
+                       glyphs + band.offsets.glyphs,
+                       colors ? colors + band.offsets.glyphs : nullptr,
+                       lines + band.offsets.lines,
+                       [&](const nvim::cell &cell, simd_short2 gridpos) {
+                glyph_data data;
+
+                if (!glyph_source.find(cell, gridpos, &data)) {
+                    band.misses.push_back(glyph_miss{glyph_index, &cell, gridpos});
+                }
+
+                glyph_index += 1;
+                return data;
+            });
+        };
+
+        apply(bands.size(), parallel, build_band);
+
+        // Glyphs that weren't found are rasterized on the calling thread.
+        for (band &band : bands) {
+            for (const glyph_miss &miss : band.misses) {
+                glyphs[miss.index] = glyph_source.get(*miss.cell, miss.grid_position);
+            }
+        }
+
+        const band &last = bands.back();
+        frame_counts total;
+        total.backgrounds = last.offsets.backgrounds + last.counts.backgrounds;
+        total.glyphs = last.offsets.glyphs + last.counts.glyphs;
+        total.lines = last.offsets.lines + last.counts.lines;
+        return total;
+    }
+
+    /// Writes the instance data for the cells under a block cursor.
+    ///
+    /// Frames built from a grid without a cursor, see adjusted_grid(const
+    /// nvim::grid&), can be drawn with the cursor overlaid on top. The overlay
+    /// is drawn after the frame, and redraws the cursor cells with the
+    /// cursor's colors. Toggling the cursor only requires rebuilding the
+    /// overlay, the frame's instance data can be reused as is. The overlay
+    /// should be clipped to the cursor's cells when drawn, its lines may
+    /// extend beyond them.
+    ///
+    /// Some instances of neighbouring cells reach into the cursor's cells, and
+    /// the overlay's background covers them. A double width glyph to the left
+    /// of the cursor overhangs into it, and the lines of the row above may
+    /// extend down into it. The overlay redraws them with their own colors,
+    /// clipping leaves only the parts inside the cursor's cells.
+    ///
+    /// Other cursor shapes, and hidden cursors, don't have any overlay
+    /// instances, they're drawn by the cursor shader.
+    ///
+    /// @param cursor       The grid's cursor.
+    /// @param grid_width   The width of the cursor's grid.
+    ///
+    /// The remaining parameters are the same as build(). Output buffers must
+    /// have room for max_cursor_counts objects.
+    ///
+    /// @returns The number of instances written.
+    template<typename GlyphFunc>
+    frame_counts build_cursor(const nvim::cursor &cursor,
+                              size_t grid_width,
+                              background_data *backgrounds,
+                              glyph_data *glyphs,
+                              glyph_colors *colors,
+                              line_data *lines,
+                              GlyphFunc &&get_glyph) const {
+        frame_counts counts = {};
+
+        if (cursor.shape() != nvim::cursor_shape::block) {
+            return counts;
+        }
+
+        const nvim::cell *cells = &cursor.cell();
+        const size_t row = cursor.row();
+        const size_t col = cursor.col();
+        const size_t width = cursor.width();
+
+        backgrounds[0] = background_data(simd_make_short2(col, row), width,
+                                         cursor.background().opaque());
+        counts.backgrounds = 1;
+
+        if (col && cells[-1].width() == 2 && !cells[-1].empty()) {
+            const nvim::cell &left = cells[-1];
+
+            if (colors) {
+                colors[counts.glyphs] = glyph_colors(left.foreground().opaque(),
+                                                     left.background().opaque());
+            }
+
+            glyphs[counts.glyphs++] = get_glyph(left, simd_make_short2(col - 1, row));
+        }
+
+        if (row) {
+            const nvim::cell *above = cells - grid_width;
+            uint16_t above_position = undercurl_run(above, col);
+
+            for (size_t i=0; i<width; ++i) {
+                if (above[i].has_line_emphasis()) {
+                    simd_short2 gridpos = simd_make_short2(col + i, row - 1);
+                    line_data *end = write_lines(above[i], gridpos, above_position,
+                                                 lines + counts.lines);
+                    counts.lines = end - lines;
+                }
+
+                above_position = above[i].has_undercurl() ? above_position + 1 : 0;
+            }
+        }
+
+        // Undercurls are continuous, the overlay picks up where the cells to
+        // the left of the cursor left off.
+        uint16_t undercurl_position = undercurl_run(cells, col);
+
+        for (size_t i=0; i<width; ++i) {
+            simd_short2 gridpos = simd_make_short2(col + i, row);
+            nvim::cell cell = cells[i].recolored(cursor.foreground(),
+                                                 cursor.background(),
+                                                 cursor.special());
+
+            if (cell.has_line_emphasis()) {
+                line_data *end = write_lines(cell, gridpos, undercurl_position,
+                                             lines + counts.lines);
+                counts.lines = end - lines;
+            }
+
+            if (cell.has_undercurl()) {
+                undercurl_position += 1;
+            } else {
+                undercurl_position = 0;
+            }
+
+            if (!cell.empty()) {
+                if (colors) {
+                    colors[counts.glyphs] = glyph_colors(cell.foreground().opaque(),
+                                                         cell.background().opaque());
+                }
+
+                glyphs[counts.glyphs++] = get_glyph(cell, gridpos);
+            }
+        }
+
+        return counts;
+    }
+};
+
+#endif // FRAME_BUILDER_HPP
@@ -0,0 +1,271 @@
+//
+//  Neovim Mac
+//  headless.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <chrono>
+#include <cstdio>
+
+#include "headless.hpp"
+
+namespace nvim {
+
+static uint64_t now_nanoseconds() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void append_color(std::string &out, const char *name, rgb_color color) {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), " %s=%06x", name,
+             (color.red() << 16) | (color.green() << 8) | color.blue());
+    out += buffer;
+}
+
+static void append_attributes(std::string &out, const cell_attributes &attrs) {
+    static constexpr std::pair<uint16_t, const char*> flag_names[] = {
+        {cell_attributes::bold,          "bold"},
+        {cell_attributes::italic,        "italic"},
+        {cell_attributes::emoji,         "emoji"},
+        {cell_attributes::underline,     "underline"},
+        {cell_attributes::undercurl,     "undercurl"},
+        {cell_attributes::strikethrough, "strikethrough"},
+        {cell_attributes::doublewidth,   "doublewidth"},
+        {cell_attributes::reverse,       "reverse"}
+    };
+
+    append_color(out, "fg", attrs.foreground);
+    append_color(out, "bg", attrs.background);
+    append_color(out, "sp", attrs.special);
+
+    char separator = ' ';
+
+    for (auto [flag, name] : flag_names) {
+        if (attrs.flags & flag) {
+            out += separator;
+            out += name;
+            separator = ',';
+        }
+    }
+}
+
+static bool same_attributes(const cell_attributes &left, const cell_attributes &right) {
+    return left.foreground.rgb() == right.foreground.rgb() &&
+           left.background.rgb() == right.background.rgb() &&
+           left.special.rgb()    == right.special.rgb()    &&
+           left.flags            == right.flags;
+}
+
+std::string grid_dump(const grid &grid) {
+    std::string out;
+    char buffer[128];
+
+    nvim::cursor cursor = grid.cursor();
+    snprintf(buffer, sizeof(buffer), "grid %zux%zu cursor %zu,%zu\n",
+             grid.width(), grid.height(), cursor.row(), cursor.col());
+    out += buffer;
+
+    for (size_t row=0; row<grid.height(); ++row) {
+        const cell *cells = grid.get(row, 0);
+
+        for (size_t col=0; col<grid.width(); ++col) {
+            std::string_view text = cells[col].grapheme_view();
+            out += text.empty() ? " " : text;
+        }
+
+        out += '\n';
+    }
+
+    for (size_t row=0; row<grid.height(); ++row) {
+        const cell *cells = grid.get(row, 0);
+        size_t begin = 0;
+
+        snprintf(buffer, sizeof(buffer), "row %zu:", row);
+        out += buffer;
+
+        for (size_t col=1; col<=grid.width(); ++col) {
+            if (col < grid.width() && same_attributes(cells[col].attributes(),
+                                                      cells[begin].attributes())) {
+                continue;
+            }
+
+            snprintf(buffer, sizeof(buffer), " %zu-%zu", begin, col - 1);
+            out += buffer;
+            append_attributes(out, cells[begin].attributes());
+            out += col < grid.width() ? ";" : "";
+            begin = col;
+        }
+
+        out += '\n';
+    }
+
+    return out;
+}
+
+uint64_t grid_hash(const grid &grid) {
+    // FNV-1a over the same information as grid_dump().
+    uint64_t hash = 14695981039346656037ull;
+
+    auto add = [&](uint64_t value, size_t bytes) {
+        for (size_t i=0; i<bytes; ++i) {
+            hash = (hash ^ ((value >> (i * 8)) & 0xFF)) * 1099511628211ull;
+        }
+    };
+
+    nvim::cursor cursor = grid.cursor();
+    add(grid.width(), 4);
+    add(grid.height(), 4);
+    add(cursor.row(), 4);
+    add(cursor.col(), 4);
+
+    for (const cell &cell : grid) {
+        const cell_attributes &attrs = cell.attributes();
+        std::string_view text = cell.grapheme_view();
+
+        for (char c : text) {
+            add(static_cast<unsigned char>(c), 1);
+        }
+
+        add(0, 1);
+        add(attrs.foreground.rgb(), 3);
+        add(attrs.background.rgb(), 3);
+        add(attrs.special.rgb(), 3);
+        add(attrs.flags, 2);
+    }
+
+    return hash;
+}
+
+headless_ui::headless_ui(flush_record record):
+    record(record),
+    frame_nanoseconds(0),
+    ignored_messages(0),
+    observer_context(nullptr),
+    flush_observer(nullptr) {
+    ui.window = window_controller(nullptr);
+}
+
+void headless_ui::feed(const void *data, size_t size) {
+    unpacker.feed(data, size);
+
+    while (msg::object *object = unpacker.unpack()) {
+        on_message(*object);
+    }
+}
+
+bool headless_ui::feed_file(const char *path) {
+    FILE *file = fopen(path, "rb");
+
+    if (!file) {
+        return false;
+    }
+
+    char buffer[65536];
+
+    while (size_t bytes = fread(buffer, 1, sizeof(buffer), file)) {
+        feed(buffer, bytes);
+    }
+
+    bool success = !ferror(file);
+    fclose(file);
+    return success;
+}
+
+void headless_ui::on_message(const msg::object &object) {
+    // Notifications are of the form: [2, method, args].
+    if (object.is<msg::array>()) {
+        msg::array array = object.get<msg::array>();
+
+        if (array.size() == 3 &&
+            array[0].is<msg::integer>() && array[0].get<msg::integer>() == 2 &&
+            array[1].is<msg::string>() && array[1].get<msg::string>() == "redraw" &&
+            array[2].is<msg::array>()) {
+            return on_redraw(array[2].get<msg::array>());
+        }
+    }
+
+    ignored_messages += 1;
+}
+
+void headless_ui::on_redraw(msg::array redraw_events) {
+    for (msg::object &event : redraw_events) {
+        std::string_view name = "<invalid>";
+
+        if (event.is<msg::array>()) {
+            msg::array array = event.get<msg::array>();
+
+            if (array.size() && array[0].is<msg::string>()) {
+                name = array[0].get<msg::string>();
+            }
+        }
+
+        uint64_t start = now_nanoseconds();
+        ui.redraw(msg::array(&event, 1));
+        uint64_t elapsed = now_nanoseconds() - start;
+
+        auto iter = events.find(name);
+
+        if (iter == events.end()) {
+            iter = events.emplace(name, redraw_timing()).first;
+        }
+
+        iter->second.add(elapsed);
+        frame_nanoseconds += elapsed;
+
+        if (name == "flush") {
+            on_flush();
+        }
+    }
+}
+
+void headless_ui::on_flush() {
+    flush_timing.add(frame_nanoseconds);
+    frame_nanoseconds = 0;
+
+    const grid *grid = ui.get_global_grid();
+
+    if (flush_observer) {
+        flush_observer(observer_context, *grid);
+    }
+
+    if (record == flush_record::none) {
+        return;
+    }
+
+    flush_hashes.push_back(grid_hash(*grid));
+
+    if (record == flush_record::dump) {
+        flush_dumps.push_back(grid_dump(*grid));
+    }
+}
+
+std::string headless_ui::timing_report() const {
+    std::string out;
+    char buffer[256];
+
+    auto append = [&](std::string_view name, const redraw_timing &timing) {
+        snprintf(buffer, sizeof(buffer), "%-20.*s %10zu %12.3f %12.3f %12.3f\n",
+                 (int)std::min<size_t>(name.size(), 20), name.data(), timing.count,
+                 timing.total_nanoseconds / 1e6,
+                 timing.mean_nanoseconds() / 1e3,
+                 timing.max_nanoseconds / 1e3);
+        out += buffer;
+    };
+
+    snprintf(buffer, sizeof(buffer), "%-20s %10s %12s %12s %12s\n",
+             "event", "count", "total (ms)", "mean (us)", "max (us)");
+    out += buffer;
+
+    for (const auto &[name, timing] : events) {
+        append(name, timing);
+    }
+
+    append("<frame>", flush_timing);
+    return out;
+}
+
+} // namespace nvim
@@ -0,0 +1,159 @@
+//
+//  Neovim Mac
+//  headless.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef HEADLESS_HPP
+#define HEADLESS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "msgpack.hpp"
+#include "ui.hpp"
+
+namespace nvim {
+
+/// Returns a text dump of a grid.
+///
+/// The dump starts with a header line containing the grid's size and cursor
+/// position, followed by the text of each row. Empty cells are written as
+/// spaces. The rows are followed by the attributes of each row, as runs of
+/// cells with identical attributes:
+///
+///     row 0: 0-4 fg=ffffff bg=000000 sp=ff0000 bold,undercurl
+///
+/// The format is meant for golden files and diffs, not for parsing.
+std::string grid_dump(const grid &grid);
+
+/// Returns a hash of a grid's size, cursor position, text, and attributes.
+/// Grids with the same dump have the same hash.
+uint64_t grid_hash(const grid &grid);
+
+/// Time spent processing redraw events.
+struct redraw_timing {
+    size_t count = 0;
+    uint64_t total_nanoseconds = 0;
+    uint64_t max_nanoseconds = 0;
+
+    void add(uint64_t nanoseconds) {
+        count += 1;
+        total_nanoseconds += nanoseconds;
+        max_nanoseconds = std::max(max_nanoseconds, nanoseconds);
+    }
+
+    /// The mean time in nanoseconds, or 0 if there have been no events.
+    uint64_t mean_nanoseconds() const {
+        return count ? total_nanoseconds / count : 0;
+    }
+};
+
+/// Drives a ui_controller with recorded msgpack-rpc messages.
+///
+/// Headless UIs are fed the raw bytes Neovim sends to a UI client. Redraw
+/// notifications are passed to the ui_controller, every other message is
+/// ignored. There's no window, the ui_controller's window_controller is a
+/// null controller. Its messages are sent to nil on the main queue, where
+/// they do nothing.
+///
+/// At every flush the global grid is recorded, either as a hash or as a full
+/// grid_dump(). Every redraw event is timed individually, and the time spent
+/// processing each flushed frame, from the first event to the flush event, is
+/// timed separately. Recording isn't included in the timings.
+class headless_ui {
+public:
+    enum class flush_record {
+        none,   ///< Don't record flushed grids.
+        hash,   ///< Record a grid_hash() of flushed grids.
+        dump    ///< Record a grid_dump() and a grid_hash() of flushed grids.
+    };
+
+private:
+    ui_controller ui;
+    msg::unpacker unpacker;
+    flush_record record;
+    std::vector<uint64_t> flush_hashes;
+    std::vector<std::string> flush_dumps;
+    std::map<std::string, redraw_timing, std::less<>> events;
+    redraw_timing flush_timing;
+    uint64_t frame_nanoseconds;
+    size_t ignored_messages;
+    void *observer_context;
+    void (*flush_observer)(void *context, const grid &grid);
+
+    void on_message(const msg::object &object);
+    void on_redraw(msg::array redraw_events);
+    void on_flush();
+
+public:
+    explicit headless_ui(flush_record record = flush_record::hash);
+
+    headless_ui(const headless_ui&) = delete;
+    headless_ui& operator=(const headless_ui&) = delete;
+
+    /// Feeds msgpack-rpc messages to the UI. Messages may be split across
+    /// calls at any byte boundary. The buffer may be freed once feed returns.
+    void feed(const void *data, size_t size);
+
+    /// Feeds the contents of the file at path to the UI.
+    /// @returns True on success, false if the file could not be read.
+    bool feed_file(const char *path);
+
+    /// Calls observer with the global grid at every flush. Observers can
+    /// collect stats over a replayed session without recording every grid.
+    void set_flush_observer(void *context,
+                            void (*observer)(void *context, const grid &grid)) {
+        observer_context = context;
+        flush_observer = observer;
+    }
+
+    /// The underlying UI controller.
+    ui_controller& controller() {
+        return ui;
+    }
+
+    /// The number of flushes processed.
+    size_t flush_count() const {
+        return flush_timing.count;
+    }
+
+    /// The hashes of flushed grids, in order. Empty if flushes aren't recorded.
+    const std::vector<uint64_t>& hashes() const {
+        return flush_hashes;
+    }
+
+    /// The dumps of flushed grids, in order. Only recorded by flush_record::dump.
+    const std::vector<std::string>& dumps() const {
+        return flush_dumps;
+    }
+
+    /// Timings of each redraw event type, keyed by event name.
+    const std::map<std::string, redraw_timing, std::less<>>& event_timings() const {
+        return events;
+    }
+
+    /// Timings of flushed frames.
+    const redraw_timing& flush_timings() const {
+        return flush_timing;
+    }
+
+    /// The number of messages that were not redraw notifications.
+    size_t ignored_count() const {
+        return ignored_messages;
+    }
+
+    /// Returns a human readable table of the event and flush timings.
+    std::string timing_report() const;
+};
+
+} // namespace nvim
+
+#endif // HEADLESS_HPP
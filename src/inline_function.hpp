@@ -0,0 +1,138 @@
+//
+//  Neovim Mac
+//  inline_function.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef INLINE_FUNCTION_HPP
+#define INLINE_FUNCTION_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace nvim {
+
+template<typename Signature, size_t Capacity = 6 * sizeof(void*)>
+class inline_function;
+
+/// A move only std::function that never allocates.
+///
+/// The callable is stored inside the inline_function itself. Callables larger
+/// than Capacity bytes are rejected at compile time, rather than being moved
+/// to the heap. Capture pointers or references to larger state instead.
+template<typename R, typename ...Args, size_t Capacity>
+class inline_function<R(Args...), Capacity> {
+private:
+    struct operations {
+        R (*invoke)(void *storage, Args ...args);
+        void (*relocate)(void *from, void *to);
+        void (*destroy)(void *storage);
+    };
+
+    template<typename T>
+    static constexpr operations operations_for = {
+        [](void *storage, Args ...args) -> R {
+            return (*static_cast<T*>(storage))(std::forward<Args>(args)...);
+        },
+        [](void *from, void *to) {
+            T *callable = static_cast<T*>(from);
+            new (to) T(std::move(*callable));
+            callable->~T();
+        },
+        [](void *storage) {
+            static_cast<T*>(storage)->~T();
+        }
+    };
+
+    alignas(std::max_align_t) unsigned char storage[Capacity];
+    const operations *ops;
+
+    [[noreturn]] static void empty_call() {
+        fputs("Called an empty inline_function\n", stderr);
+        abort();
+    }
+
+    void move_from(inline_function &other) {
+        ops = other.ops;
+
+        if (ops) {
+            ops->relocate(other.storage, storage);
+            other.ops = nullptr;
+        }
+    }
+
+public:
+    inline_function(): ops(nullptr) {}
+    inline_function(std::nullptr_t): ops(nullptr) {}
+
+    template<typename F, typename T = std::decay_t<F>,
+             typename = std::enable_if_t<!std::is_same_v<T, inline_function>>>
+    inline_function(F &&callable) {
+        static_assert(sizeof(T) <= Capacity,
+                      "Callable is too large for inline_function");
+        static_assert(alignof(T) <= alignof(std::max_align_t),
+                      "Callable is over aligned for inline_function");
+
+        new (storage) T(std::forward<F>(callable));
+        ops = &operations_for<T>;
+    }
+
+    inline_function(inline_function &&other) {
+        move_from(other);
+    }
+
+    inline_function& operator=(inline_function &&other) {
+        if (this != &other) {
+            reset();
+            move_from(other);
+        }
+
+        return *this;
+    }
+
+    inline_function& operator=(std::nullptr_t) {
+        reset();
+        return *this;
+    }
+
+    inline_function(const inline_function&) = delete;
+    inline_function& operator=(const inline_function&) = delete;
+
+    ~inline_function() {
+        reset();
+    }
+
+    /// Destroys the stored callable, releasing anything it captured.
+    void reset() {
+        if (ops) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+    explicit operator bool() const {
+        return ops != nullptr;
+    }
+
+    /// Calls the stored callable. Calling an empty inline_function aborts,
+    /// where std::function would throw std::bad_function_call, as we're built
+    /// without exceptions.
+    R operator()(Args ...args) {
+        if (!ops) [[unlikely]] {
+            empty_call();
+        }
+
+        return ops->invoke(storage, std::forward<Args>(args)...);
+    }
+};
+
+} // namespace nvim
+
+#endif // INLINE_FUNCTION_HPP
@@ -0,0 +1,199 @@
+//
+//  Neovim Mac
+//  io_loop.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+// The libdispatch backend. See io_loop_epoll.cpp for the Linux backend.
+#if defined(__APPLE__)
+
+#include <mach/mach_time.h>
+#include <mutex>
+
+#include "io_loop.hpp"
+
+namespace nvim {
+
+io_time io_time_after(uint64_t nanoseconds) {
+    return dispatch_time(DISPATCH_TIME_NOW, nanoseconds);
+}
+
+/// Returns a millisecond in dispatch_time_t units, which are mach absolute
+/// time units.
+static uint64_t millisecond() {
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    return NSEC_PER_MSEC * timebase.denom / timebase.numer;
+}
+
+io_loop::io_loop(): timeouts(millisecond()) {
+    writes = write_state::suspended;
+    armed_deadline = DISPATCH_TIME_FOREVER;
+    queue = nullptr;
+    read_source = nullptr;
+    write_source = nullptr;
+    timeout_source = nullptr;
+}
+
+io_loop::~io_loop() {
+    if (!queue) return;
+
+    // Run pending timeouts now, their owners are waiting for them.
+    dispatch_source_cancel(timeout_source);
+
+    dispatch_sync_f(queue, this, [](void *context) {
+        static_cast<io_loop*>(context)->run_timeouts(true);
+    });
+
+    dispatch_release(read_source);
+    dispatch_release(write_source);
+    dispatch_release(timeout_source);
+    dispatch_release(queue);
+}
+
+int io_loop::open(int readfd, int writefd, const io_handlers &handlers) {
+    this->handlers = handlers;
+    queue = dispatch_queue_create(nullptr, DISPATCH_QUEUE_SERIAL);
+
+    read_source = dispatch_source_create(
+        DISPATCH_SOURCE_TYPE_READ, readfd, 0, queue);
+
+    write_source = dispatch_source_create(
+        DISPATCH_SOURCE_TYPE_WRITE, writefd, 0, queue);
+
+    dispatch_set_context(read_source, this);
+    dispatch_set_context(write_source, this);
+
+    dispatch_source_set_event_handler_f(read_source, [](void *context) {
+        io_loop *loop = static_cast<io_loop*>(context);
+        loop->handlers.can_read(loop->handlers.context);
+    });
+
+    dispatch_source_set_event_handler_f(write_source, [](void *context) {
+        io_loop *loop = static_cast<io_loop*>(context);
+        loop->handlers.can_write(loop->handlers.context);
+    });
+
+    dispatch_source_set_cancel_handler_f(read_source, [](void *context) {
+        io_loop *loop = static_cast<io_loop*>(context);
+        loop->handlers.cancelled(loop->handlers.context);
+    });
+
+    dispatch_source_set_cancel_handler_f(write_source, [](void *context) {
+        io_loop *loop = static_cast<io_loop*>(context);
+        dispatch_source_cancel(loop->read_source);
+    });
+
+    timeout_source = dispatch_source_create(
+        DISPATCH_SOURCE_TYPE_TIMER, 0, 0, queue);
+
+    dispatch_set_context(timeout_source, this);
+
+    dispatch_source_set_event_handler_f(timeout_source, [](void *context) {
+        static_cast<io_loop*>(context)->run_timeouts(false);
+    });
+
+    dispatch_source_set_timer(timeout_source, DISPATCH_TIME_FOREVER,
+                              DISPATCH_TIME_FOREVER, 0);
+
+    dispatch_resume(read_source);
+    dispatch_resume(timeout_source);
+    writes = write_state::suspended;
+    return 0;
+}
+
+bool io_loop::is_open() const {
+    return queue != nullptr;
+}
+
+void io_loop::resume_writes() {
+    if (writes == write_state::suspended) {
+        dispatch_resume(write_source);
+        writes = write_state::resumed;
+    }
+}
+
+void io_loop::suspend_writes() {
+    if (writes == write_state::resumed) {
+        dispatch_suspend(write_source);
+        writes = write_state::suspended;
+    }
+}
+
+void io_loop::cancel() {
+    // The read source is cancelled by write_source's cancellation handler.
+    // Read source's cancellation handler will in turn call the cancelled
+    // handler. Suspended sources must be resumed before they're cancelled.
+    if (writes != write_state::cancelled) {
+        if (writes == write_state::suspended) {
+            dispatch_resume(write_source);
+        }
+
+        dispatch_source_cancel(write_source);
+        writes = write_state::cancelled;
+    }
+}
+
+void io_loop::async(void *context, io_function function) {
+    dispatch_async_f(queue, context, function);
+}
+
+void io_loop::sync(void *context, io_function function) {
+    dispatch_sync_f(queue, context, function);
+}
+
+void io_loop::add_timeout(wheel_timer *timer, io_time deadline) {
+    std::lock_guard lock(timeout_lock);
+
+    // An empty wheel may have fallen behind, catch it up before adding.
+    if (!timeouts.size()) {
+        timeouts.advance(dispatch_time(DISPATCH_TIME_NOW, 0));
+    }
+
+    timeouts.add(timer, deadline);
+    io_time next = timeouts.next_deadline();
+
+    if (next < armed_deadline) {
+        armed_deadline = next;
+        dispatch_source_set_timer(timeout_source, next, DISPATCH_TIME_FOREVER, 0);
+    }
+}
+
+void io_loop::remove_timeout(wheel_timer *timer) {
+    std::lock_guard lock(timeout_lock);
+    timeouts.remove(timer);
+}
+
+/// Runs expired timeouts, or every timeout if all is true.
+void io_loop::run_timeouts(bool all) {
+    wheel_timer *expired;
+
+    {
+        std::lock_guard lock(timeout_lock);
+        expired = all ? timeouts.clear() : timeouts.advance(dispatch_time(DISPATCH_TIME_NOW, 0));
+        armed_deadline = timeouts.next_deadline();
+
+        if (!all) {
+            dispatch_source_set_timer(timeout_source, armed_deadline,
+                                      DISPATCH_TIME_FOREVER, 0);
+        }
+    }
+
+    while (expired) {
+        wheel_timer *next = expired->next;
+        expired->function(expired->context);
+        expired = next;
+    }
+}
+
+void io_loop::set_finalizer(void *context, io_function function) {
+    dispatch_set_context(queue, context);
+    dispatch_set_finalizer_f(queue, function);
+}
+
+} // namespace nvim
+
+#endif // __APPLE__
@@ -0,0 +1,188 @@
+//
+//  Neovim Mac
+//  io_loop.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef IO_LOOP_HPP
+#define IO_LOOP_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include "timer_wheel.hpp"
+
+#if defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#include "unfair_lock.hpp"
+#else
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+namespace nvim {
+
+#if defined(__APPLE__)
+/// A point in time. On Apple platforms, a dispatch_time_t.
+using io_time = dispatch_time_t;
+#else
+/// A point in time, in CLOCK_MONOTONIC nanoseconds.
+using io_time = uint64_t;
+#endif
+
+/// A deadline that never passes. Equal to DISPATCH_TIME_FOREVER.
+inline constexpr io_time io_time_forever = UINT64_MAX;
+
+/// Returns the time nanoseconds from now.
+io_time io_time_after(uint64_t nanoseconds);
+
+/// A function called on an io_loop.
+using io_function = void (*)(void *context);
+
+/// Callbacks made by an io_loop. All callbacks are made on the loop.
+struct io_handlers {
+    void *context;
+
+    /// Called when the read file descriptor is readable, or has hit EOF.
+    io_function can_read;
+
+    /// Called when the write file descriptor is writable, while writes are
+    /// resumed.
+    io_function can_write;
+
+    /// Called once after cancel(). No read or write callbacks follow it.
+    io_function cancelled;
+};
+
+/// The event loop that drives a pair of file descriptors.
+///
+/// All callbacks, asynchronous functions and timeouts run serially on the
+/// loop. There are two backends:
+///
+///  - libdispatch (macOS): A serial dispatch queue with read and write
+///    dispatch sources, which libdispatch implements with kqueue. Timeouts
+///    use a single dispatch timer source.
+///
+///  - epoll (Linux): A dedicated thread waiting on an epoll instance. Work
+///    submitted from other threads wakes the loop with an eventfd, timeouts
+///    use a single timerfd armed for the earliest deadline.
+///
+/// Timeouts are kept in a timer wheel, which wakes the loop once for the next
+/// due timeout, rather than having a kernel timer per timeout.
+///
+/// Both backends are level triggered. Read handlers may read as much or as
+/// little as they like, they're called again while data remains.
+///
+/// An opened loop must be cancelled before it's destroyed.
+class io_loop {
+private:
+    /// Tracks the state of the write source.
+    enum class write_state {
+        resumed,
+        suspended,
+        cancelled
+    };
+
+    io_handlers handlers;
+    std::atomic<write_state> writes;
+    timer_wheel timeouts;
+    io_time armed_deadline;
+
+#if defined(__APPLE__)
+    dispatch_queue_t queue;
+    dispatch_source_t read_source;
+    dispatch_source_t write_source;
+    dispatch_source_t timeout_source;
+    unfair_lock timeout_lock;
+
+    void run_timeouts(bool all);
+#else
+    struct task {
+        void *context;
+        io_function function;
+    };
+
+    int read_fd;
+    int write_fd;
+    int epoll_fd;
+    int event_fd;
+    int timer_fd;
+    std::thread thread;
+    std::mutex lock;
+    std::vector<task> tasks;
+    task finalizer;
+    bool stopping;
+
+    void run();
+    void wake();
+    void run_tasks();
+    void run_timeouts(bool all);
+    void arm_timer();
+    void update_write_events(bool enabled);
+#endif
+
+public:
+    io_loop();
+    ~io_loop();
+
+    io_loop(const io_loop&) = delete;
+    io_loop& operator=(const io_loop&) = delete;
+
+    /// Starts the loop. Reads are resumed immediately, writes are suspended.
+    /// Note: This function should only be called once.
+    /// @returns An errno code if an error occurred, 0 if no error occurred.
+    int open(int readfd, int writefd, const io_handlers &handlers);
+
+    /// Returns true if open() succeeded.
+    bool is_open() const;
+
+    /// Returns true if cancel() has been called.
+    bool is_cancelled() const {
+        return writes == write_state::cancelled;
+    }
+
+    /// Starts making can_write callbacks. Does nothing if writes are resumed
+    /// or cancelled. Calls to resume_writes() and suspend_writes() must be
+    /// serialized by the caller.
+    void resume_writes();
+
+    /// Stops making can_write callbacks. Does nothing if writes are suspended
+    /// or cancelled.
+    void suspend_writes();
+
+    /// Stops all read and write callbacks, then calls the cancelled handler.
+    /// Asynchronous functions and timeouts continue to run.
+    /// Note: Must be called on the loop.
+    void cancel();
+
+    /// Calls function on the loop and returns immediately.
+    void async(void *context, io_function function);
+
+    /// Calls function on the loop and waits for it to return.
+    /// Note: Must not be called on the loop.
+    void sync(void *context, io_function function);
+
+    /// Calls timer->function(timer->context) on the loop once deadline has
+    /// passed, unless the timeout is removed first. Timeouts are kept in a
+    /// timer wheel with millisecond ticks, and due timeouts run in a batch.
+    /// They never run early, and run at most a tick late. Pending timeouts run
+    /// when the loop is destroyed.
+    /// Note: The timer must stay alive until it runs or is removed.
+    void add_timeout(wheel_timer *timer, io_time deadline);
+
+    /// Removes a pending timeout. Does nothing if the timeout has run.
+    /// Note: Must be called on the loop.
+    void remove_timeout(wheel_timer *timer);
+
+    /// Sets a function to call once the loop is destroyed and all pending
+    /// work has finished. Must be called after open().
+    void set_finalizer(void *context, io_function function);
+};
+
+} // namespace nvim
+
+#endif // IO_LOOP_HPP
@@ -0,0 +1,341 @@
+//
+//  Neovim Mac
+//  io_loop_epoll.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+// The epoll backend. See io_loop.cpp for the libdispatch backend.
+#if defined(__linux__)
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <ctime>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "io_loop.hpp"
+
+namespace nvim {
+
+// Tags stored in epoll_event data, identifying the file descriptor.
+static constexpr uint32_t event_tag = 0;
+static constexpr uint32_t timer_tag = 1;
+static constexpr uint32_t read_tag = 2;
+static constexpr uint32_t write_tag = 3;
+
+static constexpr uint64_t nsec_per_sec = 1000000000;
+static constexpr uint64_t nsec_per_msec = 1000000;
+
+static io_time monotonic_now() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (io_time)now.tv_sec * nsec_per_sec + now.tv_nsec;
+}
+
+io_time io_time_after(uint64_t nanoseconds) {
+    return monotonic_now() + nanoseconds;
+}
+
+io_loop::io_loop(): timeouts(nsec_per_msec) {
+    writes = write_state::suspended;
+    armed_deadline = io_time_forever;
+    read_fd = -1;
+    write_fd = -1;
+    epoll_fd = -1;
+    event_fd = -1;
+    timer_fd = -1;
+    finalizer = {nullptr, nullptr};
+    stopping = false;
+}
+
+io_loop::~io_loop() {
+    if (!thread.joinable()) return;
+
+    {
+        std::lock_guard guard(lock);
+        stopping = true;
+    }
+
+    wake();
+    thread.join();
+
+    close(epoll_fd);
+    close(event_fd);
+    close(timer_fd);
+}
+
+int io_loop::open(int readfd, int writefd, const io_handlers &handlers) {
+    this->handlers = handlers;
+    read_fd = readfd;
+    write_fd = writefd;
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+
+    auto add = [this](int fd, uint32_t events, uint32_t tag) {
+        epoll_event event = {};
+        event.events = events;
+        event.data.u32 = tag;
+        return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    };
+
+    if (epoll_fd == -1 || event_fd == -1 || timer_fd == -1 ||
+        add(event_fd, EPOLLIN, event_tag) ||
+        add(timer_fd, EPOLLIN, timer_tag) ||
+        add(read_fd, EPOLLIN, read_tag)) {
+        int error = errno;
+        if (epoll_fd != -1) close(epoll_fd);
+        if (event_fd != -1) close(event_fd);
+        if (timer_fd != -1) close(timer_fd);
+        return error;
+    }
+
+    writes = write_state::suspended;
+    thread = std::thread([this] { run(); });
+    return 0;
+}
+
+bool io_loop::is_open() const {
+    return thread.joinable();
+}
+
+/// Adds or removes EPOLLOUT interest in the write file descriptor. If the
+/// read and write file descriptors are the same, we have a single
+/// registration, so we modify its event mask instead.
+void io_loop::update_write_events(bool enabled) {
+    epoll_event event = {};
+
+    if (read_fd == write_fd) {
+        event.events = EPOLLIN | (enabled ? EPOLLOUT : 0);
+        event.data.u32 = read_tag;
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, write_fd, &event);
+    } else if (enabled) {
+        event.events = EPOLLOUT;
+        event.data.u32 = write_tag;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, write_fd, &event);
+    } else {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, write_fd, &event);
+    }
+}
+
+void io_loop::resume_writes() {
+    if (writes == write_state::suspended) {
+        update_write_events(true);
+        writes = write_state::resumed;
+    }
+}
+
+void io_loop::suspend_writes() {
+    if (writes == write_state::resumed) {
+        update_write_events(false);
+        writes = write_state::suspended;
+    }
+}
+
+void io_loop::cancel() {
+    if (writes == write_state::cancelled) {
+        return;
+    }
+
+    if (writes == write_state::resumed) {
+        update_write_events(false);
+    }
+
+    epoll_event event = {};
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, read_fd, &event);
+    writes = write_state::cancelled;
+
+    // Like dispatch source cancellation handlers, the cancelled handler runs
+    // after the current callback returns.
+    async(this, [](void *context) {
+        io_loop *loop = static_cast<io_loop*>(context);
+        loop->handlers.cancelled(loop->handlers.context);
+    });
+}
+
+void io_loop::wake() {
+    uint64_t one = 1;
+    write(event_fd, &one, sizeof(one));
+}
+
+void io_loop::async(void *context, io_function function) {
+    {
+        std::lock_guard guard(lock);
+        tasks.push_back({context, function});
+    }
+
+    wake();
+}
+
+void io_loop::sync(void *context, io_function function) {
+    struct sync_context {
+        void *context;
+        io_function function;
+        std::mutex lock;
+        std::condition_variable condition;
+        bool done;
+    };
+
+    sync_context sync = {context, function};
+    sync.done = false;
+
+    async(&sync, [](void *ptr) {
+        sync_context *sync = static_cast<sync_context*>(ptr);
+        sync->function(sync->context);
+
+        std::lock_guard guard(sync->lock);
+        sync->done = true;
+        sync->condition.notify_one();
+    });
+
+    std::unique_lock guard(sync.lock);
+    sync.condition.wait(guard, [&sync] { return sync.done; });
+}
+
+/// Arms the timerfd for the earliest timeout deadline. Must be called with
+/// lock held.
+void io_loop::arm_timer() {
+    itimerspec spec = {};
+    io_time deadline = timeouts.next_deadline();
+
+    if (deadline != io_time_forever) {
+        // A zero it_value disarms the timer, deadlines in the past are clamped
+        // to the earliest representable time instead.
+        io_time clamped = std::max<io_time>(deadline, 1);
+        spec.it_value.tv_sec = clamped / nsec_per_sec;
+        spec.it_value.tv_nsec = clamped % nsec_per_sec;
+    }
+
+    armed_deadline = deadline;
+    timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+void io_loop::add_timeout(wheel_timer *timer, io_time deadline) {
+    std::lock_guard guard(lock);
+
+    // An empty wheel may have fallen behind, catch it up before adding.
+    if (!timeouts.size()) {
+        timeouts.advance(monotonic_now());
+    }
+
+    timeouts.add(timer, deadline);
+
+    if (timeouts.next_deadline() < armed_deadline) {
+        arm_timer();
+    }
+}
+
+void io_loop::remove_timeout(wheel_timer *timer) {
+    std::lock_guard guard(lock);
+    timeouts.remove(timer);
+}
+
+void io_loop::set_finalizer(void *context, io_function function) {
+    finalizer = {context, function};
+}
+
+void io_loop::run_tasks() {
+    std::vector<task> pending;
+
+    {
+        std::lock_guard guard(lock);
+        pending.swap(tasks);
+    }
+
+    for (const task &task : pending) {
+        task.function(task.context);
+    }
+}
+
+/// Runs expired timeouts, or every timeout if all is true.
+void io_loop::run_timeouts(bool all) {
+    wheel_timer *expired;
+
+    {
+        std::lock_guard guard(lock);
+        expired = all ? timeouts.clear() : timeouts.advance(monotonic_now());
+        arm_timer();
+    }
+
+    while (expired) {
+        wheel_timer *next = expired->next;
+        expired->function(expired->context);
+        expired = next;
+    }
+}
+
+void io_loop::run() {
+    for (;;) {
+        epoll_event events[16];
+        int count = epoll_wait(epoll_fd, events, 16, -1);
+
+        if (count == -1) {
+            if (errno == EINTR) continue;
+            std::abort();
+        }
+
+        for (int i=0; i<count; ++i) {
+            uint32_t tag = events[i].data.u32;
+            uint32_t flags = events[i].events;
+
+            if (tag == event_tag) {
+                uint64_t value;
+                read(event_fd, &value, sizeof(value));
+                run_tasks();
+            } else if (tag == timer_tag) {
+                uint64_t expirations;
+                read(timer_fd, &expirations, sizeof(expirations));
+                run_timeouts(false);
+            } else {
+                // Hangups and errors are reported to the read handler, which
+                // sees them as EOF or a failed read.
+                bool readable = tag == read_tag && (flags & (EPOLLIN | EPOLLHUP | EPOLLERR));
+                bool writable = flags & (tag == write_tag ? (EPOLLOUT | EPOLLERR) : EPOLLOUT);
+
+                if (readable && writes != write_state::cancelled) {
+                    handlers.can_read(handlers.context);
+                }
+
+                if (writable && writes == write_state::resumed) {
+                    handlers.can_write(handlers.context);
+                }
+            }
+        }
+
+        std::unique_lock guard(lock);
+
+        if (stopping) {
+            guard.unlock();
+            break;
+        }
+    }
+
+    // Drain remaining work. Tasks may schedule more tasks, so loop until
+    // there's nothing left.
+    for (;;) {
+        run_tasks();
+        run_timeouts(true);
+
+        std::lock_guard guard(lock);
+
+        if (tasks.empty() && !timeouts.size()) {
+            break;
+        }
+    }
+
+    if (finalizer.function) {
+        finalizer.function(finalizer.context);
+    }
+}
+
+} // namespace nvim
+
+#endif // __linux__
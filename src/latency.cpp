@@ -0,0 +1,121 @@
+//
+//  Neovim Mac
+//  latency.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+
+#include "latency.hpp"
+
+namespace nvim {
+
+uint64_t latency_histogram::percentile(double percentile) const {
+    if (!total_count) {
+        return 0;
+    }
+
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    uint64_t target = std::ceil((percentile / 100.0) * total_count);
+    target = std::max<uint64_t>(target, 1);
+
+    uint64_t seen = 0;
+
+    for (size_t i=0; i<bucket_count; ++i) {
+        seen += buckets[i];
+
+        if (seen >= target) {
+            return std::clamp(bucket_max(i), min_value, max_value);
+        }
+    }
+
+    return max_value;
+}
+
+std::string latency_histogram::summary() const {
+    auto ms = [](uint64_t nanoseconds) {
+        return nanoseconds / 1e6;
+    };
+
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer),
+             "count=%llu min=%.2f p50=%.2f p90=%.2f p99=%.2f p99.9=%.2f max=%.2f mean=%.2f",
+             static_cast<unsigned long long>(total_count), ms(min()),
+             ms(percentile(50)), ms(percentile(90)), ms(percentile(99)),
+             ms(percentile(99.9)), ms(max()), ms(mean()));
+
+    return buffer;
+}
+
+void latency_tracker::input(uint64_t now) {
+    std::lock_guard guard(lock);
+
+    if (!pending_input) {
+        pending_input = now;
+    }
+}
+
+void latency_tracker::flush(uint64_t tick, uint64_t now) {
+    std::lock_guard guard(lock);
+
+    if (!pending_input) {
+        return;
+    }
+
+    input_to_flush.record(now - pending_input);
+
+    // If an earlier flush hasn't been presented yet, the earlier input is
+    // still waiting on screen. Keep it, it will be presented with this tick.
+    if (!flushed_input) {
+        flushed_input = pending_input;
+    }
+
+    flushed_tick = tick;
+    pending_input = 0;
+}
+
+void latency_tracker::present(uint64_t tick, uint64_t now) {
+    std::lock_guard guard(lock);
+
+    if (!flushed_input || tick < flushed_tick) {
+        return;
+    }
+
+    input_to_present.record(now - flushed_input);
+    flushed_input = 0;
+}
+
+latency_histogram latency_tracker::flush_latency() {
+    std::lock_guard guard(lock);
+    return input_to_flush;
+}
+
+latency_histogram latency_tracker::present_latency() {
+    std::lock_guard guard(lock);
+    return input_to_present;
+}
+
+void latency_tracker::reset() {
+    std::lock_guard guard(lock);
+    input_to_flush.reset();
+    input_to_present.reset();
+    pending_input = 0;
+    flushed_input = 0;
+    flushed_tick = 0;
+}
+
+std::string latency_tracker::report() {
+    latency_histogram flush = flush_latency();
+    latency_histogram present = present_latency();
+
+    return "Keypress latency (ms)\n"
+           "  input to flush:   " + flush.summary() + "\n"
+           "  input to present: " + present.summary() + "\n";
+}
+
+} // namespace nvim
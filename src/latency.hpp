@@ -0,0 +1,183 @@
+//
+//  Neovim Mac
+//  latency.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef LATENCY_HPP
+#define LATENCY_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace nvim {
+
+/// Returns the current time in nanoseconds, from a monotonic clock.
+inline uint64_t latency_clock() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+/// A log linear histogram, in the style of HdrHistogram.
+///
+/// Values are grouped into buckets by their power of two, and each power of
+/// two is divided into 32 linear sub buckets. Any 64 bit value can be recorded,
+/// the relative error of a bucketed value is at most 1/32 (~3%). Recording is
+/// constant time and the histogram never allocates.
+class latency_histogram {
+private:
+    static constexpr int sub_bucket_bits = 5;
+    static constexpr uint64_t sub_bucket_count = 1 << sub_bucket_bits;
+    static constexpr size_t bucket_count = (64 - sub_bucket_bits + 1) * sub_bucket_count;
+
+    std::array<uint64_t, bucket_count> buckets;
+    uint64_t total_count;
+    uint64_t total_sum;
+    uint64_t min_value;
+    uint64_t max_value;
+
+    static size_t bucket_index(uint64_t value) {
+        if (value < sub_bucket_count) {
+            return value;
+        }
+
+        int shift = std::bit_width(value) - 1 - sub_bucket_bits;
+        return ((shift + 1) << sub_bucket_bits) + (value >> shift) - sub_bucket_count;
+    }
+
+    /// The largest value that falls into the bucket at index.
+    static uint64_t bucket_max(size_t index) {
+        if (index < sub_bucket_count) {
+            return index;
+        }
+
+        int shift = (index >> sub_bucket_bits) - 1;
+        uint64_t sub_bucket = (index & (sub_bucket_count - 1)) + sub_bucket_count;
+        return (sub_bucket << shift) + ((uint64_t(1) << shift) - 1);
+    }
+
+public:
+    latency_histogram() {
+        reset();
+    }
+
+    /// Removes all recorded values.
+    void reset() {
+        buckets.fill(0);
+        total_count = 0;
+        total_sum = 0;
+        min_value = UINT64_MAX;
+        max_value = 0;
+    }
+
+    /// Records a value.
+    void record(uint64_t value) {
+        buckets[bucket_index(value)] += 1;
+        total_count += 1;
+        total_sum += value;
+        min_value = std::min(min_value, value);
+        max_value = std::max(max_value, value);
+    }
+
+    /// The number of recorded values.
+    uint64_t count() const {
+        return total_count;
+    }
+
+    /// The smallest recorded value, or 0 if the histogram is empty.
+    uint64_t min() const {
+        return total_count ? min_value : 0;
+    }
+
+    /// The largest recorded value, or 0 if the histogram is empty.
+    uint64_t max() const {
+        return max_value;
+    }
+
+    /// The mean of recorded values, or 0 if the histogram is empty.
+    uint64_t mean() const {
+        return total_count ? total_sum / total_count : 0;
+    }
+
+    /// Returns the value at the given percentile.
+    ///
+    /// The result is the largest value equivalent to the bucket containing the
+    /// percentile, clamped to the recorded range. It's an upper bound, within
+    /// the histogram's precision. Returns 0 if the histogram is empty.
+    ///
+    /// @param percentile A percentile in the range [0, 100].
+    uint64_t percentile(double percentile) const;
+
+    /// Returns a one line summary of the histogram. Values are assumed to be
+    /// nanoseconds and are printed in milliseconds.
+    std::string summary() const;
+};
+
+/// Measures keypress to pixel latency.
+///
+/// Input events are correlated with the next flush, and the flushed grid with
+/// the next frame that presents it:
+///
+///   1. input() is called when user input is sent to Neovim.
+///   2. flush() is called when the UI processes a flush event.
+///   3. present() is called when a frame showing a flushed grid is presented.
+///
+/// If several inputs are sent before a flush, the latency is measured from the
+/// earliest one. This is the latency the user perceives, as no input has been
+/// reflected on screen until then.
+///
+/// Latency trackers are thread safe. Input, flush and present are usually
+/// called from different threads.
+class latency_tracker {
+private:
+    std::mutex lock;
+    latency_histogram input_to_flush;
+    latency_histogram input_to_present;
+    uint64_t pending_input;
+    uint64_t flushed_input;
+    uint64_t flushed_tick;
+
+public:
+    latency_tracker():
+        pending_input(0),
+        flushed_input(0),
+        flushed_tick(0) {}
+
+    latency_tracker(const latency_tracker&) = delete;
+    latency_tracker& operator=(const latency_tracker&) = delete;
+
+    /// Called when input is sent to Neovim.
+    void input(uint64_t now = latency_clock());
+
+    /// Called when a flush is processed.
+    /// @param tick The draw tick of the flushed grid. See grid::tick().
+    void flush(uint64_t tick, uint64_t now = latency_clock());
+
+    /// Called when a frame is presented.
+    /// @param tick The draw tick of the presented grid. See grid::tick().
+    void present(uint64_t tick, uint64_t now = latency_clock());
+
+    /// Returns a copy of the input to flush histogram.
+    latency_histogram flush_latency();
+
+    /// Returns a copy of the input to present histogram.
+    latency_histogram present_latency();
+
+    /// Clears the histograms and any pending measurements.
+    void reset();
+
+    /// Returns a human readable report of the histograms.
+    std::string report();
+};
+
+} // namespace nvim
+
+#endif // LATENCY_HPP
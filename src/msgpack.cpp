@@ -520,6 +520,11 @@ unpack_object: // Label avoids excess indentation
                 break;
             }
 
+            if (const char *data = promise.read_in_place(length)) {
+                obj->emplace<string>(data, length);
+                break;
+            }
+
             auto *data = new (allocator) char[length];
             obj->emplace<string>(data, length);
             co_await promise.read_bytes(data, length);
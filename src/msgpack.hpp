@@ -14,8 +14,11 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <optional>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <variant>
 #include <vector>
 #include <coroutine>
@@ -330,6 +333,7 @@ public:
     // @field length    Size of the input buffer.
     // @field waitbuff  Pointer to the destination of an outstanding copy.
     // @field waitlen   Size of the outstanding copy.
+    // @field in_place  True if strings may refer to the input buffer.
     class promise_type {
     private:
         object *obj;
@@ -337,13 +341,15 @@ public:
         size_t length;
         char *waitbuff;
         size_t waitlen;
+        bool in_place;
 
         promise_type():
             obj(nullptr),
             buffer(nullptr),
             length(0),
             waitbuff(nullptr),
-            waitlen(0) {}
+            waitlen(0),
+            in_place(false) {}
 
         unpacker get_return_object() noexcept {
             return unpacker(this, handle_type::from_promise(*this));
@@ -395,6 +401,18 @@ public:
 
         auto read_bytes(void *dest, size_t size);
 
+        // If the input buffer was fed in place and holds at least size bytes,
+        // returns a pointer to them and skips over them. Otherwise returns
+        // nullptr, and the bytes must be copied with read_bytes.
+        const char* read_in_place(size_t size) {
+            if (!in_place || length < size) return nullptr;
+
+            const char *data = buffer;
+            buffer += size;
+            length -= size;
+            return data;
+        }
+
         template<typename T>
         auto read_numeric();
 
@@ -449,6 +467,27 @@ public:
         assert(!promise->length && "Not completely unpacked");
         promise->buffer = static_cast<const char*>(buffer);
         promise->length = length;
+        promise->in_place = false;
+    }
+
+    /// Feed an input buffer that the unpacked objects may refer to. Rather
+    /// than being copied, strings refer directly to the input buffer.
+    ///
+    /// Objects span input buffers, so the caller must keep the bytes of an
+    /// object alive, at the same address, until the object has been unpacked.
+    /// Bytes preceding the last remaining() bytes of the input buffer at the
+    /// time an object is unpacked are no longer referenced once that object
+    /// is invalidated.
+    void feed_in_place(const void *buffer, size_t length) {
+        feed(buffer, length);
+        promise->in_place = true;
+    }
+
+    /// @returns The number of bytes of the input buffer not yet unpacked.
+    ///          Following a successful call to unpack(), these are the bytes
+    ///          after the end of the unpacked object.
+    size_t remaining() const {
+        return promise->length;
     }
 
     /// Unpacks any data that was previously fed to the unpacker.
@@ -523,9 +562,8 @@ private:
     static constexpr unsigned char first_byte() {
         static_assert(std::is_arithmetic_v<T>, "Numeric types only");
 
-        constexpr int offsets[] = {
-            [1] = 0, [2] = 1, [4] = 2, [8] = 3
-        };
+        // Indexed by sizeof(T): 1, 2, 4 and 8 byte types map to 0, 1, 2 and 3.
+        constexpr int offsets[] = {0, 0, 1, 0, 2, 0, 0, 0, 3};
 
         if (std::is_floating_point_v<T>) {
             return 0xca + offsets[sizeof(T)] - 2;
@@ -577,6 +615,17 @@ public:
         return buffer.size();
     }
 
+    /// Returns the capacity of the underlying buffer.
+    size_t capacity() const {
+        return buffer.capacity();
+    }
+
+    /// Decrease the capacity of the underlying buffer, see
+    /// circular_buffer::shrink.
+    void shrink(size_t new_capacity) {
+        buffer.shrink(new_capacity);
+    }
+
     /// Returns a pointer to the byte stream. Valid up to data() + size().
     const char* data() const {
         return buffer.data();
@@ -614,6 +663,12 @@ public:
         buffer.clear();
     }
 
+    /// Appends size bytes of already packed data.
+    /// Note: The data must be complete MessagePack objects.
+    void append(const void *data, size_t size) {
+        buffer.insert(data, size);
+    }
+
     /// Explicitly pack a numeric value as PackType. This function does not
     /// optimize for the number of bytes it produces - it will always produce
     /// sizeof(T) + 1 bytes. This avoids some overhead.
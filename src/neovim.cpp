@@ -8,8 +8,10 @@
 //
 
 #include <unistd.h>
+#include <limits.h>
 #include <spawn.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <limits>
 #include <thread>
@@ -47,126 +49,127 @@ namespace nvim {
 //
 // Response handlers are stored in response contexts. Response contexts do
 // additional bookkeeping to track timed out requests.
+//
+// A msgid is the index of its response context. Free contexts form an
+// intrusive list threaded through next_free, so allocating and freeing a msgid
+// is O(1). Contexts live in a deque, which never moves them, and handlers are
+// stored inline. Once the table has grown to the number of requests in flight,
+// registering and completing a request doesn't touch the heap.
+//
+// A msgid isn't reused until its context is freed. A timed out request keeps
+// its msgid until the server responds, so a late response can't be mistaken
+// for the response to a newer request.
 static constexpr uint32_t null_msgid = std::numeric_limits<uint32_t>::max();
 
+process::response_handler_table::response_handler_table():
+    free_head(null_msgid) {}
+
 /// Allocate a new response context. Should be freed with free_context().
 process::response_context* process::response_handler_table::alloc_context() {
-    if (freelist.size()) {
-        response_context *back = freelist.back();
-        freelist.pop_back();
-        return back;
+    if (free_head != null_msgid) {
+        response_context *context = &contexts[free_head];
+        free_head = context->next_free;
+        return context;
     }
 
+    // Don't hand out null_msgid. We'd have run out of memory long before.
     response_context &back = contexts.emplace_back();
+    back.table = this;
+    back.msgid = static_cast<uint32_t>(contexts.size() - 1);
     return &back;
 }
 
-/// Map a response context to a msgid.
-/// The context can be accessed using get_context(msgid).
-uint32_t process::response_handler_table::store_context(response_context *ctx) {
-    const size_t table_size = handler_table.size();
-
-    size_t empty_slot = [&](){
-        for (size_t i=last_index + 1; i<table_size; ++i) {
-            if (!handler_table[i]) return i;
-        }
-
-        for (size_t i=0; i<last_index; ++i) {
-            if (!handler_table[i]) return i;
-        }
-
-        return table_size;
-    }();
-
-    if (empty_slot == table_size) {
-        handler_table.resize(table_size * 2);
-    }
-
-    last_index = empty_slot;
-    handler_table[empty_slot] = ctx;
-
-    return (uint32_t)empty_slot;
+/// Return a context, and its msgid, to the free list.
+void process::response_handler_table::free_context(response_context *context) {
+    context->next_free = free_head;
+    free_head = context->msgid;
 }
 
 /// Registers a response handler.
 /// @returns The response handlers msgid.
 uint32_t process::store_handler(response_handler &&handler) {
+    handler_table->assert_not_owner();
     std::lock_guard lock(*handler_table);
 
     response_context *context = handler_table->alloc_context();
-    context->table = handler_table;
     context->handler = std::move(handler);
-    context->complete = false;
+    context->awaiting = true;
     context->timed_out = false;
     context->has_timeout = false;
 
-    return handler_table->store_context(context);
+    return context->msgid;
 }
 
 /// Registers a response handler with a timeout.
 /// @returns The response handlers msgid.
 uint32_t process::store_handler(dispatch_time_t timeout,
                                 response_handler &&handler) {
+    handler_table->assert_not_owner();
     std::lock_guard lock(*handler_table);
 
-    // Timeouts are implemented using dispatch_after. We register the handler
-    // and fire off an accompanying dispatch_after block, which will either:
-    //   1. Handle a timeout.
-    //   2. Release the response context.
+    // Timeouts are kept in the io_loop's timer wheel. If the server responds
+    // first, on_rpc_response removes the timeout and frees the context. If
+    // the timeout runs first, it calls the handler with timed_out set.
     //
-    // The context is freed when it's timeout has expired and the server has
-    // responded. This means that a context will live, at minimum, until its
-    // timeout has fired. In the worst case, where we never receive a response
-    // from the server, a context will live for the lifetime of the process
-    // object.
+    // A timed out context is freed when the server eventually responds. In
+    // the worst case, where we never receive a response from the server, a
+    // context will live for the lifetime of the process object.
     response_context *context = handler_table->alloc_context();
-    context->table = handler_table;
     context->handler = std::move(handler);
-    context->complete = false;
+    context->awaiting = true;
     context->timed_out = false;
     context->has_timeout = true;
+    context->timeout.context = context;
 
-    dispatch_after_f(timeout, queue, context, [](void *ptr) {
+    context->timeout.function = [](void *ptr) {
         response_context *context = static_cast<response_context*>(ptr);
         std::lock_guard lock(*context->table);
 
-        if (context->complete) {
-            // The request has completed. We're done, free and return.
-            context->table->free_context(context);
-        } else {
-            // We've timed out. Mark the context as having timed out and call
-            // the response handler. We overwrite the handler so we can free any
-            // resources it may be holding. We can't free this context yet, we
-            // might still receive a server response somewhere down the line.
-            context->timed_out = true;
-            context->handler(msg::object(), msg::object(), true);
-            context->handler = response_handler();
-        }
-    });
-
-    return handler_table->store_context(context);
+        // Mark the context as having timed out and call the response handler.
+        // We reset the handler so we can free any resources it may be
+        // holding. We can't free this context yet, we might still receive a
+        // server response somewhere down the line.
+        context->timed_out = true;
+        context->handler(msg::object(), msg::object(), true);
+        context->handler.reset();
+    };
+
+    loop.add_timeout(&context->timeout, timeout);
+    return context->msgid;
 }
 
 process::process() {
-    queue = nullptr;
-    read_source = nullptr;
-    write_source = nullptr;
     read_fd = -1;
     write_fd = -1;
-    semaphore = dispatch_semaphore_create(0);
+    partial = nullptr;
+    partial_offset = 0;
+    write_pending = false;
+    write_stalled = false;
+    inline_writes = false;
+    paste_offset = 0;
+    paste_chunk = 0;
+    paste_cancelled = false;
+    paste_timed_out = false;
+    attach_semaphore = dispatch_semaphore_create(0);
 }
 
 process::~process() {
-    if (!queue) return;
+    if (partial) {
+        outbound_queue::release(partial);
+    }
+
+    for (auto &segments : popped) {
+        for (outbound_segment *segment : segments) {
+            outbound_queue::release(segment);
+        }
+    }
 
-    assert(dispatch_source_testcancel(read_source));
-    assert(dispatch_source_testcancel(write_source));
+    if (!loop.is_open()) return;
+
+    assert(loop.is_cancelled());
     assert(read_fd != -1 && write_fd != -1);
 
-    dispatch_release(queue);
-    dispatch_release(read_source);
-    dispatch_release(write_source);
-    dispatch_release(semaphore);
+    dispatch_release(attach_semaphore);
     close(read_fd);
 
     // Read and write file descriptors may be the same. For example, when using
@@ -213,7 +216,9 @@ int process::connect(std::string_view addr) {
 
     sockaddr_un unaddr = {};
     unaddr.sun_family = AF_UNIX;
+#if defined(__APPLE__)
     unaddr.sun_len = addr.size() + 1;
+#endif
     memcpy(unaddr.sun_path, addr.data(), addr.size());
 
     if (::connect(sock, (sockaddr*)&unaddr, sizeof(unaddr)) == -1) {
@@ -223,124 +228,485 @@ int process::connect(std::string_view addr) {
     return io_init(sock, sock);
 }
 
-/// Initializes and starts the IO loop.
-/// Creates the dispatch queue, dispatch sources and response handler table.
+/// Initializes and starts the IO loop and response handler table.
 ///
 /// After this function call:
 ///  - When readfd is readable, io_can_read() is called.
 ///  - When writefd is writable, io_can_write() is called.
 ///
-/// The read source is activated immediately and is never suspended.
-/// The write source is only active while there is data waiting to be written.
+/// Reads are resumed immediately and are never suspended.
+/// Writes are only resumed while there is data waiting to be written.
 ///
 /// @param readfd   Read file descriptor.
 /// @param writefd  Write file descriptor.
 ///
 /// Note: readfd and writefd may be the same.
 /// Note: This function should only be called once.
-/// @returns Zero, for now.
+/// @returns An errno code if an error occurred, 0 if no error occurred.
 int process::io_init(int readfd, int writefd) {
     read_fd = readfd;
     write_fd = writefd;
-    queue = dispatch_queue_create(nullptr, DISPATCH_QUEUE_SERIAL);
 
-    // Response contexts may be referenced by dispatch_after blocks (timeout
-    // handlers), which can outlive the process object. To prevent dangling
-    // references, we heap allocate the response_handler_table and free it when
-    // we can be sure no timeout handlers are remaining.
-    handler_table = new response_handler_table;
-    dispatch_set_context(queue, handler_table);
-    dispatch_set_finalizer_f(queue, [](void *context) {
-        delete static_cast<response_handler_table*>(context);
-    });
+    // Reads drain the file descriptor until it would block. Writes may be
+    // made inline by the sending thread, which must never block.
+    for (int fd : {readfd, writefd}) {
+        int flags = fcntl(fd, F_GETFL);
 
-    read_source = dispatch_source_create(
-        DISPATCH_SOURCE_TYPE_READ, readfd, 0, queue);
+        if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1) {
+            return errno;
+        }
+    }
 
-    write_source = dispatch_source_create(
-        DISPATCH_SOURCE_TYPE_WRITE, writefd, 0, queue);
+    // Captures record reads and writes in order from the IO queue.
+    inline_writes = !capture.is_open();
 
-    dispatch_set_context(read_source, this);
-    dispatch_set_context(write_source, this);
+    io_handlers handlers;
+    handlers.context = this;
 
-    dispatch_source_set_event_handler_f(read_source, [](void *context) {
+    handlers.can_read = [](void *context) {
         static_cast<process*>(context)->io_can_read();
-    });
+    };
 
-    dispatch_source_set_event_handler_f(write_source, [](void *context) {
+    handlers.can_write = [](void *context) {
         static_cast<process*>(context)->io_can_write();
-    });
+    };
 
-    dispatch_source_set_cancel_handler_f(read_source, [](void *context) {
-        process *ptr = static_cast<process*>(context);
-        ptr->ui.shutdown();
-    });
+    handlers.cancelled = [](void *context) {
+        static_cast<process*>(context)->ui.shutdown();
+    };
 
-    dispatch_source_set_cancel_handler_f(write_source, [](void *context) {
-        process *ptr = static_cast<process*>(context);
-        dispatch_source_cancel(ptr->read_source);
-        ptr->read_state = dispatch_source_state::cancelled;
-    });
+    // Response contexts may be referenced by timers (timeout handlers), which
+    // can outlive the process object. To prevent dangling references, we heap
+    // allocate the response_handler_table and free it when we can be sure no
+    // timeout handlers are remaining.
+    handler_table = new response_handler_table;
+
+    if (int error = loop.open(readfd, writefd, handlers)) {
+        delete handler_table;
+        return error;
+    }
 
-    dispatch_resume(read_source);
-    read_state = dispatch_source_state::resumed;
-    write_state = dispatch_source_state::suspended;
+    loop.set_finalizer(handler_table, [](void *context) {
+        delete static_cast<response_handler_table*>(context);
+    });
 
     return 0;
 }
 
 void process::io_can_read() {
-    ssize_t bytes = read(read_fd, read_buffer, sizeof(read_buffer));
+    trace_span span("io_can_read");
+    io_stats.add_wakeup();
+
+    // Drain the file descriptor, within reason. Large redraw bursts would
+    // otherwise take a wakeup per read. We stop after a few megabytes so other
+    // work on the loop isn't starved, the loop will call us again.
+    size_t total = 0;
+
+    while (total < 4 * adaptive_read_size::max_size) {
+        // The input buffer holds the unpacked portion of an incomplete
+        // message, if any. The unpacker has already seen these bytes.
+        size_t size = read_size.size();
+        size_t offset = input_buffer.size();
+        const char *data = input_buffer.data();
+        char *tail = input_buffer.prepare(size);
+
+        // Growing the buffer moved the incomplete message, and the objects
+        // unpacked so far refer to its old location. Start it over.
+        if (offset && input_buffer.data() != data) {
+            unpacker = msg::unpacker();
+            offset = 0;
+        }
+
+        ssize_t bytes = read(read_fd, tail, size);
+
+        if (bytes <= 0) {
+            if (bytes == -1) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    io_stats.add_read(0);
+                    break;
+                }
+
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                return io_error();
+            }
 
-    if (bytes <= 0) {
-        if (bytes == -1) {
-            return io_error();
+            ui.window.close();
+            return io_cancel();
         }
 
-        ui.window.close();
-        return io_cancel();
+        capture.record(rpc_direction::read, tail, bytes);
+        io_stats.add_read(bytes);
+        input_buffer.commit(bytes);
+        io_unpack(offset);
+        total += bytes;
+
+        // A short read means we've almost certainly drained the descriptor.
+        // Rather than spend another syscall to see EAGAIN, we return and let
+        // the loop wake us if more data arrives.
+        if (!read_size.read(bytes)) {
+            break;
+        }
     }
 
-    unpacker.feed(read_buffer, bytes);
+    read_size.burst_end();
+}
+
+void process::io_unpack(size_t offset) {
+    // Unpack time excludes the time spent handling messages.
+    uint64_t start = latency_clock();
+    uint64_t unpack_time = 0;
+    uint64_t messages = 0;
+    size_t complete = 0;
+
+    // The input buffer is mirrored, so pending bytes are always contiguous and
+    // stay put until they're consumed. Strings are referred to in place, so we
+    // only consume the bytes of complete messages.
+    unpacker.feed_in_place(input_buffer.data() + offset,
+                           input_buffer.size() - offset);
 
     while (msg::object *obj = unpacker.unpack()) {
+        uint64_t now = latency_clock();
+        unpack_time += now - start;
+        messages += 1;
+        complete = input_buffer.size() - unpacker.remaining();
+        trace_record("unpack", start, now);
+
         on_rpc_message(*obj);
+        start = latency_clock();
     }
+
+    unpack_time += latency_clock() - start;
+    io_stats.add_unpack(messages, unpack_time);
+    input_shrink.used(input_buffer.size());
+    input_buffer.consume(complete);
+
+    // Nothing refers to the input buffer once it's empty, it's safe to move.
+    // Reads need at least read_size bytes of space, don't shrink below that.
+    if (!input_buffer.size()) {
+        if (size_t capacity = input_shrink.drained(input_buffer.capacity())) {
+            size_t old_capacity = input_buffer.capacity();
+            input_buffer.shrink(std::max(capacity, read_size.size()));
+
+            if (input_buffer.capacity() != old_capacity) {
+                io_stats.add_shrink();
+            }
+        }
+    }
+
+    io_stats.set_input_capacity(input_buffer.capacity());
 }
 
+// Outbound messages
+//
+// Any thread may send a request, and the IO loop sends responses. Rather than
+// serializing producers with a lock around a shared buffer, each thread packs
+// messages into its own scratch buffer, then publishes a copy of the bytes to
+// an outbound queue, a lock-free multi-producer single-consumer queue. The
+// IO loop is the only consumer. It writes queued messages with writev.
+//
+// There are two queues, or lanes. The interactive lane carries keyboard and
+// mouse input, mode queries, and responses. Everything else goes in the bulk
+// lane. Within a lane, messages are written in order. Between messages, the
+// writer prefers the interactive lane, so a keystroke doesn't wait for a
+// queued paste to be written. A message that has been partially written is
+// always finished first, messages are never interleaved mid-message.
+//
+// Reordering across lanes is only safe because Neovim already handles the
+// interactive requests out of band. nvim_input, nvim_input_mouse and
+// nvim_get_mode are "fast" API calls, Neovim runs them as soon as they're
+// read, ahead of requests waiting on its main loop. Requests that depend on
+// each other, like a paste and a command, share the bulk lane.
+//
+// Large pastes are streamed a chunk at a time, and each chunk is only sent
+// once Neovim has responded to the last. Bulk messages published while a
+// paste is streaming are held, and published once it's finished, so nothing
+// lands between its chunks. The exception is synchronous requests, whose
+// caller is blocked until Neovim responds. They skip the held messages, see
+// rpc_publish_sync(). Bulk messages are published with bulk_lock held
+// to keep them in order with the held messages, but they're written once it's
+// released, so a slow write never holds up other bulk producers.
+//
+// Whoever sets write_pending owns the writer: the write source, or a thread
+// writing inline. Producers set it after publishing, whoever sets it resumes
+// writes. The writer only suspends writes while it's set, then clears it and
+// checks for messages published in the meantime. This keeps calls to
+// resume_writes() and suspend_writes() serialized, as io_loop requires.
+//
+// Usually nothing is waiting to be written. A thread sending a message then
+// claims the writer and writes it immediately, without waiting for the IO
+// queue to wake up. Interactive messages are written straight from the
+// scratch buffer, bulk messages from the queue, see io_flush(). A partial
+// write is handed to the write source.
+//
+// A producer preempted between claiming its place in a queue and linking its
+// message holds up everything behind it. The writer can't tell how long for,
+// so rather than spin, it keeps write_pending, suspends writes and sets
+// write_stalled. Producers that find write_pending set clear it and resume
+// writes, see io_wake_stalled(). The stalled producer is one of them.
+
 void process::io_can_write() {
-    std::lock_guard lock(write_lock);
-    ssize_t bytes = write(write_fd, packer.data(), packer.size());
+    switch (io_write()) {
+        case write_status::idle:
+            loop.suspend_writes();
+            return io_writes_idle();
+
+        case write_status::stalled:
+            loop.suspend_writes();
+            return io_writes_stalled();
+
+        case write_status::wrote:
+        case write_status::blocked:
+            return;
+
+        case write_status::failed:
+            break;
+    }
+
+    // Neovim has gone away. Cancelling stops reads, so we won't see the end of
+    // file, handle it here.
+    if (errno == EPIPE) {
+        ui.window.close();
+        return io_cancel();
+    }
+
+    io_error();
+}
+
+/// Gathers published messages and writes as much of them as the descriptor
+/// takes. Must be called by the writer.
+process::write_status process::io_write() {
+    // Gather as many messages as a single writev allows. Small messages are
+    // the common case, and the syscall dominates their cost.
+    constexpr size_t max_iov = IOV_MAX;
+    iovec iov[max_iov];
+    size_t iovcnt = 0;
+
+    if (partial) {
+        iov[0].iov_base = partial->data() + partial_offset;
+        iov[0].iov_len = partial->size - partial_offset;
+        iovcnt = 1;
+    }
+
+    // Segments popped but not yet written stay in popped, in order, until the
+    // next call. The interactive lane goes first.
+    bool stalled = false;
+
+    for (size_t i=0; i<2; ++i) {
+        auto &segments = popped[i];
+
+        while (segments.size() < max_iov) {
+            outbound_queue::pop_status status;
+            outbound_segment *segment = outbound[i].pop(status);
+
+            if (!segment) {
+                stalled |= status == outbound_queue::pop_status::in_progress;
+                break;
+            }
+
+            segments.push_back(segment);
+        }
+
+        for (size_t j=0; j<segments.size() && iovcnt < max_iov; ++j) {
+            iov[iovcnt].iov_base = segments[j]->data();
+            iov[iovcnt].iov_len = segments[j]->size;
+            iovcnt += 1;
+        }
+    }
+
+    if (!iovcnt) {
+        return stalled ? write_status::stalled : write_status::idle;
+    }
+
+    ssize_t bytes = writev(write_fd, iov, (int)iovcnt);
 
     if (bytes == -1) {
-        return io_error();
+        // The read and write file descriptors may be the same non-blocking
+        // socket. The loop calls us again once it's writable.
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            return write_status::blocked;
+        }
+
+        return write_status::failed;
     }
 
-    packer.consume(bytes);
+    io_stats.add_write(bytes);
+
+    // Release what's been written, in the order it was gathered. The first
+    // segment that wasn't completely written becomes the partial segment.
+    size_t written = bytes;
+    size_t index = 0;
+
+    auto advance = [&](outbound_segment *segment) {
+        size_t size = iov[index].iov_len;
+        size_t count = std::min(written, size);
+
+        capture.record(rpc_direction::write,
+                       static_cast<char*>(iov[index].iov_base), count);
+
+        written -= count;
+        index += 1;
+
+        if (count == size) {
+            outbound_queue::release(segment);
+            return true;
+        }
 
-    if (!packer.size()) {
-        dispatch_suspend(write_source);
-        write_state = dispatch_source_state::suspended;
+        partial = segment;
+        partial_offset = segment->size - size + count;
+        return false;
+    };
+
+    if (partial) {
+        outbound_segment *segment = partial;
+        partial = nullptr;
+
+        if (!advance(segment)) return write_status::blocked;
+    }
+
+    for (auto &segments : popped) {
+        while (written && index < iovcnt && segments.size()) {
+            outbound_segment *segment = segments.front();
+            segments.pop_front();
+
+            if (!advance(segment)) return write_status::blocked;
+        }
     }
+
+    return write_status::wrote;
 }
 
-void process::io_error() {
-    std::abort();
+/// Writes a message from the sending thread, if nothing else is being written.
+/// @returns True if the message was written, or handed to the write source
+///          after a partial write. False if the caller should publish it.
+bool process::io_write_inline(lane target, const char *data, size_t size) {
+    if (!inline_writes || write_pending.load() || loop.is_cancelled()) {
+        return false;
+    }
+
+    if (write_pending.exchange(true)) {
+        return false;
+    }
+
+    // We own the writer. Messages this thread published earlier may still be
+    // queued, they have to be written first.
+    if (io_queued()) {
+        outbound[(size_t)target].push(data, size);
+        loop.resume_writes();
+        return true;
+    }
+
+    ssize_t bytes = write(write_fd, data, size);
+
+    if (bytes > 0) {
+        io_stats.add_write(bytes);
+        io_stats.add_inline_write();
+    }
+
+    if (bytes == (ssize_t)size) {
+        io_writes_idle();
+        return true;
+    }
+
+    // The write source writes the rest once the descriptor is writable.
+    // Errors other than EAGAIN are reported when it tries again.
+    size_t written = std::max<ssize_t>(bytes, 0);
+    partial = outbound_queue::allocate(data, size);
+    partial_offset = written;
+    loop.resume_writes();
+    return true;
 }
 
-void process::io_cancel() {
-    // The read source is cancelled by write_source's cancellation handler.
-    // Read source's cancellation handler will in turn call shutdown.
-    if (write_state != dispatch_source_state::cancelled) {
-        if (write_state == dispatch_source_state::suspended) {
-            dispatch_resume(write_source);
+/// Writes published messages. If nothing else is being written, the calling
+/// thread claims the writer and writes them immediately, otherwise whoever
+/// owns the writer picks them up.
+/// Note: Must not be called with bulk_lock held.
+void process::io_flush() {
+    if (write_pending.load() || write_pending.exchange(true)) {
+        return io_wake_stalled();
+    }
+
+    if (!inline_writes || loop.is_cancelled()) {
+        return loop.resume_writes();
+    }
+
+    // A thread writes at most a couple of batches inline. Anything left, and
+    // anything that would block, is handed to the write source. So are
+    // errors, which are reported when it tries again.
+    for (int batch=0; batch<2; ++batch) {
+        switch (io_write()) {
+            case write_status::idle:
+                return io_writes_idle();
+
+            case write_status::stalled:
+                return io_writes_stalled();
+
+            case write_status::wrote:
+                io_stats.add_inline_write();
+                continue;
+
+            case write_status::blocked:
+            case write_status::failed:
+                return loop.resume_writes();
         }
+    }
+
+    loop.resume_writes();
+}
 
-        dispatch_source_cancel(write_source);
-        write_state = dispatch_source_state::cancelled;
+/// Releases the writer. Writes must be suspended.
+void process::io_writes_idle() {
+    write_pending.store(false);
+
+    // A producer that saw write_pending set before we cleared it won't
+    // resume writes. Pick up anything it published.
+    if (io_queued() && !write_pending.exchange(true)) {
+        loop.resume_writes();
+    }
+}
+
+/// Keeps the writer until a push in progress is linked. Writes must be
+/// suspended. The producer resumes them once it's linked.
+void process::io_writes_stalled() {
+    write_stalled.store(true);
+
+    // Pairs with the fence in io_wake_stalled(). Either the producer sees
+    // write_stalled set, or we see its message.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if ((outbound[0].ready() || outbound[1].ready()) && write_stalled.exchange(false)) {
+        loop.resume_writes();
+    }
+}
+
+/// Resumes writes if the writer is waiting for a push to be linked. Called by
+/// producers that published a message and found write_pending set.
+void process::io_wake_stalled() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (write_stalled.load(std::memory_order_relaxed) && write_stalled.exchange(false)) {
+        loop.resume_writes();
     }
 }
 
+/// The number of bytes published to either lane, but not yet gathered by
+/// the writer. This includes pushes in progress, a non-zero count doesn't
+/// mean there's a message ready to write.
+size_t process::io_queued() const {
+    return outbound[0].size() + outbound[1].size();
+}
+
+void process::io_error() {
+    std::abort();
+}
+
+void process::io_cancel() {
+    capture.close();
+    loop.cancel();
+}
+
 static inline bool is_notification(const msg::array &array) {
     return array.size() == 3 &&
            array[0].is<msg::integer>() &&
@@ -402,19 +768,48 @@ void process::on_rpc_response(msg::array array) {
         return;
     }
 
-    // We haven't timed out. Call the handler then overwrite it. Overwriting
-    // the handler here allows us to free any resources it may be referencing.
+    // We haven't timed out. Remove the pending timeout, so the context can
+    // be reused right away.
+    if (context->has_timeout) {
+        loop.remove_timeout(&context->timeout);
+    }
+
+    // Call the handler then reset it. Resetting the handler here allows us to
+    // free any resources it may be referencing.
     context->handler(array[2], array[3], false);
-    context->handler = response_handler();
+    context->handler.reset();
+    handler_table->free_context(context);
+}
 
-    // If the context has an associated time out, there's still a dispatch_after
-    // block that's coming. Mark it as complete and let the timeout handler
-    // free it. If there's no time out, we're done, free it now.
-    if (context->has_timeout) {
-        context->complete = true;
-    } else {
-        handler_table->free_context(context);
+/// Logs the redraw and IO counters. If the first argument is "reset", the
+/// counters are zeroed after logging. Called on the IO queue, which is the
+/// only writer of both sets of counters.
+void process::log_stats(msg::array args) {
+    std::string report = get_stats_report();
+    os_log_info(rpc, "%s", report.c_str());
+
+    if (args.size() && args[0].is<msg::string>() &&
+        args[0].get<msg::string>() == "reset") {
+        ui.stats.reset();
+        io_stats.reset();
+    }
+}
+
+/// Writes the recorded trace spans to the file path given as the first
+/// argument, in the Chrome trace JSON format. Responds with an error string if
+/// the file could not be written.
+void process::trace_dump(uint32_t msgid, msg::array args) {
+    if (!args.size() || !args[0].is<msg::string>()) {
+        return rpc_respond(msgid, "Expected a file path", nullptr);
     }
+
+    std::string path(args[0].get<msg::string>());
+
+    if (int error = trace_write(path.c_str())) {
+        return rpc_respond(msgid, strerror(error), nullptr);
+    }
+
+    rpc_respond(msgid, nullptr, nullptr);
 }
 
 void process::on_rpc_notification(msg::array array) {
@@ -427,6 +822,12 @@ void process::on_rpc_notification(msg::array array) {
         return ui.colorscheme_update(args);
     } else if (name == "vimenter") {
         return ui.vimenter();
+    } else if (name == "redraw_stats") {
+        return log_stats(args);
+    } else if (name == "trace_start") {
+        return trace_start();
+    } else if (name == "trace_stop") {
+        return trace_stop();
     }
 
     os_log_info(rpc, "Unhanled notification - Name=%.*s, Args=%s",
@@ -445,6 +846,14 @@ void process::on_rpc_request(msg::array array) {
     } else if (name == "clipboard_get") {
         auto data = clipboard_get();
         return rpc_respond(msgid, nullptr, data);
+    } else if (name == "redraw_stats") {
+        return rpc_respond(msgid, nullptr, get_stats_report());
+    } else if (name == "latency_report") {
+        std::string report = ui.latency.report();
+        os_log_info(rpc, "%s", report.c_str());
+        return rpc_respond(msgid, nullptr, report);
+    } else if (name == "trace_dump") {
+        return trace_dump(msgid, args);
     }
 
     rpc_respond(msgid, "Unknown method", nullptr);
@@ -453,39 +862,127 @@ void process::on_rpc_request(msg::array array) {
                 msg::to_string(args).c_str());
 }
 
-template<typename ...Args>
-void process::rpc_request(uint32_t msgid,
-                          std::string_view method, const Args& ...args) {
-    std::lock_guard lock(write_lock);
+namespace {
 
-    packer.start_array(4);
-    packer.pack_uint64(0);
-    packer.pack_uint64(msgid);
-    packer.pack_string(method);
-    packer.start_array(sizeof...(Args));
-    (packer.pack(args), ...);
+/// A thread's scratch buffer for packing outbound messages.
+struct scratch_buffer {
+    msg::packer packer;
+    shrink_policy shrink;
+};
+
+thread_local scratch_buffer scratch;
+
+}
+
+/// Returns this thread's packing buffer. Messages are packed into it, then
+/// sent with rpc_publish().
+msg::packer& process::scratch_packer() {
+    return scratch.packer;
+}
+
+/// Sends the message in this thread's scratch buffer.
+void process::rpc_publish(lane target) {
+    // Response handlers run with the handler table locked. Publishing from
+    // one could take bulk_lock, which paste_send() holds while it stores a
+    // handler, so fail loudly rather than deadlock.
+    handler_table->assert_not_owner();
+
+    if (target == lane::interactive) {
+        return rpc_send(target);
+    }
+
+    // Bulk messages are published with bulk_lock held, but written once it's
+    // released. A slow write shouldn't hold up other bulk producers.
+    bool published;
+
+    {
+        std::lock_guard lock(bulk_lock);
+        published = rpc_publish_bulk();
+    }
+
+    if (published) {
+        io_flush();
+    }
+}
+
+/// Publishes the bulk message in this thread's scratch buffer, or holds it if
+/// a paste is streaming. Published messages are written by io_flush().
+/// Note: bulk_lock must be held.
+/// @returns True if the message was published, false if it was held.
+bool process::rpc_publish_bulk() {
+    if (held.empty()) {
+        rpc_push(lane::bulk);
+        return true;
+    }
+
+    msg::packer &packer = scratch.packer;
+    held.push_back({std::string(packer.data(), packer.size()), nullptr});
+    packer.clear();
+    return false;
+}
+
+/// Publishes the bulk message in this thread's scratch buffer for a caller
+/// that's blocked waiting on its response. It's published ahead of any held
+/// messages, and may land between a streaming paste's chunks.
+void process::rpc_publish_sync() {
+    handler_table->assert_not_owner();
+    rpc_push(lane::bulk);
+    io_flush();
+}
+
+/// Sends the message in this thread's scratch buffer on a lane, writing it
+/// immediately if nothing else is being written.
+void process::rpc_send(lane target) {
+    msg::packer &packer = scratch.packer;
+
+    if (!io_write_inline(target, packer.data(), packer.size())) {
+        outbound[(size_t)target].push(packer.data(), packer.size());
+
+        // Usually the writer is already running, avoid dirtying the flag.
+        if (!write_pending.load() && !write_pending.exchange(true)) {
+            loop.resume_writes();
+        } else {
+            io_wake_stalled();
+        }
+    }
+
+    scratch_sent();
+}
+
+/// Publishes the message in this thread's scratch buffer to a lane, without
+/// writing it. Call io_flush() to have it written.
+void process::rpc_push(lane target) {
+    msg::packer &packer = scratch.packer;
+    outbound[(size_t)target].push(packer.data(), packer.size());
+    scratch_sent();
+}
 
-    if (write_state == dispatch_source_state::suspended) {
-        dispatch_resume(write_source);
-        write_state = dispatch_source_state::resumed;
+/// Clears this thread's scratch buffer once its message has been sent, and
+/// shrinks it after a burst.
+void process::scratch_sent() {
+    msg::packer &packer = scratch.packer;
+    io_stats.set_output_capacity(packer.capacity());
+    scratch.shrink.used(packer.size());
+    packer.clear();
+
+    if (size_t capacity = scratch.shrink.drained(packer.capacity())) {
+        packer.shrink(capacity);
+        io_stats.add_shrink();
+        io_stats.set_output_capacity(packer.capacity());
     }
 }
 
 template<typename Error, typename Response>
 void process::rpc_respond(uint32_t msgid,
                           const Error &error, const Response &response) {
-    std::lock_guard lock(write_lock);
-
+    msg::packer &packer = scratch.packer;
     packer.start_array(4);
     packer.pack_uint64(1);
     packer.pack_uint64(msgid);
     packer.pack(error);
     packer.pack(response);
 
-    if (write_state == dispatch_source_state::suspended) {
-        dispatch_resume(write_source);
-        write_state = dispatch_source_state::resumed;
-    }
+    rpc_publish(lane::interactive);
 }
 
 /// Packs a string into a uint64_t at compile time.
@@ -570,15 +1067,49 @@ static mode to_mode(const msg::object &error, const msg::object &result) {
     return mode::unknown;
 }
 
+namespace {
+
+// Each synchronous call waits on its own semaphore. A shared semaphore would
+// let concurrent callers consume each other's signals. Response handlers are
+// called exactly once, either with the response or with timed_out set, so
+// every wait is matched by a single signal.
+class sync_waiter {
+private:
+    dispatch_semaphore_t semaphore;
+
+public:
+    sync_waiter() {
+        semaphore = dispatch_semaphore_create(0);
+    }
+
+    sync_waiter(const sync_waiter&) = delete;
+    sync_waiter& operator=(const sync_waiter&) = delete;
+
+    ~sync_waiter() {
+        dispatch_release(semaphore);
+    }
+
+    void signal() {
+        dispatch_semaphore_signal(semaphore);
+    }
+
+    void wait() {
+        dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    }
+};
+
+} // namespace
+
 mode process::get_mode() {
     mode mode;
+    sync_waiter waiter;
     auto timeout = dispatch_time(DISPATCH_TIME_NOW, 100 * NSEC_PER_MSEC);
 
-    auto id = store_handler(timeout, [this, &mode](const msg::object &error,
-                                                   const msg::object &result,
-                                                   bool timed_out) {
+    auto id = store_handler(timeout, [this, &mode, &waiter](const msg::object &error,
+                                                            const msg::object &result,
+                                                            bool timed_out) {
         if (timed_out) {
-            if (write_state == dispatch_source_state::cancelled) {
+            if (loop.is_cancelled()) {
                 mode = mode::cancelled;
             } else {
                 mode = mode::timed_out;
@@ -587,11 +1118,11 @@ mode process::get_mode() {
             mode = to_mode(error, result);
         }
 
-        dispatch_semaphore_signal(this->semaphore);
+        waiter.signal();
     });
 
-    rpc_request(id, "nvim_get_mode");
-    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    rpc_request(lane::interactive, id, "nvim_get_mode");
+    waiter.wait();
     return mode;
 }
 
@@ -630,25 +1161,26 @@ void process::ui_attach_request(size_t width, size_t height, ui_options opts) {
 }
 
 void process::ui_attach(size_t width, size_t height, ui_options options) {
-    ui.signal_on_flush(semaphore);
+    ui.signal_on_flush(attach_semaphore);
+
     ui_attach_request(width, height, options);
-    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    dispatch_semaphore_wait(attach_semaphore, DISPATCH_TIME_FOREVER);
 }
 
 void process::ui_attach_wait(size_t width, size_t height,
                              ui_options options, dispatch_time_t timeout) {
-    ui.signal_on_entered_flush(semaphore);
+    ui.signal_on_entered_flush(attach_semaphore);
 
     rpc_request(null_msgid, "nvim_command",
                 "autocmd VimEnter * call rpcnotify(1, 'vimenter')");
 
     ui_attach_request(width, height, options);
 
-    if (!dispatch_semaphore_wait(semaphore, timeout)) {
+    if (!dispatch_semaphore_wait(attach_semaphore, timeout)) {
         return;
     }
 
-    dispatch_sync_f(queue, this, [](void *ptr) {
+    loop.sync(this, [](void *ptr) {
         process *self = static_cast<process*>(ptr);
 
         // If a grid is availible, signal now, otherwise wait for a flush.
@@ -659,7 +1191,7 @@ void process::ui_attach_wait(size_t width, size_t height,
         }
     });
 
-    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    dispatch_semaphore_wait(attach_semaphore, DISPATCH_TIME_FOREVER);
 }
 
 void process::try_resize(size_t width, size_t height) {
@@ -667,10 +1199,12 @@ void process::try_resize(size_t width, size_t height) {
 }
 
 void process::input(std::string_view input) {
-    rpc_request(null_msgid, "nvim_input", input);
+    ui.latency.input();
+    rpc_request(lane::interactive, null_msgid, "nvim_input", input);
 }
 
 void process::feedkeys(std::string_view keys) {
+    ui.latency.input();
     rpc_request(null_msgid, "nvim_feedkeys", keys, "n", true);
 }
 
@@ -686,22 +1220,168 @@ void process::command(std::string_view command, response_handler handler) {
 rpc_response process::sync_command(std::string_view command,
                                    dispatch_time_t timeout) {
     rpc_response response;
-    auto id = store_handler(timeout, [this, &response](const msg::object &err,
-                                                       const msg::object &res,
-                                                       bool timed_out){
+    sync_waiter waiter;
+
+    auto id = store_handler(timeout, [&response, &waiter](const msg::object &err,
+                                                          const msg::object &res,
+                                                          bool timed_out){
         response.error = err;
         response.result = res;
         response.timed_out = timed_out;
-        dispatch_semaphore_signal(semaphore);
+        waiter.signal();
     });
 
-    rpc_request(id, "nvim_command", command);
-    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    rpc_pack_request(id, "nvim_command", command);
+    rpc_publish_sync();
+    waiter.wait();
     return response;
 }
 
-void process::paste(std::string_view data) {
-    rpc_request(null_msgid, "nvim_paste", data, false, -1);
+void process::paste(std::string data) {
+    if (data.size() > paste_chunk_size) {
+        return paste(std::make_shared<const std::string>(std::move(data)));
+    }
+
+    rpc_pack_request(null_msgid, "nvim_paste", data, false, -1);
+    rpc_publish(lane::bulk);
+}
+
+void process::paste(std::shared_ptr<const std::string> data) {
+    if (data->size() <= paste_chunk_size) {
+        rpc_pack_request(null_msgid, "nvim_paste", *data, false, -1);
+        rpc_publish(lane::bulk);
+        return;
+    }
+
+    handler_table->assert_not_owner();
+
+    {
+        // Chunks are packed from data as they're sent. Only the chunk in
+        // flight is ever copied.
+        std::lock_guard lock(bulk_lock);
+        held.push_back({std::string(), std::move(data)});
+        if (held.size() != 1) return;
+
+        paste_offset = 0;
+        paste_send();
+    }
+
+    io_flush();
+}
+
+/// Returns the end of the paste chunk starting at offset. Chunks end on a line
+/// boundary where one is reasonably close, and never split a UTF-8 sequence.
+static size_t paste_chunk_end(std::string_view data, size_t offset) {
+    constexpr size_t max_size = process::paste_chunk_size;
+    size_t end = offset + max_size;
+
+    if (end >= data.size()) {
+        return data.size();
+    }
+
+    // Only search the back half of the chunk. An unbounded search would scan
+    // back to the start of a paste without newlines for every chunk.
+    size_t window = end - max_size / 2;
+    size_t newline = data.substr(window, max_size / 2).rfind('\n');
+
+    if (newline != std::string_view::npos) {
+        return window + newline + 1;
+    }
+
+    for (size_t i=0; i<3 && (data[end] & 0xc0) == 0x80; ++i) {
+        end -= 1;
+    }
+
+    return end;
+}
+
+/// Sends the next chunk of the paste at the front of the held messages. Uses
+/// the nvim_paste phases: 1 starts a paste, 2 continues it, and 3 ends it.
+/// Note: bulk_lock must be held.
+void process::paste_send() {
+    std::string_view data = *held.front().paste;
+    size_t end = paste_chunk_end(data, paste_offset);
+    bool last = end == data.size();
+    int phase = paste_offset == 0 ? (last ? -1 : 1) : (last ? 3 : 2);
+
+    paste_chunk = end - paste_offset;
+
+    dispatch_time_t timeout = dispatch_time(DISPATCH_TIME_NOW, paste_chunk_timeout);
+
+    uint32_t id = store_handler(timeout, [this](const msg::object &error,
+                                                const msg::object &result,
+                                                bool timed_out) {
+        // Neovim returns false if the paste should be cancelled. A chunk it
+        // hasn't accepted in time cancels the paste too, rather than holding
+        // every bulk request behind it.
+        paste_timed_out = timed_out;
+        paste_cancelled = timed_out || !error.is<msg::null>() ||
+                          (result.is<msg::boolean>() &&
+                           !result.get<msg::boolean>());
+
+        // We're called with the handler table locked, and handlers can't
+        // send. paste_continue() stores the next chunk's handler, which would
+        // deadlock on the table, so it runs on the IO queue once we've
+        // returned.
+        loop.async(this, [](void *context) {
+            static_cast<process*>(context)->paste_continue();
+        });
+    });
+
+    // The paste's own chunks skip the held messages.
+    rpc_pack_request(id, "nvim_paste",
+                     data.substr(paste_offset, paste_chunk), false, phase);
+    rpc_push(lane::bulk);
+}
+
+/// Called on the IO queue once Neovim has responded to a paste chunk.
+void process::paste_continue() {
+    {
+        std::lock_guard lock(bulk_lock);
+        size_t size = held.front().paste->size();
+        paste_offset += paste_chunk;
+
+        if (paste_cancelled) {
+            os_log_info(rpc, "Paste cancelled - Sent=%zu, Size=%zu, TimedOut=%d",
+                        paste_offset, size, paste_timed_out);
+        }
+
+        // Neovim is still expecting the rest of the paste. An empty paste
+        // with phase -1 starts and ends a new one, which resets its paste
+        // state, and is sent before anything that was held.
+        if (paste_timed_out) {
+            rpc_pack_request(null_msgid, "nvim_paste", "", false, -1);
+            rpc_push(lane::bulk);
+            paste_timed_out = false;
+        }
+
+        if (paste_cancelled || paste_offset == size) {
+            held.pop_front();
+            paste_offset = 0;
+            paste_release();
+        } else {
+            paste_send();
+        }
+    }
+
+    io_flush();
+}
+
+/// Sends the messages held behind a finished paste, in order, until the next
+/// paste, which starts streaming.
+/// Note: bulk_lock must be held.
+void process::paste_release() {
+    while (!held.empty()) {
+        held_message &message = held.front();
+
+        if (message.paste) {
+            return paste_send();
+        }
+
+        scratch_packer().append(message.data.data(), message.data.size());
+        rpc_push(lane::bulk);
+        held.pop_front();
+    }
 }
 
 void process::eval(std::string_view expr,
@@ -715,9 +1395,18 @@ void process::error_writeln(std::string_view error) {
 }
 
 void process::input_mouse(std::string_view button, std::string_view action,
-                          std::string_view modifiers, size_t row, size_t col) {
-    rpc_request(null_msgid, "nvim_input_mouse",
-                button, action, modifiers, 0, row, col);
+                          std::string_view modifiers, size_t row, size_t col,
+                          size_t count) {
+    ui.latency.input();
+
+    // Repeated events are packed back to back and published as one message,
+    // so scrolling several lines is still a single write.
+    for (size_t i=0; i<count; ++i) {
+        rpc_pack_request(null_msgid, "nvim_input_mouse",
+                         button, action, modifiers, 0, row, col);
+    }
+
+    rpc_publish(lane::interactive);
 }
 
 void process::drop_text(const std::vector<std::string_view> &text) {
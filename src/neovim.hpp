@@ -11,12 +11,23 @@
 #define NEOVIM_HPP
 
 #include <dispatch/dispatch.h>
-#include <functional>
+#include <atomic>
+#include <coroutine>
 #include <deque>
+#include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
+#include "inline_function.hpp"
+#include "io_loop.hpp"
 #include "msgpack.hpp"
+#include "outbound_queue.hpp"
+#include "read_size.hpp"
+#include "rpc_result.hpp"
+#include "shrink_policy.hpp"
+#include "rpc_capture.hpp"
+#include "task.hpp"
 #include "unfair_lock.hpp"
 #include "ui.hpp"
 
@@ -30,9 +41,16 @@ namespace nvim {
 ///                     request timed out the values of error and result
 ///                     are undefined. If the request had no time out this value
 ///                     can be ignored.
-using response_handler = std::function<void(const msg::object &error,
-                                            const msg::object &result,
-                                            bool timed_out)>;
+///
+/// Handlers are stored inline and never allocate. Captures must fit in six
+/// pointers, capture larger state by reference.
+///
+/// Handlers are called with the handler table locked. They must not send
+/// requests or notifications, dispatch them to another queue instead. Sending
+/// from a handler would deadlock, so it crashes instead.
+using response_handler = inline_function<void(const msg::object &error,
+                                              const msg::object &result,
+                                              bool timed_out)>;
 
 /// RPC response
 /// Data members represent the parameters in RPC response handler.
@@ -164,13 +182,109 @@ inline bool is_busy(nvim::mode mode) {
 /// message. Should the lifetime end before that, it will result in a runtime
 /// crash.
 class process {
+public:
+    /// Pastes larger than this are streamed to Neovim in chunks of at most
+    /// this size.
+    static constexpr size_t paste_chunk_size = 1024 * 1024;
+
+    /// If Neovim hasn't responded to a paste chunk within this many
+    /// nanoseconds, the rest of the paste is cancelled.
+    static constexpr uint64_t paste_chunk_timeout = 10 * NSEC_PER_SEC;
+
+    /// Awaitable returned by request(). The request is sent when it's awaited.
+    template<typename T, typename ...Args>
+    class request_awaitable {
+    private:
+        friend class process;
+
+        process *nvim;
+        dispatch_queue_t queue;
+        dispatch_time_t timeout;
+        std::string method;
+        std::tuple<Args...> args;
+        std::coroutine_handle<> handle;
+        rpc_result<T> result;
+
+        template<typename ...Params>
+        request_awaitable(process *nvim, dispatch_queue_t queue,
+                          dispatch_time_t timeout, std::string_view method,
+                          const Params& ...params):
+            nvim(nvim), queue(queue), timeout(timeout), method(method),
+            args(params...) {}
+
+    public:
+        bool await_ready() const {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            this->handle = handle;
+
+            // Once the handler is stored, the coroutine may be resumed on
+            // another thread, destroying this awaitable. Anything we need
+            // after that point is moved onto the stack first.
+            process *nvim = this->nvim;
+            std::string method = std::move(this->method);
+            std::tuple<Args...> args = std::move(this->args);
+
+            uint32_t id = nvim->store_handler(timeout, [this](const msg::object &error,
+                                                              const msg::object &result,
+                                                              bool timed_out) {
+                this->result.set(error, result, timed_out);
+                resume_on(this->queue, this->handle);
+            });
+
+            std::apply([&](const Args& ...params) {
+                nvim->rpc_request(lane::bulk, id, method, params...);
+            }, args);
+        }
+
+        rpc_result<T> await_resume() {
+            return std::move(result);
+        }
+    };
+
 private:
     struct response_handler_table;
 
+    /// Outbound message lanes. See neovim.cpp.
+    enum class lane : size_t {
+        interactive,
+        bulk
+    };
+
+    /// The outcome of a call to io_write().
+    enum class write_status {
+        /// There was nothing to write.
+        idle,
+
+        /// There was nothing to write yet, a push is still in progress.
+        stalled,
+
+        /// Everything gathered was written. More may have been published since.
+        wrote,
+
+        /// The descriptor would block, or only took part of what was gathered.
+        blocked,
+
+        /// The write failed, errno describes the error.
+        failed
+    };
+
+    /// A bulk message held behind a streaming paste. Either a packed message,
+    /// or the text of a paste that hasn't finished streaming.
+    struct held_message {
+        std::string data;
+        std::shared_ptr<const std::string> paste;
+    };
+
     struct response_context {
         response_handler_table *table;
         response_handler handler;
-        bool complete;
+        wheel_timer timeout;
+        uint32_t msgid;
+        uint32_t next_free;
+        bool awaiting;
         bool has_timeout;
         bool timed_out;
     };
@@ -178,20 +292,12 @@ private:
     struct response_handler_table {
         unfair_lock table_lock;
         std::deque<response_context> contexts;
-        std::vector<response_context*> freelist;
-        std::vector<response_context*> handler_table;
-        size_t last_index;
+        uint32_t free_head;
 
-        response_handler_table():
-            handler_table(16),
-            last_index(0) {}
+        response_handler_table();
 
         response_context* alloc_context();
-        uint32_t store_context(response_context *context);
-
-        void free_context(response_context *context) {
-            freelist.push_back(context);
-        }
+        void free_context(response_context *context);
 
         void lock() {
             table_lock.lock();
@@ -201,46 +307,67 @@ private:
             table_lock.unlock();
         }
 
+        /// Crashes if the calling thread holds the lock, that is if it's
+        /// running a response handler.
+        void assert_not_owner() {
+            table_lock.assert_not_owner();
+        }
+
         bool has_handler(size_t msgid) {
-            return msgid < handler_table.size() && handler_table[msgid];
+            return msgid < contexts.size() && contexts[msgid].awaiting;
         }
 
         response_context* get(size_t msgid) {
-            response_context *context = handler_table[msgid];
-            handler_table[msgid] = nullptr;
+            response_context *context = &contexts[msgid];
+            context->awaiting = false;
             return context;
         }
     };
 
-    /// Tracks the current state of dispatch_sources.
-    enum class dispatch_source_state {
-        resumed,
-        suspended,
-        cancelled
-    };
-
     nvim::ui_controller ui;
-    dispatch_queue_t queue;
-    dispatch_source_t read_source;
-    dispatch_source_t write_source;
-    dispatch_semaphore_t semaphore;
-    dispatch_source_state read_state;
-    dispatch_source_state write_state;
+    dispatch_semaphore_t attach_semaphore;
     int read_fd;
     int write_fd;
-    char read_buffer[16384];
-    msg::packer packer;
+    circular_buffer input_buffer;
+    adaptive_read_size read_size;
+    shrink_policy input_shrink;
     msg::unpacker unpacker;
-    unfair_lock write_lock;
+    outbound_queue outbound[2];
+    std::deque<outbound_segment*> popped[2];
+    outbound_segment *partial;
+    size_t partial_offset;
+    std::atomic<bool> write_pending;
+    std::atomic<bool> write_stalled;
+    bool inline_writes;
+    unfair_lock bulk_lock;
+    std::deque<held_message> held;
+    size_t paste_offset;
+    size_t paste_chunk;
+    bool paste_cancelled;
+    bool paste_timed_out;
     response_handler_table *handler_table;
+    rpc_capture capture;
+    rpc_stats io_stats;
+    io_loop loop;
 
     int  io_init(int readfd, int writefd);
     void io_can_read();
+    void io_unpack(size_t offset);
     void io_can_write();
+    write_status io_write();
+    bool io_write_inline(lane target, const char *data, size_t size);
+    void io_flush();
+    void io_writes_idle();
+    void io_writes_stalled();
+    void io_wake_stalled();
+    size_t io_queued() const;
     void io_error();
     void io_cancel();
 
     void ui_attach_request(size_t width, size_t height, ui_options options);
+    void paste_send();
+    void paste_continue();
+    void paste_release();
 
     uint32_t store_handler(response_handler &&handler);
     uint32_t store_handler(dispatch_time_t timeout, response_handler &&handler);
@@ -249,9 +376,40 @@ private:
     void on_rpc_response(msg::array obj);
     void on_rpc_request(msg::array obj);
     void on_rpc_notification(msg::array obj);
+    void log_stats(msg::array args);
+    void trace_dump(uint32_t msgid, msg::array args);
+
+    static msg::packer& scratch_packer();
+    void rpc_publish(lane target);
+    bool rpc_publish_bulk();
+    void rpc_publish_sync();
+    void rpc_send(lane target);
+    void rpc_push(lane target);
+    void scratch_sent();
 
     template<typename ...Args>
-    void rpc_request(uint32_t id, std::string_view method, const Args& ...args);
+    static void rpc_pack_request(uint32_t id, std::string_view method,
+                                 const Args& ...args) {
+        msg::packer &packer = scratch_packer();
+        packer.start_array(4);
+        packer.pack_uint64(0);
+        packer.pack_uint64(id);
+        packer.pack_string(method);
+        packer.start_array(sizeof...(Args));
+        (packer.pack(args), ...);
+    }
+
+    template<typename ...Args>
+    void rpc_request(lane target, uint32_t id,
+                     std::string_view method, const Args& ...args) {
+        rpc_pack_request(id, method, args...);
+        rpc_publish(target);
+    }
+
+    template<typename ...Args>
+    void rpc_request(uint32_t id, std::string_view method, const Args& ...args) {
+        rpc_request(lane::bulk, id, method, args...);
+    }
 
     template<typename Error, typename Response>
     void rpc_respond(uint32_t id, const Error &err, const Response &res);
@@ -317,6 +475,27 @@ public:
         ui.free_tabpage(tab);
     }
 
+    /// Returns the keypress latency tracker. Input sent by this process is
+    /// reported automatically, clients should report presented frames.
+    latency_tracker& get_latency_tracker() {
+        return ui.latency;
+    }
+
+    /// Returns the redraw event counters.
+    const redraw_stats& get_redraw_stats() {
+        return ui.stats;
+    }
+
+    /// Returns the msgpack-rpc IO counters.
+    const rpc_stats& get_rpc_stats() {
+        return io_stats;
+    }
+
+    /// Returns a human readable report of the redraw and IO counters.
+    std::string get_stats_report() {
+        return stats_report(ui.stats, io_stats);
+    }
+
     /// Set the window controller.
     ///
     /// The window controller receives various UI related messages.
@@ -324,6 +503,17 @@ public:
     /// process. Failing to do so will result in a runtime crash.
     void set_controller(window_controller controller);
 
+    /// Captures all msgpack-rpc traffic to the file at path.
+    ///
+    /// Every byte read from and written to Neovim is recorded, see
+    /// rpc_capture.hpp for the file format. The capture ends when the
+    /// connection shuts down. Captures can be replayed with nvim::replay().
+    /// Note: Must be called before spawn / connect.
+    /// @returns An errno code if an error occurred, 0 if no error occurred.
+    int start_capture(const char *path) {
+        return capture.open(path);
+    }
+
     /// Spawns and connects to a new Neovim process.
     /// @param path         Path to Neovim executable.
     /// @param argv         Arguments passed to the new process.
@@ -395,6 +585,9 @@ public:
     /// @param command  The neovim command to execute.
     /// @param timeout  Request timeout.
     /// @returns A rpc_response.
+    /// Safe to call from multiple threads, concurrent calls don't wait on
+    /// each other. The command isn't held behind a streaming paste, see
+    /// paste(), so it may run between the paste's chunks.
     rpc_response sync_command(std::string_view command,
                               dispatch_time_t timeout);
 
@@ -408,8 +601,45 @@ public:
               response_handler handler);
 
     /// Calls API method nvim_paste. Pastes at cursor, in any mode.
+    ///
+    /// Large pastes are streamed in chunks of at most paste_chunk_size bytes.
+    /// Each chunk is sent once Neovim has responded to the previous one, so
+    /// Neovim stays responsive and our buffers stay small. Bulk requests made
+    /// while a paste is streaming, including other pastes, are held until it
+    /// has finished, so they're still sent in order. If Neovim cancels a
+    /// paste, or doesn't respond to a chunk within paste_chunk_timeout, the
+    /// rest of it is dropped.
+    ///
+    /// Synchronous and interactive requests aren't held, a thread waiting on
+    /// a response shouldn't wait for the paste too.
     /// @param data Multi-line input, may be binary and contain NUL bytes.
-    void paste(std::string_view data);
+    ///             Large pastes are streamed from data, which is moved into
+    ///             a shared string rather than copied.
+    void paste(std::string data);
+
+    /// Calls API method nvim_paste, streaming large pastes straight from data.
+    /// See paste(std::string).
+    void paste(std::shared_ptr<const std::string> data);
+
+    /// Calls an API method from a coroutine, without blocking a thread.
+    ///
+    ///     nvim::rpc_result<int64_t> sum =
+    ///         co_await nvim.request<int64_t>(queue, timeout, "nvim_eval", "1 + 1");
+    ///
+    /// The coroutine is resumed on queue once Neovim responds, or the request
+    /// times out. The result is converted to a T, see from_object(). Use void
+    /// if the result isn't needed.
+    /// @param queue    The dispatch queue to resume the coroutine on.
+    /// @param timeout  Request timeout. May be DISPATCH_TIME_FOREVER.
+    /// @param method   The API method. Copied until the request is sent.
+    /// @param args     The method arguments. Copied until the request is sent.
+    template<typename T, typename ...Args>
+    request_awaitable<T, std::decay_t<const Args&>...> request(dispatch_queue_t queue,
+                                                               dispatch_time_t timeout,
+                                                               std::string_view method,
+                                                               const Args& ...args) {
+        return {this, queue, timeout, method, args...};
+    }
 
     /// Calls API method nvim_error_writeln.
     /// Writes a message to the nvim error buffer. Appends a new line character
@@ -440,7 +670,7 @@ public:
     /// as a nvim::mode. On a successful call, the time taken is in the order of
     /// nanoseconds. This call will timeout in 100ms and return mode::timed_out.
     /// If the Neovim connection has shutdown, or is in the process of shutting
-    /// down, mode::cancelled is returned.
+    /// down, mode::cancelled is returned. Safe to call from multiple threads.
     nvim::mode get_mode();
 
     /// Calls API method nvim_input_mouse. Used for real time mouse input.
@@ -451,12 +681,14 @@ public:
     ///                 "left", "right", "up", or "down".
     /// @param row      Mouse row position.
     /// @param col      Mouse column position.
+    /// @param count    The number of times to repeat the event, used to scroll
+    ///                 several lines at once. The requests are sent together.
     ///
     /// Note: All indexes are zero based.
     void input_mouse(std::string_view button,
                      std::string_view action,
                      std::string_view modifiers,
-                     size_t row, size_t col);
+                     size_t row, size_t col, size_t count = 1);
 
     /// Tests how many of the given files are currently open.
     /// @param paths    Absolute paths of the files to consider.
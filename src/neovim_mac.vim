@@ -72,3 +72,23 @@ endfunction
 function! neovim_mac#Colorscheme(values) abort
     call rpcnotify(1, "colorscheme", a:values)
 endfunction
+
+function! neovim_mac#LatencyReport() abort
+    return rpcrequest(1, "latency_report")
+endfunction
+
+function! neovim_mac#RedrawStats() abort
+    return rpcrequest(1, "redraw_stats")
+endfunction
+
+function! neovim_mac#TraceStart() abort
+    call rpcnotify(1, "trace_start")
+endfunction
+
+function! neovim_mac#TraceStop() abort
+    call rpcnotify(1, "trace_stop")
+endfunction
+
+function! neovim_mac#TraceDump(path) abort
+    return rpcrequest(1, "trace_dump", fnamemodify(a:path, ":p"))
+endfunction
@@ -0,0 +1,230 @@
+//
+//  Neovim Mac
+//  outbound_queue.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "outbound_queue.hpp"
+
+namespace nvim {
+namespace {
+
+// Most messages are small: input, commands and responses. Segments for them
+// come from a static slab and are recycled through a lock-free free stack,
+// so publishing a message doesn't have to call malloc and free. Larger
+// messages, and any message once the slab is used up, are allocated with
+// malloc as before.
+constexpr size_t slot_size = 1024;
+constexpr uint32_t slot_count = 256;
+constexpr size_t slot_capacity = slot_size - sizeof(outbound_segment);
+
+alignas(64) char slab[slot_size * slot_count];
+
+// The top of the free stack, as a slot index plus one in the low 32 bits, or
+// 0 if the stack is empty. The high 32 bits are a tag incremented by every
+// update. Free slots are linked through their next pointers, which any
+// thread may read, so a popper that lost a race can't mistake a reused slot
+// for the top of the stack (the ABA problem).
+alignas(64) std::atomic<uint64_t> free_top(0);
+
+// The number of slots that have been handed out at least once.
+alignas(64) std::atomic<uint32_t> slots_used(0);
+
+outbound_segment* slot(uint32_t index) {
+    return reinterpret_cast<outbound_segment*>(slab + (index * slot_size));
+}
+
+uint32_t slot_index(const outbound_segment *segment) {
+    return static_cast<uint32_t>((reinterpret_cast<const char*>(segment) - slab) / slot_size);
+}
+
+bool is_slot(const outbound_segment *segment) {
+    const char *address = reinterpret_cast<const char*>(segment);
+    return address >= slab && address < slab + sizeof(slab);
+}
+
+uint64_t next_top(uint64_t top, uint64_t index) {
+    return (((top >> 32) + 1) << 32) | index;
+}
+
+/// Returns a free slot, or null if the slab is used up.
+outbound_segment* pop_slot() {
+    uint64_t top = free_top.load(std::memory_order_acquire);
+
+    while (uint32_t index = static_cast<uint32_t>(top)) {
+        outbound_segment *segment = slot(index - 1);
+        outbound_segment *next = segment->next.load(std::memory_order_relaxed);
+        uint64_t next_index = next ? slot_index(next) + 1 : 0;
+
+        if (free_top.compare_exchange_weak(top, next_top(top, next_index),
+                                           std::memory_order_acquire,
+                                           std::memory_order_acquire)) {
+            return segment;
+        }
+    }
+
+    if (slots_used.load(std::memory_order_relaxed) >= slot_count) {
+        return nullptr;
+    }
+
+    uint32_t index = slots_used.fetch_add(1, std::memory_order_relaxed);
+
+    if (index >= slot_count) {
+        return nullptr;
+    }
+
+    return new (slot(index)) outbound_segment;
+}
+
+void push_slot(outbound_segment *segment) {
+    uint64_t index = slot_index(segment) + 1;
+    uint64_t top = free_top.load(std::memory_order_relaxed);
+
+    do {
+        uint32_t top_index = static_cast<uint32_t>(top);
+        segment->next.store(top_index ? slot(top_index - 1) : nullptr,
+                            std::memory_order_relaxed);
+    } while (!free_top.compare_exchange_weak(top, next_top(top, index),
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed));
+}
+
+} // namespace
+
+outbound_queue::outbound_queue(): tail(&stub), bytes(0), head(&stub) {
+    stub.next = nullptr;
+    stub.size = 0;
+}
+
+outbound_queue::~outbound_queue() {
+    while (outbound_segment *segment = pop()) {
+        release(segment);
+    }
+}
+
+void outbound_queue::link(outbound_segment *segment) {
+    segment->next.store(nullptr, std::memory_order_relaxed);
+
+    // The exchange orders producers. Until prev->next is stored, the consumer
+    // can't see this segment, or any segment pushed after it.
+    outbound_segment *prev = tail.exchange(segment, std::memory_order_acq_rel);
+    prev->next.store(segment, std::memory_order_release);
+}
+
+void outbound_queue::push(const void *data, size_t size) {
+    // Counted before it's linked, so pop() never subtracts a size that
+    // hasn't been added yet.
+    outbound_segment *segment = allocate(data, size);
+    bytes.fetch_add(size);
+    link(segment);
+}
+
+outbound_segment* outbound_queue::pop() {
+    pop_status status;
+    return pop(status);
+}
+
+outbound_segment* outbound_queue::pop(pop_status &status) {
+    outbound_segment *first = head;
+    outbound_segment *next = first->next.load(std::memory_order_acquire);
+    status = pop_status::in_progress;
+
+    // Skip over the stub. It's only in the list to keep it non-empty.
+    if (first == &stub) {
+        if (!next) {
+            if (tail.load(std::memory_order_acquire) == &stub) {
+                status = pop_status::empty;
+            }
+
+            return nullptr;
+        }
+
+        head = next;
+        first = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        head = next;
+        bytes.fetch_sub(first->size);
+        status = pop_status::popped;
+        return first;
+    }
+
+    // The first segment is also the last linked segment. If it isn't the
+    // tail, a push is in progress and we have to wait for it.
+    if (first != tail.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    // Push the stub behind the last segment, so we can unlink it. If another
+    // push got in first, it's linked behind the segment, or still in progress.
+    link(&stub);
+    next = first->next.load(std::memory_order_acquire);
+
+    if (next) {
+        head = next;
+        bytes.fetch_sub(first->size);
+        status = pop_status::popped;
+        return first;
+    }
+
+    return nullptr;
+}
+
+bool outbound_queue::ready() const {
+    const outbound_segment *first = head;
+    const outbound_segment *next = first->next.load(std::memory_order_acquire);
+
+    if (first == &stub) {
+        if (!next) {
+            return false;
+        }
+
+        first = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    // Mirrors pop(): the last linked segment can be popped if it's the tail.
+    return next || first == tail.load(std::memory_order_acquire);
+}
+
+outbound_segment* outbound_queue::allocate(const void *data, size_t size) {
+    outbound_segment *segment = nullptr;
+
+    if (size <= slot_capacity) {
+        segment = pop_slot();
+    }
+
+    if (!segment) {
+        void *memory = malloc(sizeof(outbound_segment) + size);
+
+        if (!memory) {
+            std::abort();
+        }
+
+        segment = new (memory) outbound_segment;
+    }
+
+    segment->size = size;
+    memcpy(segment->data(), data, size);
+    return segment;
+}
+
+void outbound_queue::release(outbound_segment *segment) {
+    if (is_slot(segment)) {
+        return push_slot(segment);
+    }
+
+    segment->~outbound_segment();
+    free(segment);
+}
+
+} // namespace nvim
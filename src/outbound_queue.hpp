@@ -0,0 +1,116 @@
+//
+//  Neovim Mac
+//  outbound_queue.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef OUTBOUND_QUEUE_HPP
+#define OUTBOUND_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+
+namespace nvim {
+
+/// A packed message waiting to be written.
+struct outbound_segment {
+    std::atomic<outbound_segment*> next;
+    size_t size;
+
+    const char* data() const {
+        return reinterpret_cast<const char*>(this + 1);
+    }
+
+    char* data() {
+        return reinterpret_cast<char*>(this + 1);
+    }
+};
+
+/// A lock-free multi-producer, single-consumer queue of outbound messages.
+///
+/// Any thread may push. Only one thread, the writer, may pop. Producers never
+/// wait on each other or on the writer: a push is a single atomic exchange on
+/// the tail plus a store to link the previous segment.
+///
+/// The queue is an intrusive linked list with a stub node, see:
+/// https://www.1024cores.net/home/lock-free-algorithms/queues/intrusive-mpsc-node-based-queue
+///
+/// A push is visible to pop() once it links its segment. Between the exchange
+/// and the link, pop() can't return its segment, or any segment pushed after
+/// it, even if those pushes have completed. The window is a few instructions
+/// long, unless the producer is preempted. pop() reports it as in_progress,
+/// so the consumer can wait for the producer rather than spin.
+class outbound_queue {
+private:
+    alignas(64) std::atomic<outbound_segment*> tail;
+    alignas(64) std::atomic<size_t> bytes;
+    alignas(64) outbound_segment *head;
+    outbound_segment stub;
+
+    void link(outbound_segment *segment);
+
+public:
+    /// The outcome of a call to pop().
+    enum class pop_status {
+        /// A segment was popped.
+        popped,
+
+        /// Nothing has been pushed.
+        empty,
+
+        /// A push is in progress and holds up the rest of the queue.
+        in_progress
+    };
+
+    outbound_queue();
+    ~outbound_queue();
+
+    outbound_queue(const outbound_queue&) = delete;
+    outbound_queue& operator=(const outbound_queue&) = delete;
+
+    /// Copies size bytes of data into a segment and publishes it.
+    /// Note: Safe to call from any thread.
+    void push(const void *data, size_t size);
+
+    /// Removes the oldest published segment from the queue.
+    /// The caller owns the segment and must free it with release().
+    /// @returns The segment, or null if there is nothing to pop.
+    /// Note: Must only be called by the consumer.
+    outbound_segment* pop();
+
+    /// Like pop(), but also reports why nothing was popped.
+    /// Note: Must only be called by the consumer.
+    outbound_segment* pop(pop_status &status);
+
+    /// Returns true if pop() would return a segment, unless another push
+    /// starts in the meantime.
+    /// Note: Must only be called by the consumer.
+    bool ready() const;
+
+    /// Allocates a segment holding a copy of size bytes of data, without
+    /// publishing it. Free it with release().
+    ///
+    /// Segments for messages of up to about a kilobyte are recycled from a
+    /// shared pool. Larger segments are allocated with malloc.
+    /// Note: Safe to call from any thread.
+    static outbound_segment* allocate(const void *data, size_t size);
+
+    /// Frees a segment returned by pop() or allocate(), returning it to the
+    /// pool if it came from there.
+    /// Note: Safe to call from any thread.
+    static void release(outbound_segment *segment);
+
+    /// The number of bytes pushed but not yet popped. A push is counted before
+    /// its segment is linked, so a non-zero size doesn't mean pop() will
+    /// return a segment, see pop_status::in_progress.
+    size_t size() const {
+        return bytes.load();
+    }
+};
+
+} // namespace nvim
+
+#endif // OUTBOUND_QUEUE_HPP
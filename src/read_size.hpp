@@ -0,0 +1,79 @@
+//
+//  Neovim Mac
+//  read_size.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef READ_SIZE_HPP
+#define READ_SIZE_HPP
+
+#include <cstddef>
+
+namespace nvim {
+
+/// Chooses the size of reads from a stream, adapting to recent burst sizes.
+///
+/// Most of the time Neovim sends us a few hundred bytes at a time, but opening
+/// a large file or running a chatty :terminal produces megabytes in a burst.
+/// Reads start small. A read that fills the buffer doubles the read size, up to
+/// max_size. After shrink_after consecutive bursts that would have fit in a
+/// quarter of the buffer, the read size is halved, down to min_size.
+class adaptive_read_size {
+public:
+    static constexpr size_t min_size = 16 * 1024;
+    static constexpr size_t max_size = 1024 * 1024;
+    static constexpr int shrink_after = 32;
+
+private:
+    size_t current;
+    size_t burst;
+    int small_bursts;
+
+public:
+    adaptive_read_size(): current(min_size), burst(0), small_bursts(0) {}
+
+    /// The size of the next read.
+    size_t size() const {
+        return current;
+    }
+
+    /// Records a completed read.
+    /// @returns True if the read filled the buffer, and the stream may have
+    ///          more data waiting.
+    bool read(size_t bytes) {
+        burst += bytes;
+
+        if (bytes < current) {
+            return false;
+        }
+
+        if (current < max_size) {
+            current *= 2;
+        }
+
+        return true;
+    }
+
+    /// Records the end of a burst of reads.
+    void burst_end() {
+        if (burst <= current / 4) {
+            small_bursts += 1;
+
+            if (small_bursts >= shrink_after && current > min_size) {
+                current /= 2;
+                small_bursts = 0;
+            }
+        } else {
+            small_bursts = 0;
+        }
+
+        burst = 0;
+    }
+};
+
+} // namespace nvim
+
+#endif // READ_SIZE_HPP
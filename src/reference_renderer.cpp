@@ -0,0 +1,378 @@
+//
+//  Neovim Mac
+//  reference_renderer.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "reference_renderer.hpp"
+
+glyph_atlas::glyph_atlas(size_t width, size_t height):
+    page_width(width),
+    page_height(height),
+    x_used(0),
+    y_used(0),
+    row_height(0) {
+    pages.emplace_back(width * height);
+}
+
+simd_short3 glyph_atlas::add(const uint32_t *glyph, size_t width, size_t height) {
+    row_height = std::max(height, row_height);
+
+    if (width + x_used > page_width || row_height + y_used > page_height) {
+        y_used = y_used + row_height + 1;
+        x_used = 0;
+        row_height = height;
+
+        if (width > page_width || height + y_used > page_height) {
+            pages.emplace_back(page_width * page_height);
+            y_used = 0;
+        }
+    }
+
+    // Glyphs larger than a page are cropped.
+    std::vector<uint32_t> &page = pages.back();
+    size_t stride = width;
+    width = std::min(width, page_width);
+    height = std::min(height, page_height);
+
+    for (size_t row=0; row<height; ++row) {
+        memcpy(&page[((y_used + row) * page_width) + x_used],
+               glyph + (row * stride), width * sizeof(uint32_t));
+    }
+
+    simd_short3 origin;
+    origin.x = x_used;
+    origin.y = y_used;
+    origin.z = pages.size() - 1;
+
+    x_used = x_used + width + 1;
+    return origin;
+}
+
+namespace {
+
+double decode(double srgb) {
+    if (srgb <= 0.04045) {
+        return srgb / 12.92;
+    }
+
+    return pow((srgb + 0.055) / 1.055, 2.4);
+}
+
+/// Lookup tables for sRGB conversions.
+struct srgb_tables {
+    /// The number of buckets linear values are divided into for encoding.
+    static constexpr int bucket_count = 4096;
+
+    /// Linear values of sRGB encoded 8 bit components.
+    float linear[256];
+
+    /// Linear values half way between adjacent 8 bit components. A linear
+    /// value encodes to the number of thresholds less than or equal to it.
+    /// The last threshold is past every linear value.
+    float thresholds[256];
+
+    /// The encoding of the start of each bucket. Thresholds are further apart
+    /// than a bucket, so at most one more lies between a bucket's start and
+    /// any value in it.
+    uint8_t buckets[bucket_count];
+
+    srgb_tables() {
+        for (int i=0; i<256; ++i) {
+            linear[i] = decode(i / 255.0);
+        }
+
+        for (int i=0; i<255; ++i) {
+            thresholds[i] = decode((i + 0.5) / 255.0);
+        }
+
+        thresholds[255] = 2;
+
+        for (int i=0; i<bucket_count; ++i) {
+            float start = static_cast<float>(i) / bucket_count;
+            buckets[i] = std::upper_bound(thresholds, thresholds + 255, start) - thresholds;
+        }
+    }
+};
+
+const srgb_tables& srgb() {
+    static srgb_tables tables;
+    return tables;
+}
+
+/// Equivalent to unpack_unorm4x8_srgb_to_float's color channel, for the
+/// given channel of four colors.
+simd_float4 unpack_srgb_channel(const uint32_t colors[4], int channel) {
+    const float *table = srgb().linear;
+    const int shift = channel * 8;
+
+    return simd_make_float4(table[(colors[0] >> shift) & 0xFF],
+                            table[(colors[1] >> shift) & 0xFF],
+                            table[(colors[2] >> shift) & 0xFF],
+                            table[(colors[3] >> shift) & 0xFF]);
+}
+
+/// Encodes a linear component, as written to an sRGB render target.
+/// Rounds to the nearest 8 bit component.
+uint32_t encode_srgb(float linear) {
+    const srgb_tables &tables = srgb();
+    linear = std::clamp(linear, 0.0f, 1.0f);
+
+    int bucket = std::min(static_cast<int>(linear * srgb_tables::bucket_count),
+                          srgb_tables::bucket_count - 1);
+
+    uint32_t encoded = tables.buckets[bucket];
+    return encoded + (linear >= tables.thresholds[encoded]);
+}
+
+/// The first pixel whose center lies at or after position.
+long pixel_edge(float position) {
+    return static_cast<long>(ceilf(position - 0.5f));
+}
+
+// Vertex offsets of cursor_render's instances. See shaders.metal.
+constexpr float cursor_transforms[4][4][2] = {
+    {{ 0,  0}, { 0,  0}, { 1,  0}, { 1,  0}},
+    {{ 0, -1}, { 0,  0}, { 0, -1}, { 0,  0}},
+    {{ 0,  0}, { 0,  1}, { 0,  0}, { 0,  1}},
+    {{-1,  0}, {-1,  0}, { 0,  0}, { 0,  0}},
+};
+
+} // namespace
+
+reference_renderer::reference_renderer(size_t width, size_t height):
+    fb_width(width),
+    fb_height(height),
+    pixels(width * height) {}
+
+reference_renderer::pixel_rect reference_renderer::clip(float left, float top,
+                                                        float right, float bottom) const {
+    pixel_rect rect;
+    rect.left   = std::clamp<long>(pixel_edge(left),   0, fb_width);
+    rect.top    = std::clamp<long>(pixel_edge(top),    0, fb_height);
+    rect.right  = std::clamp<long>(pixel_edge(right),  rect.left, fb_width);
+    rect.bottom = std::clamp<long>(pixel_edge(bottom), rect.top, fb_height);
+    return rect;
+}
+
+void reference_renderer::fill(const pixel_rect &rect, uint32_t color) {
+    for (long y=rect.top; y<rect.bottom; ++y) {
+        uint32_t *row = &pixels[y * fb_width];
+        std::fill(row + rect.left, row + rect.right, color);
+    }
+}
+
+void reference_renderer::clear(uint32_t color) {
+    std::fill(pixels.begin(), pixels.end(), color);
+}
+
+void reference_renderer::draw_backgrounds(const uniform_data &uniforms,
+                                          const background_data *backgrounds,
+                                          size_t count) {
+    const float cell_width = uniforms.cell_pixel_size.x;
+    const float cell_height = uniforms.cell_pixel_size.y;
+
+    for (size_t i=0; i<count; ++i) {
+        const background_data &background = backgrounds[i];
+        float left = background.grid_position.x * cell_width;
+        float top = background.grid_position.y * cell_height;
+
+        fill(clip(left, top, left + (background.length * cell_width), top + cell_height),
+             background.color);
+    }
+}
+
+void reference_renderer::draw_glyphs(const uniform_data &uniforms,
+                                     const glyph_data *glyphs,
+                                     const glyph_colors *colors,
+                                     size_t count,
+                                     const glyph_atlas &atlas) {
+    const float cell_width = uniforms.cell_pixel_size.x;
+    const float cell_height = uniforms.cell_pixel_size.y;
+
+    for (size_t i=0; i<count; ++i) {
+        const glyph_data &glyph = glyphs[i];
+        const glyph_rect &rect = glyph.rect;
+
+        float cell_x = cell_width * glyph.grid_position.x;
+        float cell_y = cell_height * glyph.grid_position.y;
+
+        // The glyph's top left corner, relative to the cell.
+        float raw_x = uniforms.baseline.x + rect.position.x;
+        float raw_y = uniforms.baseline.y + rect.position.y;
+
+        // Glyphs are cropped to their cell. Cropping the quad also crops the
+        // texture, so texture coordinates are unaffected.
+        float bounds_x = cell_width * glyph.cell_width;
+        float bounds_y = cell_height;
+
+        pixel_rect quad = clip(cell_x + std::clamp(raw_x, 0.0f, bounds_x),
+                               cell_y + std::clamp(raw_y, 0.0f, bounds_y),
+                               cell_x + std::clamp(raw_x + rect.size.x, 0.0f, bounds_x),
+                               cell_y + std::clamp(raw_y + rect.size.y, 0.0f, bounds_y));
+
+        // Texture coordinates of the pixel at x, y are
+        // (x + texture_x, y + texture_y), sampled at the pixel's center.
+        long texture_x = floorf(rect.texture_origin.x - cell_x - raw_x + 0.5f);
+        long texture_y = floorf(rect.texture_origin.y - cell_y - raw_y + 0.5f);
+        size_t page = rect.texture_origin.z;
+
+        // Uncolored glyphs are copied as is, a row at a time. Texels outside of
+        // the atlas are transparent black.
+        if (glyph.color_class == GLYPH_NO_COLOR_CLASS) {
+            const long texels_left = std::clamp<long>(-texture_x, quad.left, quad.right);
+            const long texels_right = std::clamp<long>(atlas.width() - texture_x,
+                                                       texels_left, quad.right);
+
+            for (long y=quad.top; y<quad.bottom; ++y) {
+                uint32_t *row = &pixels[y * fb_width];
+                const uint32_t *texels = atlas.row(page, y + texture_y);
+
+                if (!texels) {
+                    std::fill(row + quad.left, row + quad.right, 0);
+                    continue;
+                }
+
+                std::fill(row + quad.left, row + texels_left, 0);
+                std::fill(row + texels_right, row + quad.right, 0);
+                memcpy(row + texels_left, texels + texels_left + texture_x,
+                       (texels_right - texels_left) * sizeof(uint32_t));
+            }
+
+            continue;
+        }
+
+        // Color classed glyphs, see glyph_fill. Coverage is recovered and the
+        // cell's colors are blended a channel at a time, with a lane for each
+        // of four adjacent pixels.
+        uint32_t fg_grey = glyph_color_class_grey(glyph.color_class >> 4);
+        uint32_t bg_grey = glyph_color_class_grey(glyph.color_class & 0xF);
+
+        const float class_background = srgb().linear[bg_grey];
+        const float class_range = srgb().linear[fg_grey] - class_background;
+
+        const uint32_t cell_colors[] = {colors[i].foreground, colors[i].background};
+        float foreground[3];
+        float background[3];
+
+        for (int channel=0; channel<3; ++channel) {
+            uint32_t shift = channel * 8;
+            foreground[channel] = srgb().linear[(cell_colors[0] >> shift) & 0xFF];
+            background[channel] = srgb().linear[(cell_colors[1] >> shift) & 0xFF];
+        }
+
+        const simd_float4 zero = simd_make_float4(0, 0, 0, 0);
+        const simd_float4 one = simd_make_float4(1, 1, 1, 1);
+
+        for (long y=quad.top; y<quad.bottom; ++y) {
+            uint32_t *row = &pixels[y * fb_width];
+
+            for (long x=quad.left; x<quad.right; x += 4) {
+                long n = std::min<long>(4, quad.right - x);
+                uint32_t texels[4] = {};
+                uint32_t blended[4];
+
+                for (long lane=0; lane<n; ++lane) {
+                    texels[lane] = atlas.texel(page, x + lane + texture_x, y + texture_y);
+                    blended[lane] = texels[lane] & 0xFF000000;
+                }
+
+                for (int channel=0; channel<3; ++channel) {
+                    simd_float4 coverage = simd_clamp((unpack_srgb_channel(texels, channel) -
+                                                       class_background) / class_range,
+                                                      zero, one);
+
+                    simd_float4 color = background[channel] +
+                                        coverage * (foreground[channel] - background[channel]);
+
+                    for (long lane=0; lane<n; ++lane) {
+                        blended[lane] |= encode_srgb(color[lane]) << (channel * 8);
+                    }
+                }
+
+                memcpy(row + x, blended, n * sizeof(uint32_t));
+            }
+        }
+    }
+}
+
+void reference_renderer::draw_lines(const uniform_data &uniforms,
+                                    const line_data *lines,
+                                    size_t count) {
+    const float cell_width = uniforms.cell_pixel_size.x;
+    const float cell_height = uniforms.cell_pixel_size.y;
+
+    for (size_t i=0; i<count; ++i) {
+        const line_data &line = lines[i];
+        float left = cell_width * line.grid_position.x;
+        float top = (cell_height * line.grid_position.y) +
+                    uniforms.baseline.y - line.ytranslate;
+
+        pixel_rect quad = clip(left, top, left + cell_width, top + line.thickness);
+
+        // Line pixels are either fully opaque or fully transparent, so
+        // blending reduces to selecting between the line and the framebuffer.
+        // Solid lines select the line everywhere.
+        if (line.period == 0) {
+            fill(quad, line.color);
+            continue;
+        }
+
+        // Dotted lines are visible where sinpi(phase) > 0, or equivalently
+        // where the phase modulo 2 is in (0, 1). Phases are computed at pixel
+        // centers, four pixels at a time.
+        const float scale = cell_width / line.period;
+        const simd_float4 lanes = simd_make_float4(0.5f, 1.5f, 2.5f, 3.5f);
+        const simd_uint4 color = simd_make_uint4(line.color, line.color,
+                                                 line.color, line.color);
+
+        for (long y=quad.top; y<quad.bottom; ++y) {
+            uint32_t *row = &pixels[y * fb_width];
+
+            for (long x=quad.left; x<quad.right; x += 4) {
+                simd_float4 offset = (x - left) + lanes;
+                simd_float4 phase = (line.count + (offset / cell_width)) * scale;
+                simd_float4 half = simd_fract(phase * 0.5f);
+                simd_uint4 visible = (simd_uint4)((half > 0.0f) & (half < 0.5f));
+
+                size_t n = std::min<long>(4, quad.right - x);
+                simd_uint4 dst = color;
+                memcpy(&dst, row + x, n * sizeof(uint32_t));
+
+                dst = (color & visible) | (dst & ~visible);
+                memcpy(row + x, &dst, n * sizeof(uint32_t));
+            }
+        }
+    }
+}
+
+void reference_renderer::draw_cursor(const uniform_data &uniforms,
+                                     size_t count,
+                                     size_t base_instance) {
+    float cell_width = uniforms.cell_pixel_size.x * uniforms.cursor_cell_width;
+    float cell_height = uniforms.cell_pixel_size.y;
+    float cell_x = uniforms.cursor_position.x * uniforms.cell_pixel_size.x;
+    float cell_y = uniforms.cursor_position.y * uniforms.cell_pixel_size.y;
+
+    // The size of the inner rect subtracted from the cell rect.
+    float inner_width = cell_width - uniforms.cursor_line_width;
+    float inner_height = cell_height - uniforms.cursor_line_width;
+
+    for (size_t instance=base_instance; instance<base_instance + count; ++instance) {
+        // Vertex 0 is the top left corner, vertex 3 is the bottom right.
+        const float (*transforms)[2] = cursor_transforms[instance];
+        float left   = cell_x - (inner_width * transforms[0][0]);
+        float top    = cell_y - (inner_height * transforms[0][1]);
+        float right  = cell_x + cell_width - (inner_width * transforms[3][0]);
+        float bottom = cell_y + cell_height - (inner_height * transforms[3][1]);
+
+        fill(clip(left, top, right, bottom), uniforms.cursor_color);
+    }
+}
@@ -0,0 +1,166 @@
+//
+//  Neovim Mac
+//  reference_renderer.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef REFERENCE_RENDERER_HPP
+#define REFERENCE_RENDERER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "shader_types.hpp"
+
+/// A CPU copy of a glyph texture cache.
+///
+/// Glyphs are stored in an array of fixed size pages, using the same shelf
+/// packing scheme as glyph_texture_cache. Pixels are RGBA premultiplied sRGB
+/// values, packed into a uint32_t with red in the low byte. This is the same
+/// layout glyph_rasterizer produces and rgb_color::opaque() uses.
+class glyph_atlas {
+private:
+    size_t page_width;
+    size_t page_height;
+    size_t x_used;
+    size_t y_used;
+    size_t row_height;
+    std::vector<std::vector<uint32_t>> pages;
+
+public:
+    /// Constructs an empty glyph atlas.
+    /// @param width    The width of a page in pixels.
+    /// @param height   The height of a page in pixels.
+    glyph_atlas(size_t width, size_t height);
+
+    /// Adds a glyph to the atlas.
+    ///
+    /// @param pixels   The glyph's pixels, in row major order.
+    /// @param width    The glyph's width in pixels.
+    /// @param height   The glyph's height in pixels.
+    ///
+    /// @returns The glyph's texture origin. See glyph_rect::texture_origin.
+    simd_short3 add(const uint32_t *pixels, size_t width, size_t height);
+
+    /// Returns the texel at the given page and position. Texels outside of the
+    /// atlas are transparent black, like Metal's clamp_to_zero address mode.
+    uint32_t texel(size_t page, long x, long y) const {
+        if (page >= pages.size() || x < 0 || y < 0 ||
+            x >= static_cast<long>(page_width) ||
+            y >= static_cast<long>(page_height)) {
+            return 0;
+        }
+
+        return pages[page][(y * page_width) + x];
+    }
+
+    /// Returns the row y of page, or nullptr if it's outside of the atlas.
+    const uint32_t* row(size_t page, long y) const {
+        if (page >= pages.size() || y < 0 || y >= static_cast<long>(page_height)) {
+            return nullptr;
+        }
+
+        return &pages[page][y * page_width];
+    }
+
+    /// The width of a page in pixels.
+    size_t width() const {
+        return page_width;
+    }
+
+    /// The number of pages in the atlas.
+    size_t page_count() const {
+        return pages.size();
+    }
+};
+
+/// A software implementation of the render pipelines in shaders.metal.
+///
+/// The reference renderer consumes the same instance data as the Metal
+/// renderer, and composites it into an RGBA framebuffer. It exists so the
+/// visual pipeline can be tested and benchmarked without a GPU.
+///
+/// Rasterization follows Metal's rules. A pixel is drawn if its center lies
+/// inside a quad, and textures are sampled with nearest filtering in pixel
+/// coordinates. The framebuffer, like the Metal drawable, holds sRGB encoded
+/// values. Blends are done on linear values, using the same conversions as an
+/// sRGB render target.
+///
+/// Each draw function corresponds to a drawPrimitives call in NVGridView,
+/// and should be called in the same order.
+class reference_renderer {
+private:
+    size_t fb_width;
+    size_t fb_height;
+    std::vector<uint32_t> pixels;
+
+    struct pixel_rect {
+        long left;
+        long top;
+        long right;
+        long bottom;
+    };
+
+    pixel_rect clip(float left, float top, float right, float bottom) const;
+    void fill(const pixel_rect &rect, uint32_t color);
+
+public:
+    /// Constructs a renderer with a framebuffer of the given size.
+    /// The framebuffer is initially transparent black.
+    reference_renderer(size_t width, size_t height);
+
+    /// The framebuffer's width in pixels.
+    size_t width() const {
+        return fb_width;
+    }
+
+    /// The framebuffer's height in pixels.
+    size_t height() const {
+        return fb_height;
+    }
+
+    /// The framebuffer's pixels in row major order. Same format as glyph_atlas.
+    const uint32_t* data() const {
+        return pixels.data();
+    }
+
+    /// Returns the pixel at the given position.
+    uint32_t pixel(size_t x, size_t y) const {
+        return pixels[(y * fb_width) + x];
+    }
+
+    /// Fills the framebuffer with color. Equivalent to MTLLoadActionClear.
+    void clear(uint32_t color);
+
+    /// Equivalent to background_render / background_fill.
+    void draw_backgrounds(const uniform_data &uniforms,
+                          const background_data *backgrounds,
+                          size_t count);
+
+    /// Equivalent to glyph_render / glyph_fill.
+    /// @param colors   The glyphs' colors, see glyph_colors. May be null if
+    ///                 none of the glyphs have a color class.
+    void draw_glyphs(const uniform_data &uniforms,
+                     const glyph_data *glyphs,
+                     const glyph_colors *colors,
+                     size_t count,
+                     const glyph_atlas &atlas);
+
+    /// Equivalent to line_render / line_fill, with alpha blending.
+    void draw_lines(const uniform_data &uniforms,
+                    const line_data *lines,
+                    size_t count);
+
+    /// Equivalent to cursor_render / background_fill.
+    /// @param count            The number of cursor instances to draw.
+    /// @param base_instance    The first instance. See cursor_render.
+    void draw_cursor(const uniform_data &uniforms,
+                     size_t count,
+                     size_t base_instance);
+};
+
+#endif // REFERENCE_RENDERER_HPP
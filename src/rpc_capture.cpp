@@ -0,0 +1,62 @@
+//
+//  Neovim Mac
+//  rpc_capture.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <cerrno>
+#include <cstring>
+
+#include "log.h"
+#include "rpc_capture.hpp"
+
+namespace nvim {
+
+int rpc_capture::open(const char *path) {
+    close();
+    file = fopen(path, "wb");
+
+    if (!file) {
+        return errno;
+    }
+
+    if (fwrite(rpc_capture_magic, sizeof(rpc_capture_magic), 1, file) != 1) {
+        int error = errno;
+        close();
+        return error;
+    }
+
+    start = std::chrono::steady_clock::now();
+    return 0;
+}
+
+void rpc_capture::close() {
+    if (file) {
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+void rpc_capture::record(rpc_direction direction, const void *data, size_t size) {
+    if (!file) {
+        return;
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    rpc_record_header header;
+    header.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    header.direction = static_cast<uint32_t>(direction);
+    header.size = static_cast<uint32_t>(size);
+
+    if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+        fwrite(data, 1, size, file) != size) {
+        os_log_error(rpc, "Capture write error: %i: %s\n", errno, strerror(errno));
+        close();
+    }
+}
+
+} // namespace nvim
@@ -0,0 +1,141 @@
+//
+//  Neovim Mac
+//  rpc_capture.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef RPC_CAPTURE_HPP
+#define RPC_CAPTURE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+namespace nvim {
+
+class headless_ui;
+
+// Capture file format
+//
+// A capture file starts with an 8 byte magic string, "NVRPCCAP", followed by
+// a sequence of records. Each record has a 16 byte little endian header:
+//
+//  - uint64_t timestamp: Nanoseconds since the capture was opened.
+//  - uint32_t direction: 0 for bytes read from Neovim, 1 for bytes written.
+//  - uint32_t size:      The number of data bytes that follow the header.
+//
+// Records contain raw msgpack-rpc bytes, exactly as they were read or written.
+// Messages may be split across records at any byte boundary.
+
+/// The direction of a captured record.
+enum class rpc_direction : uint32_t {
+    read,
+    write
+};
+
+/// The magic string a capture file starts with.
+inline constexpr char rpc_capture_magic[8] = {'N', 'V', 'R', 'P', 'C', 'C', 'A', 'P'};
+
+/// On disk record header. Every platform we build for is little endian, so
+/// headers are written in native byte order.
+struct rpc_record_header {
+    uint64_t timestamp;
+    uint32_t direction;
+    uint32_t size;
+};
+
+static_assert(sizeof(rpc_record_header) == 16);
+
+/// Tees msgpack-rpc traffic into a capture file.
+///
+/// Captures are written from the IO queue, which serializes access. The
+/// capture is not thread safe otherwise.
+class rpc_capture {
+private:
+    FILE *file;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    rpc_capture(): file(nullptr) {}
+
+    rpc_capture(const rpc_capture&) = delete;
+    rpc_capture& operator=(const rpc_capture&) = delete;
+
+    ~rpc_capture() {
+        close();
+    }
+
+    /// Creates a new capture file at path, overwriting any existing file.
+    /// Record timestamps are relative to the time the capture is opened.
+    /// @returns An errno code if an error occurred, 0 if no error occurred.
+    int open(const char *path);
+
+    /// Flushes and closes the capture file. Does nothing if it's not open.
+    void close();
+
+    /// Returns true if the capture file is open.
+    bool is_open() const {
+        return file;
+    }
+
+    /// Appends a record to the capture file. Does nothing if it's not open.
+    /// On a write error, the error is logged and the capture is closed.
+    void record(rpc_direction direction, const void *data, size_t size);
+};
+
+// Reading and replaying captures is implemented in rpc_replay.cpp, which only
+// the test target builds.
+
+/// A record read from a capture file.
+struct rpc_record {
+    uint64_t timestamp;
+    rpc_direction direction;
+    std::string_view data;
+};
+
+/// A capture file, read into memory.
+class rpc_capture_file {
+private:
+    std::vector<char> contents;
+    std::vector<rpc_record> capture_records;
+
+public:
+    /// Reads the capture file at path.
+    /// @returns An errno code if an error occurred, 0 if no error occurred.
+    ///          EINVAL is returned if the file is not a valid capture file.
+    int open(const char *path);
+
+    /// The records in the capture file, in the order they were recorded.
+    const std::vector<rpc_record>& records() const {
+        return capture_records;
+    }
+
+    /// The timestamp of the last record, or 0 if there are no records.
+    uint64_t duration() const {
+        return capture_records.size() ? capture_records.back().timestamp : 0;
+    }
+};
+
+/// Capture replay speeds.
+enum class replay_speed {
+    recorded,   ///< Replay records at the times they were recorded.
+    maximum     ///< Replay records as fast as possible.
+};
+
+/// Feeds the bytes read from Neovim in a capture to a headless_ui.
+/// Bytes written to Neovim are skipped, they're the client's side of the
+/// conversation. At recorded speed, replay blocks the calling thread until
+/// each record's timestamp has passed.
+/// @returns The time taken in nanoseconds.
+uint64_t replay(const rpc_capture_file &capture,
+                headless_ui &ui,
+                replay_speed speed);
+
+} // namespace nvim
+
+#endif // RPC_CAPTURE_HPP
@@ -0,0 +1,94 @@
+//
+//  Neovim Mac
+//  rpc_replay.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#include "headless.hpp"
+#include "rpc_capture.hpp"
+
+namespace nvim {
+
+int rpc_capture_file::open(const char *path) {
+    FILE *file = fopen(path, "rb");
+
+    if (!file) {
+        return errno;
+    }
+
+    contents.clear();
+    capture_records.clear();
+
+    char buffer[65536];
+
+    while (size_t bytes = fread(buffer, 1, sizeof(buffer), file)) {
+        contents.insert(contents.end(), buffer, buffer + bytes);
+    }
+
+    int error = ferror(file) ? EIO : 0;
+    fclose(file);
+
+    if (error) {
+        return error;
+    }
+
+    if (contents.size() < sizeof(rpc_capture_magic) ||
+        memcmp(contents.data(), rpc_capture_magic, sizeof(rpc_capture_magic))) {
+        return EINVAL;
+    }
+
+    size_t offset = sizeof(rpc_capture_magic);
+
+    while (offset < contents.size()) {
+        rpc_record_header header;
+
+        if (contents.size() - offset < sizeof(header)) {
+            return EINVAL;
+        }
+
+        memcpy(&header, contents.data() + offset, sizeof(header));
+        offset += sizeof(header);
+
+        if (contents.size() - offset < header.size || header.direction > 1) {
+            return EINVAL;
+        }
+
+        rpc_record &record = capture_records.emplace_back();
+        record.timestamp = header.timestamp;
+        record.direction = static_cast<rpc_direction>(header.direction);
+        record.data = std::string_view(contents.data() + offset, header.size);
+        offset += header.size;
+    }
+
+    return 0;
+}
+
+uint64_t replay(const rpc_capture_file &capture,
+                headless_ui &ui,
+                replay_speed speed) {
+    using namespace std::chrono;
+    steady_clock::time_point start = steady_clock::now();
+
+    for (const rpc_record &record : capture.records()) {
+        if (record.direction != rpc_direction::read) {
+            continue;
+        }
+
+        if (speed == replay_speed::recorded) {
+            std::this_thread::sleep_until(start + nanoseconds(record.timestamp));
+        }
+
+        ui.feed(record.data.data(), record.data.size());
+    }
+
+    return duration_cast<nanoseconds>(steady_clock::now() - start).count();
+}
+
+} // namespace nvim
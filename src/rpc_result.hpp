@@ -0,0 +1,125 @@
+//
+//  Neovim Mac
+//  rpc_result.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef RPC_RESULT_HPP
+#define RPC_RESULT_HPP
+
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "msgpack.hpp"
+
+namespace nvim {
+
+// Msgpack objects reference the buffer they were unpacked from, which is
+// reused once a response handler returns. Results that outlive their handler
+// are converted to owned values with from_object(). Each overload returns
+// false if the object doesn't hold a value of the requested type.
+
+inline bool from_object(const msg::object &object, std::monostate &value) {
+    return true;
+}
+
+inline bool from_object(const msg::object &object, bool &value) {
+    if (!object.is<msg::boolean>()) return false;
+    value = object.get<msg::boolean>();
+    return true;
+}
+
+template<typename Int, std::enable_if_t<std::is_integral_v<Int> &&
+                                        !std::is_same_v<Int, bool>, int> = 0>
+bool from_object(const msg::object &object, Int &value) {
+    if (!object.is<msg::integer>()) return false;
+    value = object.get<msg::integer>().as<Int>();
+    return true;
+}
+
+inline bool from_object(const msg::object &object, double &value) {
+    if (object.is<msg::float64>()) {
+        value = object.get<msg::float64>();
+        return true;
+    }
+
+    if (object.is<msg::integer>()) {
+        value = object.get<msg::integer>().as<int64_t>();
+        return true;
+    }
+
+    return false;
+}
+
+inline bool from_object(const msg::object &object, std::string &value) {
+    if (!object.is<msg::string>()) return false;
+    value = object.get<msg::string>();
+    return true;
+}
+
+template<typename T>
+bool from_object(const msg::object &object, std::vector<T> &values) {
+    if (!object.is<msg::array>()) return false;
+
+    msg::array array = object.get<msg::array>();
+    values.resize(array.size());
+
+    for (size_t i=0; i<array.size(); ++i) {
+        if (!from_object(array[i], values[i])) return false;
+    }
+
+    return true;
+}
+
+/// The result of an awaited RPC request. See process::request().
+template<typename T>
+struct rpc_result {
+    /// The result, converted from the response. Valid if ok() returns true.
+    /// Requests for void results hold a std::monostate.
+    std::conditional_t<std::is_void_v<T>, std::monostate, T> value;
+
+    /// The error message if the request failed, otherwise empty. A result that
+    /// can't be converted to a T is also an error.
+    std::string error;
+
+    /// True if the request timed out. If so, value and error are empty.
+    bool timed_out = false;
+
+    /// Returns true if the request succeeded.
+    bool ok() const {
+        return !timed_out && error.empty();
+    }
+
+    /// Sets the result from a response handler's arguments.
+    void set(const msg::object &error, const msg::object &result,
+             bool timed_out) {
+        this->timed_out = timed_out;
+
+        if (timed_out) {
+            return;
+        }
+
+        if (!error.is<msg::null>()) {
+            // Neovim errors are [type, message] arrays.
+            if (error.is<msg::array>() && error.get<msg::array>().size() == 2 &&
+                error.get<msg::array>()[1].is<msg::string>()) {
+                this->error = error.get<msg::array>()[1].get<msg::string>();
+            }
+
+            if (this->error.empty()) {
+                this->error = msg::to_string(error);
+            }
+        } else if (!from_object(result, value)) {
+            this->error = "Unexpected result: " + msg::to_string(result);
+        }
+    }
+};
+
+} // namespace nvim
+
+#endif // RPC_RESULT_HPP
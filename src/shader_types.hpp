@@ -10,7 +10,8 @@
 #ifndef SHADER_TYPES_H
 #define SHADER_TYPES_H
 
-#include <simd/simd.h>
+#include "simd_types.hpp"
+#include "color_class_types.hpp"
 
 struct uniform_data {
     simd_float2 pixel_size;
@@ -21,7 +22,21 @@ struct uniform_data {
     uint32_t cursor_color;
     uint32_t cursor_line_width;
     uint32_t cursor_cell_width;
-    uint32_t grid_width;
+};
+
+/// A horizontal run of cells with the same background color.
+struct background_data {
+    /// The grid position of the first cell in the run.
+    simd_short2 grid_position;
+
+    /// The number of cells in the run.
+    uint32_t length;
+    uint32_t color;
+
+    background_data() = default;
+
+    background_data(simd_short2 grid_position, uint32_t length, uint32_t color):
+        grid_position(grid_position), length(length), color(color) {}
 };
 
 /// A rasterized glyph stored in a Metal texture.
@@ -41,13 +56,37 @@ struct glyph_rect {
 
 struct glyph_data {
     simd_short2 grid_position;
-    uint32_t cell_width;
+    uint16_t cell_width;
+
+    /// The glyph's color class, or GLYPH_NO_COLOR_CLASS. Color classed glyphs
+    /// are tinted with their glyph_colors.
+    uint16_t color_class;
     glyph_rect rect;
 
     glyph_data() = default;
 
-    glyph_data(simd_short2 grid_position, uint32_t cell_width, glyph_rect rect):
-        grid_position(grid_position), cell_width(cell_width), rect(rect) {}
+    glyph_data(simd_short2 grid_position, uint32_t cell_width, glyph_rect rect,
+               uint16_t color_class = GLYPH_NO_COLOR_CLASS):
+        grid_position(grid_position),
+        cell_width(cell_width),
+        color_class(color_class),
+        rect(rect) {}
+};
+
+/// The colors a color classed glyph is tinted with.
+///
+/// Kept out of glyph_data, in a separate instance stream with an entry per
+/// glyph, so glyph_data doesn't grow. The stream is only written and read
+/// when color classes are enabled. Entries of glyphs without a color class
+/// are unused.
+struct glyph_colors {
+    uint32_t foreground;
+    uint32_t background;
+
+    glyph_colors() = default;
+
+    glyph_colors(uint32_t foreground, uint32_t background):
+        foreground(foreground), background(background) {}
 };
 
 struct line_metrics {
@@ -27,6 +27,11 @@ struct glyph_rasterizer_data {
     float4 position [[position]];
     float2 texture_position;
     uint32_t texture_index;
+    uint32_t color_class [[flat]];
+    float4 foreground [[flat]];
+    float4 background [[flat]];
+    float4 class_foreground [[flat]];
+    float4 class_background [[flat]];
 };
 
 // Our vertex data represents rectangles as an origin + size tuple. To translate
@@ -50,16 +55,17 @@ constant float2 cursor_transforms[5][4] = {
 vertex extern grid_rasterizer_data background_render(uint vertex_id [[vertex_id]],
                                                      uint instance_id [[instance_id]],
                                                      constant uniform_data &uniforms [[buffer(0)]],
-                                                     constant uint32_t *cell_colors [[buffer(1)]]) {
-    uint32_t row = instance_id / uniforms.grid_width;
-    uint32_t col = instance_id % uniforms.grid_width;
+                                                     constant background_data *backgrounds [[buffer(1)]]) {
+    constant background_data &background = backgrounds[instance_id];
 
-    float2 cell_vertex = float2(col, row) + transforms[vertex_id];
+    // Each instance is a span of cells on a single row.
+    float2 span_size = float2(background.length, 1);
+    float2 cell_vertex = float2(background.grid_position) + (span_size * transforms[vertex_id]);
     float2 position = float2(-1, 1) + (uniforms.cell_size * cell_vertex);
 
     grid_rasterizer_data data;
     data.position = float4(position.xy, 0, 1);
-    data.color = unpack_unorm4x8_srgb_to_float(cell_colors[instance_id]);
+    data.color = unpack_unorm4x8_srgb_to_float(background.color);
     return data;
 }
 
@@ -130,7 +136,8 @@ vertex extern line_rasterizer_data line_render(uint vertex_id [[vertex_id]],
 vertex extern glyph_rasterizer_data glyph_render(uint vertex_id [[vertex_id]],
                                                  uint instance_id [[instance_id]],
                                                  constant uniform_data &uniforms [[buffer(0)]],
-                                                 constant glyph_data *glyphs [[buffer(1)]]) {
+                                                 constant glyph_data *glyphs [[buffer(1)]],
+                                                 constant glyph_colors *colors [[buffer(2)]]) {
     constant glyph_data &glyph = glyphs[instance_id];
     int16_t col = glyph.grid_position.x;
     int16_t row = glyph.grid_position.y;
@@ -168,6 +175,21 @@ vertex extern glyph_rasterizer_data glyph_render(uint vertex_id [[vertex_id]],
     data.position = float4(position.xy, 0, 1);
     data.texture_position = float2(glyph.rect.texture_origin.xy) + texture_offset;
     data.texture_index = glyph.rect.texture_origin.z;
+    data.color_class = glyph.color_class;
+
+    // The colors stream is only written when color classes are enabled.
+    // Without them, no glyph has a color class, and it's never read.
+    if (glyph.color_class != GLYPH_NO_COLOR_CLASS) {
+        constant glyph_colors &cell_colors = colors[instance_id];
+        uint32_t fg_grey = glyph_color_class_grey(glyph.color_class >> 4);
+        uint32_t bg_grey = glyph_color_class_grey(glyph.color_class & 0xF);
+
+        data.foreground = unpack_unorm4x8_srgb_to_float(cell_colors.foreground);
+        data.background = unpack_unorm4x8_srgb_to_float(cell_colors.background);
+        data.class_foreground = unpack_unorm4x8_srgb_to_float(fg_grey * 0x010101);
+        data.class_background = unpack_unorm4x8_srgb_to_float(bg_grey * 0x010101);
+    }
+
     return data;
 }
 
@@ -186,5 +208,16 @@ fragment float4 glyph_fill(glyph_rasterizer_data in [[stage_in]],
                                       address::clamp_to_zero,
                                       coord::pixel);
 
-    return texture.sample(texture_sampler, in.texture_position, in.texture_index);
+    float4 texel = texture.sample(texture_sampler, in.texture_position, in.texture_index);
+
+    if (in.color_class == GLYPH_NO_COLOR_CLASS) {
+        return texel;
+    }
+
+    // Color classed glyphs are rasterized using representative greys. Recover
+    // per channel coverage from the greys and blend the cell's actual colors.
+    float3 coverage = saturate((texel.rgb - in.class_background.rgb) /
+                               (in.class_foreground.rgb - in.class_background.rgb));
+
+    return float4(mix(in.background.rgb, in.foreground.rgb, coverage), texel.a);
 }
@@ -0,0 +1,83 @@
+//
+//  Neovim Mac
+//  shrink_policy.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef SHRINK_POLICY_HPP
+#define SHRINK_POLICY_HPP
+
+#include <algorithm>
+#include <cstddef>
+
+namespace nvim {
+
+/// Decides when a buffer that grew to absorb a burst should give memory back.
+///
+/// Buffers double in capacity as needed and never shrink on their own. Pasting
+/// a 200MB log leaves a 512MB mapping behind. The policy tracks the peak size
+/// of the buffer between drains. After shrink_after consecutive drains with a
+/// peak below a quarter of the capacity, the buffer is shrunk to twice the
+/// largest of those peaks, but no smaller than target_capacity.
+///
+/// A single busy burst resets the count, so a buffer that's regularly needed
+/// keeps its capacity. This holds for large buffers too, repeated large drops
+/// or pastes reuse the buffer rather than remapping it for every burst.
+class shrink_policy {
+public:
+    static constexpr size_t target_capacity = 64 * 1024;
+    static constexpr int shrink_after = 32;
+
+private:
+    size_t peak;
+    size_t quiet_peak;
+    int quiet_drains;
+
+public:
+    shrink_policy(): peak(0), quiet_peak(0), quiet_drains(0) {}
+
+    /// Records the number of bytes the buffer currently holds.
+    void used(size_t size) {
+        peak = std::max(peak, size);
+    }
+
+    /// Records that the buffer has been emptied.
+    /// @param capacity The current capacity of the buffer.
+    /// @returns The capacity the buffer should shrink to, or zero if it should
+    ///          keep its current capacity.
+    size_t drained(size_t capacity) {
+        size_t burst = peak;
+        peak = 0;
+
+        if (capacity <= target_capacity) {
+            quiet_drains = 0;
+            quiet_peak = 0;
+            return 0;
+        }
+
+        if (burst > capacity / 4) {
+            quiet_drains = 0;
+            quiet_peak = 0;
+            return 0;
+        }
+
+        quiet_peak = std::max(quiet_peak, burst);
+        quiet_drains += 1;
+
+        if (quiet_drains < shrink_after) {
+            return 0;
+        }
+
+        size_t shrunk = std::max(quiet_peak * 2, target_capacity);
+        quiet_drains = 0;
+        quiet_peak = 0;
+        return shrunk < capacity ? shrunk : 0;
+    }
+};
+
+} // namespace nvim
+
+#endif // SHRINK_POLICY_HPP
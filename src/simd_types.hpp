@@ -0,0 +1,93 @@
+//
+//  Neovim Mac
+//  simd_types.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef SIMD_TYPES_HPP
+#define SIMD_TYPES_HPP
+
+// On Apple platforms and in shaders this is <simd/simd.h>. Elsewhere it
+// provides the subset used by shader_types.hpp, frame_builder.hpp and the
+// reference renderer, so they build with GCC or Clang on other platforms.
+//
+// The 4 lane types are compiler vector extensions, with the same elementwise
+// operators as Apple's. The 2 and 3 lane types are only used as plain data,
+// so they're structs with the same size and alignment as Apple's types.
+
+#if defined(__APPLE__) || defined(__METAL_VERSION__)
+#include <simd/simd.h>
+#else
+
+#include <cmath>
+#include <cstdint>
+
+typedef float simd_float4 __attribute__((vector_size(16)));
+typedef uint32_t simd_uint4 __attribute__((vector_size(16)));
+
+struct alignas(4) simd_short2 {
+    int16_t x;
+    int16_t y;
+};
+
+struct alignas(8) simd_short3 {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+};
+
+struct alignas(8) simd_float2 {
+    float x;
+    float y;
+};
+
+static inline simd_short2 simd_make_short2(int16_t x, int16_t y) {
+    return simd_short2{x, y};
+}
+
+static inline simd_float2 simd_make_float2(float x, float y) {
+    return simd_float2{x, y};
+}
+
+static inline simd_float4 simd_make_float4(float x, float y, float z, float w) {
+    return simd_float4{x, y, z, w};
+}
+
+static inline simd_uint4 simd_make_uint4(uint32_t x, uint32_t y, uint32_t z, uint32_t w) {
+    return simd_uint4{x, y, z, w};
+}
+
+static inline bool simd_equal(simd_short2 a, simd_short2 b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+static inline simd_float4 simd_clamp(simd_float4 x, simd_float4 min, simd_float4 max) {
+    simd_float4 result;
+
+    for (int i=0; i<4; ++i) {
+        result[i] = x[i] < min[i] ? min[i] : (x[i] > max[i] ? max[i] : x[i]);
+    }
+
+    return result;
+}
+
+static inline simd_float4 simd_mix(simd_float4 x, simd_float4 y, simd_float4 t) {
+    return x + t * (y - x);
+}
+
+/// Like Apple's simd_fract, the result is clamped below 1.
+static inline simd_float4 simd_fract(simd_float4 x) {
+    simd_float4 result;
+
+    for (int i=0; i<4; ++i) {
+        result[i] = fminf(x[i] - floorf(x[i]), 0x1.fffffep-1f);
+    }
+
+    return result;
+}
+
+#endif // defined(__APPLE__) || defined(__METAL_VERSION__)
+#endif // SIMD_TYPES_HPP
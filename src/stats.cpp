@@ -0,0 +1,175 @@
+//
+//  Neovim Mac
+//  stats.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <cstdio>
+#include <iterator>
+
+#include "stats.hpp"
+
+namespace nvim {
+
+const char* redraw_event_name(redraw_event_type type) {
+    static constexpr const char *names[] = {
+        "grid_line",
+        "grid_resize",
+        "grid_scroll",
+        "grid_clear",
+        "grid_cursor_goto",
+        "flush",
+        "hl_attr_define",
+        "default_colors_set",
+        "mode_info_set",
+        "mode_change",
+        "tabline_update",
+        "set_title",
+        "option_set",
+        "<ignored>",
+        "<unknown>"
+    };
+
+    static_assert(std::size(names) == static_cast<size_t>(redraw_event_type::count));
+    return names[static_cast<size_t>(type)];
+}
+
+redraw_counts redraw_stats::get(redraw_event_type type) const {
+    const counter &c = at(type);
+
+    redraw_counts counts;
+    counts.events = c.events.load(std::memory_order_relaxed);
+    counts.calls = c.calls.load(std::memory_order_relaxed);
+    counts.cells = c.cells.load(std::memory_order_relaxed);
+    counts.bytes = c.bytes.load(std::memory_order_relaxed);
+    counts.nanoseconds = c.nanoseconds.load(std::memory_order_relaxed);
+    return counts;
+}
+
+redraw_counts redraw_stats::total() const {
+    redraw_counts total;
+
+    for (size_t i=0; i<counters.size(); ++i) {
+        redraw_counts counts = get(static_cast<redraw_event_type>(i));
+        total.events += counts.events;
+        total.calls += counts.calls;
+        total.cells += counts.cells;
+        total.bytes += counts.bytes;
+        total.nanoseconds += counts.nanoseconds;
+    }
+
+    return total;
+}
+
+void redraw_stats::reset() {
+    for (counter &c : counters) {
+        c.events.store(0, std::memory_order_relaxed);
+        c.calls.store(0, std::memory_order_relaxed);
+        c.cells.store(0, std::memory_order_relaxed);
+        c.bytes.store(0, std::memory_order_relaxed);
+        c.nanoseconds.store(0, std::memory_order_relaxed);
+    }
+}
+
+rpc_counts rpc_stats::get() const {
+    rpc_counts counts;
+    counts.wakeups = wakeups.load(std::memory_order_relaxed);
+    counts.reads = reads.load(std::memory_order_relaxed);
+    counts.writes = writes.load(std::memory_order_relaxed);
+    counts.inline_writes = inline_writes.load(std::memory_order_relaxed);
+    counts.bytes_read = bytes_read.load(std::memory_order_relaxed);
+    counts.bytes_written = bytes_written.load(std::memory_order_relaxed);
+    counts.messages = messages.load(std::memory_order_relaxed);
+    counts.unpack_nanoseconds = unpack_nanoseconds.load(std::memory_order_relaxed);
+    counts.input_capacity = input_capacity.load(std::memory_order_relaxed);
+    counts.output_capacity = output_capacity.load(std::memory_order_relaxed);
+    counts.input_peak_capacity = input_peak_capacity.load(std::memory_order_relaxed);
+    counts.output_peak_capacity = output_peak_capacity.load(std::memory_order_relaxed);
+    counts.shrinks = shrinks.load(std::memory_order_relaxed);
+    return counts;
+}
+
+void rpc_stats::reset() {
+    wakeups.store(0, std::memory_order_relaxed);
+    reads.store(0, std::memory_order_relaxed);
+    writes.store(0, std::memory_order_relaxed);
+    inline_writes.store(0, std::memory_order_relaxed);
+    bytes_read.store(0, std::memory_order_relaxed);
+    bytes_written.store(0, std::memory_order_relaxed);
+    messages.store(0, std::memory_order_relaxed);
+    unpack_nanoseconds.store(0, std::memory_order_relaxed);
+    input_peak_capacity.store(input_capacity.load(std::memory_order_relaxed),
+                              std::memory_order_relaxed);
+    output_peak_capacity.store(output_capacity.load(std::memory_order_relaxed),
+                               std::memory_order_relaxed);
+    shrinks.store(0, std::memory_order_relaxed);
+}
+
+std::string stats_report(const redraw_stats &redraw, const rpc_stats &rpc) {
+    std::string out;
+    char buffer[256];
+
+    auto append = [&](const char *name, const redraw_counts &counts) {
+        snprintf(buffer, sizeof(buffer), "%-20s %10llu %10llu %12llu %12llu %12.3f\n",
+                 name,
+                 static_cast<unsigned long long>(counts.events),
+                 static_cast<unsigned long long>(counts.calls),
+                 static_cast<unsigned long long>(counts.cells),
+                 static_cast<unsigned long long>(counts.bytes),
+                 counts.nanoseconds / 1e6);
+        out += buffer;
+    };
+
+    snprintf(buffer, sizeof(buffer), "%-20s %10s %10s %12s %12s %12s\n",
+             "event", "events", "calls", "cells", "bytes", "time (ms)");
+    out += buffer;
+
+    for (size_t i=0; i<static_cast<size_t>(redraw_event_type::count); ++i) {
+        auto type = static_cast<redraw_event_type>(i);
+        redraw_counts counts = redraw.get(type);
+
+        if (counts.events) {
+            append(redraw_event_name(type), counts);
+        }
+    }
+
+    append("<total>", redraw.total());
+
+    rpc_counts io = rpc.get();
+    snprintf(buffer, sizeof(buffer),
+             "rpc: %llu bytes in (%llu reads), %llu bytes out (%llu writes, "
+             "%llu inline), %llu messages, %.3f ms unpacking\n",
+             static_cast<unsigned long long>(io.bytes_read),
+             static_cast<unsigned long long>(io.reads),
+             static_cast<unsigned long long>(io.bytes_written),
+             static_cast<unsigned long long>(io.writes),
+             static_cast<unsigned long long>(io.inline_writes),
+             static_cast<unsigned long long>(io.messages),
+             io.unpack_nanoseconds / 1e6);
+    out += buffer;
+
+    if (io.bytes_read) {
+        double megabytes = io.bytes_read / (1024.0 * 1024.0);
+        snprintf(buffer, sizeof(buffer),
+                 "rpc: %.1f reads per MB, %.1f wakeups per MB\n",
+                 io.reads / megabytes, io.wakeups / megabytes);
+        out += buffer;
+    }
+
+    snprintf(buffer, sizeof(buffer),
+             "rpc: input buffer %llu KB (peak %llu KB), "
+             "output buffer %llu KB (peak %llu KB), %llu shrinks\n",
+             static_cast<unsigned long long>(io.input_capacity / 1024),
+             static_cast<unsigned long long>(io.input_peak_capacity / 1024),
+             static_cast<unsigned long long>(io.output_capacity / 1024),
+             static_cast<unsigned long long>(io.output_peak_capacity / 1024),
+             static_cast<unsigned long long>(io.shrinks));
+    out += buffer;
+
+    return out;
+}
+
+} // namespace nvim
@@ -0,0 +1,242 @@
+//
+//  Neovim Mac
+//  stats.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace nvim {
+
+/// Redraw event types, as counted by redraw_stats.
+enum class redraw_event_type : uint8_t {
+    grid_line,
+    grid_resize,
+    grid_scroll,
+    grid_clear,
+    grid_cursor_goto,
+    flush,
+    hl_attr_define,
+    default_colors_set,
+    mode_info_set,
+    mode_change,
+    tabline_update,
+    set_title,
+    option_set,
+    ignored,        ///< Events we receive but don't handle.
+    unknown,        ///< Unhandled and malformed events.
+    count
+};
+
+/// Returns the name of a redraw event type.
+const char* redraw_event_name(redraw_event_type type);
+
+/// Adds n to a single writer counter.
+/// Counters are only written by one thread, so a relaxed load and store is
+/// enough, and avoids the cost of an atomic read-modify-write. Readers on
+/// other threads see a recent, but not necessarily the latest, value.
+inline void counter_add(std::atomic<uint64_t> &counter, uint64_t n) {
+    counter.store(counter.load(std::memory_order_relaxed) + n,
+                  std::memory_order_relaxed);
+}
+
+/// Adds n to a counter written by more than one thread.
+inline void shared_counter_add(std::atomic<uint64_t> &counter, uint64_t n) {
+    counter.fetch_add(n, std::memory_order_relaxed);
+}
+
+/// A snapshot of the redraw counters for one event type.
+struct redraw_counts {
+    uint64_t events = 0;        ///< Number of events.
+    uint64_t calls = 0;         ///< Number of argument tuples in the events.
+    uint64_t cells = 0;         ///< Number of grid cells written.
+    uint64_t bytes = 0;         ///< Number of text bytes written to cells.
+    uint64_t nanoseconds = 0;   ///< Time spent processing the events.
+};
+
+/// Always on counters of redraw events, kept per event type.
+///
+/// Counters are written by the thread processing redraw events, and can be
+/// read from any thread.
+class redraw_stats {
+private:
+    struct counter {
+        std::atomic<uint64_t> events;
+        std::atomic<uint64_t> calls;
+        std::atomic<uint64_t> cells;
+        std::atomic<uint64_t> bytes;
+        std::atomic<uint64_t> nanoseconds;
+    };
+
+    std::array<counter, static_cast<size_t>(redraw_event_type::count)> counters;
+
+    counter& at(redraw_event_type type) {
+        return counters[static_cast<size_t>(type)];
+    }
+
+    const counter& at(redraw_event_type type) const {
+        return counters[static_cast<size_t>(type)];
+    }
+
+public:
+    redraw_stats() {
+        reset();
+    }
+
+    redraw_stats(const redraw_stats&) = delete;
+    redraw_stats& operator=(const redraw_stats&) = delete;
+
+    /// Records an event with the given number of argument tuples.
+    void add_event(redraw_event_type type, uint64_t calls, uint64_t nanoseconds) {
+        counter &c = at(type);
+        counter_add(c.events, 1);
+        counter_add(c.calls, calls);
+        counter_add(c.nanoseconds, nanoseconds);
+    }
+
+    /// Records cells written by an event.
+    void add_cells(redraw_event_type type, uint64_t cells, uint64_t bytes) {
+        counter &c = at(type);
+        counter_add(c.cells, cells);
+        counter_add(c.bytes, bytes);
+    }
+
+    /// Returns the counters for an event type.
+    redraw_counts get(redraw_event_type type) const;
+
+    /// Returns the sum of all counters.
+    redraw_counts total() const;
+
+    /// Zeroes all counters. Should only be called by the writing thread.
+    void reset();
+};
+
+/// A snapshot of msgpack-rpc IO counters.
+struct rpc_counts {
+    uint64_t wakeups = 0;               ///< Number of times the read handler ran.
+    uint64_t reads = 0;                 ///< Number of read syscalls.
+    uint64_t writes = 0;                ///< Number of write syscalls.
+    uint64_t inline_writes = 0;         ///< Writes made by the sending thread.
+    uint64_t bytes_read = 0;            ///< Bytes read from Neovim.
+    uint64_t bytes_written = 0;         ///< Bytes written to Neovim.
+    uint64_t messages = 0;              ///< Messages unpacked.
+    uint64_t unpack_nanoseconds = 0;    ///< Time spent unpacking messages.
+    uint64_t input_capacity = 0;        ///< Current input buffer capacity.
+    uint64_t output_capacity = 0;       ///< Last used packing buffer capacity.
+    uint64_t input_peak_capacity = 0;   ///< Largest input buffer capacity.
+    uint64_t output_peak_capacity = 0;  ///< Largest packing buffer capacity.
+    uint64_t shrinks = 0;               ///< Times a buffer was shrunk.
+};
+
+/// Always on msgpack-rpc IO counters.
+///
+/// Most counters are only written by the IO queue. Writes are also counted by
+/// sending threads that write inline, while they own the writer. That's one
+/// writer at a time, but it races with reset() on the IO queue, so write
+/// counters use atomic read-modify-writes, as a relaxed load and store could
+/// undo a reset. Output capacities and shrinks are recorded by every sending
+/// thread concurrently, so they do too.
+class rpc_stats {
+private:
+    std::atomic<uint64_t> wakeups;
+    std::atomic<uint64_t> reads;
+    std::atomic<uint64_t> writes;
+    std::atomic<uint64_t> inline_writes;
+    std::atomic<uint64_t> bytes_read;
+    std::atomic<uint64_t> bytes_written;
+    std::atomic<uint64_t> messages;
+    std::atomic<uint64_t> unpack_nanoseconds;
+    std::atomic<uint64_t> input_capacity;
+    std::atomic<uint64_t> output_capacity;
+    std::atomic<uint64_t> input_peak_capacity;
+    std::atomic<uint64_t> output_peak_capacity;
+    std::atomic<uint64_t> shrinks;
+
+    static void gauge_set(std::atomic<uint64_t> &gauge,
+                          std::atomic<uint64_t> &peak, uint64_t value) {
+        gauge.store(value, std::memory_order_relaxed);
+        uint64_t current = peak.load(std::memory_order_relaxed);
+
+        while (value > current &&
+               !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+public:
+    rpc_stats(): input_capacity(0), output_capacity(0) {
+        reset();
+    }
+
+    rpc_stats(const rpc_stats&) = delete;
+    rpc_stats& operator=(const rpc_stats&) = delete;
+
+    /// Records a call to the read handler.
+    void add_wakeup() {
+        counter_add(wakeups, 1);
+    }
+
+    /// Records a read of the given size. Reads that would block are recorded
+    /// with a size of zero.
+    void add_read(uint64_t bytes) {
+        counter_add(reads, 1);
+        counter_add(bytes_read, bytes);
+    }
+
+    /// Records a write of the given size. Called by the IO queue and by
+    /// sending threads that write inline.
+    void add_write(uint64_t bytes) {
+        shared_counter_add(writes, 1);
+        shared_counter_add(bytes_written, bytes);
+    }
+
+    /// Records that the last write was made by the thread sending the message,
+    /// rather than the IO queue.
+    void add_inline_write() {
+        shared_counter_add(inline_writes, 1);
+    }
+
+    /// Records time spent unpacking the given number of messages.
+    void add_unpack(uint64_t message_count, uint64_t nanoseconds) {
+        counter_add(messages, message_count);
+        counter_add(unpack_nanoseconds, nanoseconds);
+    }
+
+    /// Records the current capacity of the input buffer.
+    void set_input_capacity(uint64_t capacity) {
+        gauge_set(input_capacity, input_peak_capacity, capacity);
+    }
+
+    /// Records the current capacity of a sending thread's packing buffer.
+    void set_output_capacity(uint64_t capacity) {
+        gauge_set(output_capacity, output_peak_capacity, capacity);
+    }
+
+    /// Records that a buffer was shrunk. Both the IO queue and sending
+    /// threads shrink buffers.
+    void add_shrink() {
+        shared_counter_add(shrinks, 1);
+    }
+
+    /// Returns a snapshot of the counters.
+    rpc_counts get() const;
+
+    /// Zeroes all counters. Current capacities are kept, peak capacities are
+    /// reset to them. Should only be called by the IO queue. Writes counted
+    /// concurrently are either kept or zeroed, never the reset undone.
+    void reset();
+};
+
+/// Returns a human readable table of redraw and RPC counters.
+std::string stats_report(const redraw_stats &redraw, const rpc_stats &rpc);
+
+} // namespace nvim
+
+#endif // STATS_HPP
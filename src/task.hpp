@@ -0,0 +1,76 @@
+//
+//  Neovim Mac
+//  task.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef TASK_HPP
+#define TASK_HPP
+
+#include <dispatch/dispatch.h>
+#include <coroutine>
+#include <cstdlib>
+
+namespace nvim {
+
+/// A fire and forget coroutine.
+///
+/// A task starts running as soon as it's called, on the calling thread, and
+/// frees itself once it finishes. Nothing can wait on a task. Use tasks for
+/// flows that end in side effects, like showing a save panel.
+struct task {
+    struct promise_type {
+        task get_return_object() {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept {
+            return {};
+        }
+
+        void return_void() {}
+
+        void unhandled_exception() {
+            std::abort();
+        }
+    };
+};
+
+/// Resumes a suspended coroutine on a dispatch queue.
+inline void resume_on(dispatch_queue_t queue, std::coroutine_handle<> handle) {
+    dispatch_async_f(queue, handle.address(), [](void *address) {
+        std::coroutine_handle<>::from_address(address).resume();
+    });
+}
+
+/// Awaitable that continues the awaiting coroutine on a dispatch queue.
+///
+///     co_await nvim::switch_to(dispatch_get_main_queue());
+class switch_to {
+private:
+    dispatch_queue_t queue;
+
+public:
+    explicit switch_to(dispatch_queue_t queue): queue(queue) {}
+
+    bool await_ready() const {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) const {
+        resume_on(queue, handle);
+    }
+
+    void await_resume() const {}
+};
+
+} // namespace nvim
+
+#endif // TASK_HPP
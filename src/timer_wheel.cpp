@@ -0,0 +1,240 @@
+//
+//  Neovim Mac
+//  timer_wheel.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <algorithm>
+#include <bit>
+
+#include "timer_wheel.hpp"
+
+namespace nvim {
+
+// Invariants:
+//  - Every tick before current has been processed.
+//  - A timer in the first level expires within 64 ticks of current, so its
+//    slot identifies its tick.
+//  - A timer in level L > 0 is due to cascade within 64 level L slots of
+//    current, and never in the slot current is in, unless current is exactly
+//    at the start of that slot. Its slot identifies when it cascades.
+//  - occupied has a bit set for every non-empty slot.
+//  - Timers added with a tick before current are kept in overdue.
+
+static constexpr uint32_t no_bucket = UINT32_MAX;
+static constexpr uint32_t overdue_bucket = UINT32_MAX - 1;
+
+timer_wheel::timer_wheel(uint64_t resolution): resolution(resolution) {
+    std::fill(&slots[0][0], &slots[0][0] + level_count * slot_count, nullptr);
+    std::fill(occupied, occupied + level_count, 0);
+    overdue = nullptr;
+    current = 0;
+    count = 0;
+}
+
+/// Links a timer into the head of a list.
+static void link(wheel_timer *&head, wheel_timer *timer, uint32_t bucket) {
+    timer->prev = nullptr;
+    timer->next = head;
+    timer->bucket = bucket;
+
+    if (head) {
+        head->prev = timer;
+    }
+
+    head = timer;
+}
+
+/// Links a timer into the slot for its expiration tick.
+void timer_wheel::place(wheel_timer *timer) {
+    // Ticks before current have been processed. Timers due then expire on
+    // the next call to advance(), whatever time it's given.
+    if (timer->expires < current) {
+        return link(overdue, timer, overdue_bucket);
+    }
+
+    // Timers beyond the last level are parked as far out as it reaches.
+    constexpr uint64_t max_distance = uint64_t(slot_count - 1) << (slot_bits * (level_count - 1));
+    uint64_t tick = std::clamp(timer->expires, current, current + max_distance);
+
+    uint32_t level = 0;
+
+    while ((tick >> (slot_bits * level)) - (current >> (slot_bits * level)) >= slot_count) {
+        level += 1;
+    }
+
+    uint32_t slot = (tick >> (slot_bits * level)) & (slot_count - 1);
+    link(slots[level][slot], timer, level * slot_count + slot);
+    occupied[level] |= uint64_t(1) << slot;
+}
+
+/// Unlinks and returns every timer in a slot.
+wheel_timer* timer_wheel::take(uint32_t level, uint32_t slot) {
+    wheel_timer *timers = slots[level][slot];
+    slots[level][slot] = nullptr;
+    occupied[level] &= ~(uint64_t(1) << slot);
+    return timers;
+}
+
+/// Returns the first tick, at or after from, that has timers to expire or
+/// cascade.
+uint64_t timer_wheel::next_tick(uint64_t from) const {
+    uint64_t next = UINT64_MAX;
+
+    for (uint32_t level=0; level<level_count; ++level) {
+        if (!occupied[level]) continue;
+
+        uint32_t shift = slot_bits * level;
+        uint64_t position = from >> shift;
+        uint32_t start = position & (slot_count - 1);
+        uint64_t distance = std::countr_zero(std::rotr(occupied[level], start));
+
+        // Past the start of a slot, its timers belong to the next rotation.
+        if (distance == 0 && (from & ((uint64_t(1) << shift) - 1))) {
+            distance = slot_count;
+        }
+
+        next = std::min(next, (position + distance) << shift);
+    }
+
+    return next;
+}
+
+void timer_wheel::add(wheel_timer *timer, uint64_t deadline) {
+    remove(timer);
+
+    // Round up, timers never expire early.
+    timer->expires = deadline / resolution + (deadline % resolution != 0);
+    place(timer);
+    count += 1;
+}
+
+void timer_wheel::remove(wheel_timer *timer) {
+    if (!timer->is_scheduled()) {
+        return;
+    }
+
+    uint32_t level = timer->bucket / slot_count;
+    uint32_t slot = timer->bucket % slot_count;
+    bool is_overdue = timer->bucket == overdue_bucket;
+    wheel_timer *&head = is_overdue ? overdue : slots[level][slot];
+
+    if (timer->prev) {
+        timer->prev->next = timer->next;
+    } else {
+        head = timer->next;
+    }
+
+    if (timer->next) {
+        timer->next->prev = timer->prev;
+    }
+
+    if (!head && !is_overdue) {
+        occupied[level] &= ~(uint64_t(1) << slot);
+    }
+
+    timer->bucket = no_bucket;
+    count -= 1;
+}
+
+wheel_timer* timer_wheel::advance(uint64_t now) {
+    uint64_t target = now / resolution;
+    wheel_timer *expired = nullptr;
+    wheel_timer **tail = &expired;
+
+    for (wheel_timer *timer = overdue; timer; timer = timer->next) {
+        timer->bucket = no_bucket;
+        count -= 1;
+        tail = &timer->next;
+    }
+
+    expired = overdue;
+    overdue = nullptr;
+
+    while (current <= target) {
+        if (!count) {
+            current = target + 1;
+            break;
+        }
+
+        // Cascade coarser levels first, their timers may be due this tick.
+        for (uint32_t level=level_count - 1; level > 0; --level) {
+            uint32_t shift = slot_bits * level;
+            if (current & ((uint64_t(1) << shift) - 1)) continue;
+
+            wheel_timer *timer = take(level, (current >> shift) & (slot_count - 1));
+
+            while (timer) {
+                wheel_timer *next = timer->next;
+                place(timer);
+                timer = next;
+            }
+        }
+
+        wheel_timer *timer = take(0, current & (slot_count - 1));
+
+        while (timer) {
+            wheel_timer *next = timer->next;
+
+            // Parked timers go back into the wheel until they're in range.
+            if (timer->expires > current) {
+                place(timer);
+            } else {
+                timer->bucket = no_bucket;
+                count -= 1;
+                *tail = timer;
+                tail = &timer->next;
+            }
+
+            timer = next;
+        }
+
+        current = std::min(next_tick(current + 1), target + 1);
+    }
+
+    *tail = nullptr;
+    return expired;
+}
+
+wheel_timer* timer_wheel::clear() {
+    wheel_timer *removed = overdue;
+    overdue = nullptr;
+
+    for (uint32_t level=0; level<level_count; ++level) {
+        for (uint32_t slot=0; slot<slot_count; ++slot) {
+            wheel_timer *timer = take(level, slot);
+
+            while (timer) {
+                wheel_timer *next = timer->next;
+                timer->next = removed;
+                removed = timer;
+                timer = next;
+            }
+        }
+    }
+
+    for (wheel_timer *timer = removed; timer; timer = timer->next) {
+        timer->bucket = no_bucket;
+    }
+
+    count = 0;
+    return removed;
+}
+
+uint64_t timer_wheel::next_deadline() const {
+    if (!count) {
+        return UINT64_MAX;
+    }
+
+    if (overdue) {
+        return 0;
+    }
+
+    uint64_t tick = next_tick(current);
+    return tick <= UINT64_MAX / resolution ? tick * resolution : UINT64_MAX;
+}
+
+} // namespace nvim
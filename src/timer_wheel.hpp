@@ -0,0 +1,107 @@
+//
+//  Neovim Mac
+//  timer_wheel.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nvim {
+
+/// A timer in a timer_wheel.
+///
+/// Timers are intrusive, the wheel never allocates. The owner sets context and
+/// function, and must keep the timer alive while it's in a wheel.
+struct wheel_timer {
+    wheel_timer *prev;
+    wheel_timer *next;
+    uint64_t expires;
+    uint32_t bucket;
+    void *context;
+    void (*function)(void *context);
+
+    wheel_timer(): bucket(UINT32_MAX) {}
+
+    /// Returns true if the timer is in a wheel.
+    bool is_scheduled() const {
+        return bucket != UINT32_MAX;
+    }
+};
+
+/// A hierarchical timer wheel.
+///
+/// Time is divided into ticks of resolution units. The first level has a slot
+/// per tick, each following level has a slot per 64 slots of the level below
+/// it. Adding and removing a timer is O(1). As time passes, timers cascade
+/// from their slot to a finer level, until they reach the first level and
+/// expire.
+///
+/// The wheel doesn't read a clock, the owner passes the current time to
+/// advance(). Any monotonic unit will do, as long as it's used consistently.
+/// Timers never expire early, and expire at most a tick late.
+///
+/// Timers more than 64^4 ticks away are parked in the last level, and cascade
+/// back into it until they're in range.
+class timer_wheel {
+private:
+    static constexpr uint32_t slot_bits = 6;
+    static constexpr uint32_t slot_count = 1 << slot_bits;
+    static constexpr uint32_t level_count = 4;
+
+    wheel_timer *slots[level_count][slot_count];
+    uint64_t occupied[level_count];
+    wheel_timer *overdue;
+    uint64_t resolution;
+    uint64_t current;
+    size_t count;
+
+    void place(wheel_timer *timer);
+    wheel_timer* take(uint32_t level, uint32_t slot);
+    uint64_t next_tick(uint64_t from) const;
+
+public:
+    /// @param resolution   The length of a tick.
+    explicit timer_wheel(uint64_t resolution);
+
+    timer_wheel(const timer_wheel&) = delete;
+    timer_wheel& operator=(const timer_wheel&) = delete;
+
+    /// Adds a timer that expires once the time reaches deadline. Deadlines in
+    /// the past expire on the next call to advance().
+    void add(wheel_timer *timer, uint64_t deadline);
+
+    /// Removes a timer. Does nothing if the timer isn't in the wheel.
+    void remove(wheel_timer *timer);
+
+    /// Moves the wheel forward to now, removing the timers that have expired.
+    /// Moving an empty wheel is cheap, no matter how much time has passed.
+    /// @returns The expired timers, linked through next, in order of
+    ///          expiration. Null if no timers have expired.
+    wheel_timer* advance(uint64_t now);
+
+    /// Removes every timer, whatever its deadline.
+    /// @returns The removed timers, linked through next, in no particular
+    ///          order. Null if the wheel was empty.
+    wheel_timer* clear();
+
+    /// Returns the time advance() should next be called. This is a lower bound
+    /// on the next expiration, some calls may only cascade timers. Returns
+    /// UINT64_MAX if the wheel is empty.
+    uint64_t next_deadline() const;
+
+    /// The number of timers in the wheel.
+    size_t size() const {
+        return count;
+    }
+};
+
+} // namespace nvim
+
+#endif // TIMER_WHEEL_HPP
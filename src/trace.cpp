@@ -0,0 +1,225 @@
+//
+//  Neovim Mac
+//  trace.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "trace.hpp"
+
+namespace nvim {
+
+std::atomic<bool> trace_enabled(false);
+
+namespace {
+
+/// Owns the trace buffers of every thread that has recorded a span.
+/// Buffers live for the life of the process, so readers never race with
+/// thread exit. The number of threads we trace is small and bounded: the main
+/// thread, the IO queues, and the dispatch worker pool.
+struct trace_registry {
+    std::mutex lock;
+    std::vector<std::unique_ptr<trace_buffer>> buffers;
+    std::atomic<uint64_t> started_at{0};
+};
+
+trace_registry& registry() {
+    static trace_registry *instance = new trace_registry;
+    return *instance;
+}
+
+std::string current_thread_name(uint32_t thread) {
+    char name[64] = {};
+    pthread_getname_np(pthread_self(), name, sizeof(name));
+
+    if (name[0]) {
+        return name;
+    }
+
+    return "thread " + std::to_string(thread);
+}
+
+void append_json_string(std::string &out, std::string_view string) {
+    out.push_back('"');
+
+    for (char c : string) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n";  break;
+            case '\t': out += "\\t";  break;
+
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out.push_back(c);
+                }
+        }
+    }
+
+    out.push_back('"');
+}
+
+} // namespace
+
+void trace_buffer::copy(std::vector<trace_event> &events, uint64_t since) const {
+    uint64_t last = committed.load(std::memory_order_acquire);
+    uint64_t first = last > capacity ? last - capacity : 0;
+    size_t offset = events.size();
+
+    for (uint64_t index=first; index<last; ++index) {
+        const slot &s = slots[index % capacity];
+
+        trace_event event;
+        event.name = s.name.load(std::memory_order_relaxed);
+        event.begin = s.begin.load(std::memory_order_relaxed);
+        event.end = s.end.load(std::memory_order_relaxed);
+        event.thread = thread;
+        events.push_back(event);
+    }
+
+    // Any slot the writer claimed while we were copying may be torn.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t overwritten = claimed.load(std::memory_order_relaxed);
+
+    if (overwritten > first + capacity) {
+        uint64_t torn = std::min(overwritten - capacity, last) - first;
+        events.erase(events.begin() + offset, events.begin() + offset + torn);
+    }
+
+    events.erase(std::remove_if(events.begin() + offset, events.end(),
+                                [since](const trace_event &event) {
+                                    return event.begin < since;
+                                }), events.end());
+}
+
+trace_buffer& trace_local_buffer() {
+    thread_local trace_buffer *local = nullptr;
+
+    if (!local) {
+        trace_registry &reg = registry();
+        std::lock_guard guard(reg.lock);
+
+        uint32_t thread = static_cast<uint32_t>(reg.buffers.size() + 1);
+        reg.buffers.push_back(
+            std::make_unique<trace_buffer>(thread, current_thread_name(thread)));
+
+        local = reg.buffers.back().get();
+    }
+
+    return *local;
+}
+
+void trace_start() {
+    registry().started_at.store(trace_clock(), std::memory_order_relaxed);
+    trace_enabled.store(true, std::memory_order_relaxed);
+}
+
+void trace_stop() {
+    trace_enabled.store(false, std::memory_order_relaxed);
+}
+
+std::vector<trace_event> trace_snapshot() {
+    trace_registry &reg = registry();
+    uint64_t since = reg.started_at.load(std::memory_order_relaxed);
+    std::vector<trace_event> events;
+
+    {
+        std::lock_guard guard(reg.lock);
+
+        for (const auto &buffer : reg.buffers) {
+            buffer->copy(events, since);
+        }
+    }
+
+    std::stable_sort(events.begin(), events.end(),
+                     [](const trace_event &left, const trace_event &right) {
+                         return left.begin < right.begin;
+                     });
+
+    return events;
+}
+
+std::string trace_json() {
+    trace_registry &reg = registry();
+    std::vector<trace_event> events = trace_snapshot();
+    uint64_t origin = reg.started_at.load(std::memory_order_relaxed);
+    long pid = getpid();
+
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    char buffer[256];
+    bool first = true;
+
+    auto separator = [&]() {
+        if (!first) {
+            out += ",\n";
+        }
+
+        first = false;
+    };
+
+    {
+        std::lock_guard guard(reg.lock);
+
+        for (const auto &buffer_ptr : reg.buffers) {
+            separator();
+            snprintf(buffer, sizeof(buffer),
+                     "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":%u,"
+                     "\"args\":{\"name\":", pid, buffer_ptr->thread_id());
+
+            out += buffer;
+            append_json_string(out, buffer_ptr->thread_name());
+            out += "}}";
+        }
+    }
+
+    for (const trace_event &event : events) {
+        separator();
+        out += "{\"name\":";
+        append_json_string(out, event.name);
+
+        snprintf(buffer, sizeof(buffer),
+                 ",\"ph\":\"X\",\"pid\":%ld,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                 pid, event.thread,
+                 (event.begin - origin) / 1e3,
+                 (event.end - event.begin) / 1e3);
+
+        out += buffer;
+    }
+
+    out += "]}\n";
+    return out;
+}
+
+int trace_write(const char *path) {
+    std::string json = trace_json();
+    FILE *file = fopen(path, "w");
+
+    if (!file) {
+        return errno;
+    }
+
+    size_t written = fwrite(json.data(), 1, json.size(), file);
+    int error = written == json.size() ? 0 : errno;
+
+    if (fclose(file) && !error) {
+        error = errno;
+    }
+
+    return error;
+}
+
+} // namespace nvim
@@ -0,0 +1,162 @@
+//
+//  Neovim Mac
+//  trace.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nvim {
+
+/// Returns the current time in nanoseconds, from a monotonic clock.
+/// This is the same clock as latency_clock(), so timestamps can be shared.
+inline uint64_t trace_clock() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+/// A completed trace span.
+struct trace_event {
+    const char *name;   ///< Span name, a string with static storage duration.
+    uint64_t begin;     ///< Start time, in trace_clock() nanoseconds.
+    uint64_t end;       ///< End time, in trace_clock() nanoseconds.
+    uint32_t thread;    ///< Trace thread ID of the recording thread.
+};
+
+/// A fixed size ring of trace events, written by a single thread.
+///
+/// Writers never block and never allocate. Once full, the oldest events are
+/// overwritten. Readers on other threads copy the ring without taking a lock,
+/// events that were overwritten while being copied are discarded.
+class trace_buffer {
+public:
+    static constexpr size_t capacity = 8192;
+
+private:
+    struct slot {
+        std::atomic<const char*> name;
+        std::atomic<uint64_t> begin;
+        std::atomic<uint64_t> end;
+    };
+
+    // Writers bump claimed before touching a slot and committed after. Events
+    // below committed are complete, and a copied event is only valid if its
+    // slot wasn't claimed again while we were reading it.
+    std::atomic<uint64_t> claimed;
+    std::atomic<uint64_t> committed;
+    std::array<slot, capacity> slots;
+    uint32_t thread;
+    std::string name;
+
+public:
+    trace_buffer(uint32_t thread, std::string name):
+        claimed(0), committed(0), thread(thread), name(std::move(name)) {}
+
+    trace_buffer(const trace_buffer&) = delete;
+    trace_buffer& operator=(const trace_buffer&) = delete;
+
+    /// Records an event. Must only be called by the owning thread.
+    void push(const char *name, uint64_t begin, uint64_t end) {
+        uint64_t index = committed.load(std::memory_order_relaxed);
+        slot &s = slots[index % capacity];
+
+        claimed.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        s.name.store(name, std::memory_order_relaxed);
+        s.begin.store(begin, std::memory_order_relaxed);
+        s.end.store(end, std::memory_order_relaxed);
+
+        committed.store(index + 1, std::memory_order_release);
+    }
+
+    /// Appends a snapshot of the buffer to events. Safe to call from any thread.
+    /// @param since    Events that began before this time are skipped.
+    void copy(std::vector<trace_event> &events, uint64_t since) const;
+
+    /// The trace thread ID of the owning thread.
+    uint32_t thread_id() const {
+        return thread;
+    }
+
+    /// The name of the owning thread.
+    const std::string& thread_name() const {
+        return name;
+    }
+};
+
+/// Whether tracing is enabled. Use trace_start() and trace_stop().
+extern std::atomic<bool> trace_enabled;
+
+/// Returns the calling thread's trace buffer, creating it if necessary.
+trace_buffer& trace_local_buffer();
+
+/// Records a span on the calling thread, if tracing is enabled.
+/// @param name     The span name. Must have static storage duration.
+/// @param begin    Start time, in trace_clock() nanoseconds.
+/// @param end      End time, in trace_clock() nanoseconds.
+inline void trace_record(const char *name, uint64_t begin, uint64_t end) {
+    if (trace_enabled.load(std::memory_order_relaxed)) {
+        trace_local_buffer().push(name, begin, end);
+    }
+}
+
+/// Records a span covering its lifetime.
+///
+/// When tracing is disabled, a trace_span costs a relaxed load and a branch.
+/// Spans that are alive when tracing is enabled are not recorded.
+class trace_span {
+private:
+    const char *name;
+    uint64_t begin;
+
+public:
+    /// @param name The span name. Must have static storage duration.
+    explicit trace_span(const char *name): name(name), begin(0) {
+        if (trace_enabled.load(std::memory_order_relaxed)) {
+            begin = trace_clock();
+        }
+    }
+
+    trace_span(const trace_span&) = delete;
+    trace_span& operator=(const trace_span&) = delete;
+
+    ~trace_span() {
+        if (begin) {
+            trace_record(name, begin, trace_clock());
+        }
+    }
+};
+
+/// Discards previously recorded spans and starts tracing.
+void trace_start();
+
+/// Stops tracing. Recorded spans are kept until the next trace_start().
+void trace_stop();
+
+/// Returns a snapshot of the spans recorded since trace_start(), from all
+/// threads, ordered by start time.
+std::vector<trace_event> trace_snapshot();
+
+/// Returns the recorded spans in the Chrome trace event JSON format.
+/// The output can be loaded by chrome://tracing and ui.perfetto.dev.
+std::string trace_json();
+
+/// Writes trace_json() to a file.
+/// @returns An errno code if an error occurred, 0 if no error occurred.
+int trace_write(const char *path);
+
+} // namespace nvim
+
+#endif // TRACE_HPP
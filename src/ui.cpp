@@ -151,6 +151,7 @@ void ui_controller::redraw_event(const msg::object &event_object) {
     const msg::array *event = event_object.get_if<msg::array>();
     
     if (!event || !event->size() || !event->at(0).is<msg::string>()) {
+        stats.add_event(redraw_event_type::unknown, 0, 0);
         return os_log_error(rpc, "Redraw error: Event type error - Type=%s",
                             msg::type_string(event_object).c_str());
     }
@@ -160,31 +161,49 @@ void ui_controller::redraw_event(const msg::object &event_object) {
     //  - The remainining elements are an array of argument tuples.
     msg::string name = event->at(0).get<msg::string>();
     msg::array args = event->subarray(1);
-    
+
+    uint64_t start = latency_clock();
+    redraw_event_type type = apply_event(name, args);
+    stats.add_event(type, args.size(), latency_clock() - start);
+}
+
+redraw_event_type ui_controller::apply_event(msg::string name, msg::array args) {
     if (name == "grid_line") {
-        return apply(this, &ui_controller::grid_line, name, args);
+        apply(this, &ui_controller::grid_line, name, args);
+        return redraw_event_type::grid_line;
     } else if (name == "grid_resize") {
-        return apply(this, &ui_controller::grid_resize, name, args);
+        apply(this, &ui_controller::grid_resize, name, args);
+        return redraw_event_type::grid_resize;
     } else if (name == "grid_scroll") {
-        return apply(this, &ui_controller::grid_scroll, name, args);
+        apply(this, &ui_controller::grid_scroll, name, args);
+        return redraw_event_type::grid_scroll;
     } else if (name == "flush") {
-        return apply(this, &ui_controller::flush, name, args);
+        apply(this, &ui_controller::flush, name, args);
+        return redraw_event_type::flush;
     } else if (name == "grid_clear") {
-        return apply(this, &ui_controller::grid_clear, name, args);
+        apply(this, &ui_controller::grid_clear, name, args);
+        return redraw_event_type::grid_clear;
     } else if (name == "hl_attr_define") {
-        return apply(this, &ui_controller::hl_attr_define, name, args);
+        apply(this, &ui_controller::hl_attr_define, name, args);
+        return redraw_event_type::hl_attr_define;
     } else if (name == "default_colors_set") {
-        return apply(this, &ui_controller::default_colors_set, name, args);
+        apply(this, &ui_controller::default_colors_set, name, args);
+        return redraw_event_type::default_colors_set;
     } else if (name == "mode_info_set") {
-        return apply(this, &ui_controller::mode_info_set, name, args);
+        apply(this, &ui_controller::mode_info_set, name, args);
+        return redraw_event_type::mode_info_set;
     } else if (name == "mode_change") {
-        return apply(this, &ui_controller::mode_change, name, args);
+        apply(this, &ui_controller::mode_change, name, args);
+        return redraw_event_type::mode_change;
     } else if (name == "grid_cursor_goto") {
-        return apply(this, &ui_controller::grid_cursor_goto, name, args);
+        apply(this, &ui_controller::grid_cursor_goto, name, args);
+        return redraw_event_type::grid_cursor_goto;
     } else if (name == "tabline_update") {
-        return apply(this, &ui_controller::tabline_update, name, args);
+        apply(this, &ui_controller::tabline_update, name, args);
+        return redraw_event_type::tabline_update;
     } else if (name == "set_title") {
-        return apply(this, &ui_controller::set_title, name, args);
+        apply(this, &ui_controller::set_title, name, args);
+        return redraw_event_type::set_title;
     }
 
     // When options change, we should inform the delegate. Neovim tends to
@@ -199,7 +218,7 @@ void ui_controller::redraw_event(const msg::object &event_object) {
             window.options_set();
         }
         
-        return;
+        return redraw_event_type::option_set;
     }
 
     // The following events are ignored for now.
@@ -208,15 +227,19 @@ void ui_controller::redraw_event(const msg::object &event_object) {
         name == "set_icon"     ||
         name == "hl_group_set" ||
         name == "win_viewport" ) {
-        return;
+        return redraw_event_type::ignored;
     }
     
     os_log_info(rpc, "Redraw info: Unhandled event - Name=%.*s Args=%s",
                 (int)std::min(name.size(), 128ul), name.data(),
                 msg::to_string(args).c_str());
+
+    return redraw_event_type::unknown;
 }
 
 void ui_controller::redraw(msg::array events) {
+    trace_span span("redraw");
+
     for (const msg::object &event : events) {
         redraw_event(event);
     }
@@ -227,6 +250,12 @@ void ui_controller::grid_resize(size_t grid_id, size_t width, size_t height) {
     grid->grid_width = width;
     grid->grid_height = height;
     grid->cells.resize(width * height);
+    grid->row_emphasis.assign(height, 0);
+    grid->emphasis_total = 0;
+
+    for (size_t row=0; row<height; ++row) {
+        grid->count_row_emphasis(row);
+    }
 }
 
 template<typename ...Ts>
@@ -313,20 +342,34 @@ void ui_controller::grid_line(size_t grid_id, size_t row,
             
             nvim::cell *left = cell - 1;
             left->attrs.flags |= cell_attributes::doublewidth;
+            long emphasis_delta = left->line_emphasis_count() -
+                                  (long)cell->line_emphasis_count();
+
             cell->attrs = left->attrs;
             cell->size = 0;
+            grid->add_row_emphasis(row, emphasis_delta);
+            stats.add_cells(redraw_event_type::grid_line, 1, 0);
 
             // Double width chars never repeat.
             cell += 1;
             remaining -= 1;
         } else if (update.repeat > 0) {
             const auto updated = nvim::cell(update.text, update.hlattr);
-            *cell = updated;
+            const long updated_emphasis = updated.line_emphasis_count();
+
+            // Track the change in the row's line emphasis count as we go.
+            // Cells are rarely emphasized, so this is cheaper than recounting
+            // the row afterwards.
+            long emphasis_delta = 0;
 
-            for (int i=1; i<update.repeat; ++i) {
+            for (int i=0; i<update.repeat; ++i) {
+                emphasis_delta += updated_emphasis - cell[i].line_emphasis_count();
                 cell[i] = updated;
             }
 
+            grid->add_row_emphasis(row, emphasis_delta);
+            stats.add_cells(redraw_event_type::grid_line, update.repeat, update.text.size());
+
             cell += update.repeat;
             remaining -= update.repeat;
         }
@@ -342,6 +385,9 @@ void ui_controller::grid_clear(size_t grid_id) {
     for (cell &cell : grid->cells) {
         cell = empty;
     }
+
+    std::fill(grid->row_emphasis.begin(), grid->row_emphasis.end(), 0);
+    grid->emphasis_total = 0;
 }
 
 void ui_controller::grid_cursor_goto(size_t grid_id, size_t row, size_t col) {
@@ -398,12 +444,22 @@ void ui_controller::grid_scroll(size_t grid_id, size_t top, size_t bottom,
         dest += row_width;
         src += row_width;
     }
+
+    // Scrolled regions may be narrower than the grid, so we recount rows
+    // rather than moving row counts along with the cells.
+    size_t dest_row = rows >= 0 ? top : bottom - count;
+
+    for (long i=0; i<count; ++i) {
+        grid->count_row_emphasis(dest_row + i);
+    }
 }
 
 void ui_controller::flush() {
+    trace_span span("flush");
     grid *completed = writing;
     completed->draw_tick += 1;
-    
+    latency.flush(completed->draw_tick);
+
     writing = complete.exchange(completed);
     *writing = *completed;
 
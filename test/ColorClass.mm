@@ -0,0 +1,33 @@
+//
+//  Neovim Mac Test
+//  ColorClass.mm
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <XCTest/XCTest.h>
+#include "color_class.hpp"
+#include "RecordedSession.h"
+
+@interface testColorClass : XCTestCase
+@end
+
+@implementation testColorClass
+
+- (void)testReplayedSessionReport {
+    recorded_session session;
+    color_class_stats stats;
+
+    auto observer = [&](const nvim::grid &grid) {
+        stats.add(grid.begin(), grid.end());
+    };
+
+    XCTAssertGreaterThan(session.replay(observer), 0);
+    XCTAssertGreaterThan(stats.exact_entries(), 0);
+    XCTAssertLessThanOrEqual(stats.class_entries(), stats.exact_entries());
+    NSLog(@"%s", stats.report().c_str());
+}
+
+@end
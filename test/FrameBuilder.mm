@@ -0,0 +1,125 @@
+//
+//  Neovim Mac Test
+//  FrameBuilder.mm
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <map>
+#include <vector>
+#include <XCTest/XCTest.h>
+#include "frame_builder.hpp"
+#include "RecordedSession.h"
+#include "portable/frame_helpers.hpp"
+
+// Tests of the frame builder on its own are in portable/FrameBuilder.cpp.
+
+@interface testFrameBuilder : XCTestCase
+@end
+
+@implementation testFrameBuilder
+
+- (void)testParallelUsesRowLineCounts {
+    using attr_map = std::map<std::string_view, bool>;
+
+    // A grid built by a ui_controller, with underlined and struck through
+    // text on every 7th row.
+    msg::packer packer;
+    packer.start_array(3);
+    packer.pack(2);
+    packer.pack("redraw");
+    packer.start_array(3 + 100 / 7 + 1);
+    packer.pack(std::make_tuple("grid_resize", std::make_tuple(1, 400, 100)));
+    packer.pack(std::make_tuple("hl_attr_define",
+        std::make_tuple(1, attr_map{{"underline", true}, {"strikethrough", true}},
+                        attr_map{}, std::vector<int>())));
+
+    for (int row=0; row<100; row += 7) {
+        packer.pack(std::make_tuple("grid_line",
+            std::make_tuple(1, row, 10, std::make_tuple(std::make_tuple("x", 1, 50)))));
+    }
+
+    packer.pack(std::make_tuple("flush", std::tuple<>()));
+
+    nvim::headless_ui headless(nvim::headless_ui::flush_record::none);
+    headless.feed(packer.data(), packer.size());
+    const nvim::grid &grid = *headless.controller().get_global_grid();
+    XCTAssertEqual(grid.line_emphasis_count(), 15 * 50 * 2);
+
+    frame_builder builder;
+    frame_counts counted = builder.count(adjusted_grid(grid), apply_auto);
+    XCTAssertEqual(counted.lines, grid.line_emphasis_count());
+
+    std::vector<background_data> backgrounds(counted.backgrounds);
+    std::vector<glyph_data> glyphs(counted.glyphs);
+    std::vector<line_data> lines(counted.lines);
+
+    test_glyph_source source;
+    frame_counts counts = builder.build(adjusted_grid(grid), backgrounds.data(),
+                                        glyphs.data(), nullptr, lines.data(),
+                                        source, apply_auto);
+
+    XCTAssertEqual(counts.lines, grid.line_emphasis_count());
+    XCTAssertEqual(counts.glyphs, 15 * 50);
+
+    // Lines are in row order across bands.
+    for (size_t i=1; i<counts.lines; ++i) {
+        XCTAssertLessThanOrEqual(lines[i - 1].grid_position.y, lines[i].grid_position.y);
+    }
+}
+
+- (void)testReplayedSessionPerformance {
+    recorded_session session;
+    std::vector<nvim::grid> grids;
+
+    auto observer = [&](const nvim::grid &grid) {
+        grids.push_back(grid);
+    };
+
+    XCTAssertGreaterThan(session.replay(observer), 0);
+
+    size_t max_cells = 0;
+    size_t max_lines = 0;
+
+    for (const nvim::grid &grid : grids) {
+        max_cells = std::max(max_cells, grid.cells_size());
+        max_lines = std::max(max_lines, grid.line_emphasis_count());
+    }
+
+    __block std::vector<background_data> backgrounds(max_cells);
+    __block std::vector<glyph_data> glyphs(max_cells);
+    __block std::vector<line_data> lines(max_lines);
+    frame_builder builder;
+
+    auto get_glyph = [](const nvim::cell &cell, simd_short2 gridpos) {
+        return glyph_data(gridpos, cell.width(), glyph_rect());
+    };
+
+    // Before spans, every cell was its own background instance.
+    size_t cells = 0;
+    size_t spans = 0;
+
+    for (const nvim::grid &grid : grids) {
+        frame_counts counts = builder.build(adjusted_grid(grid, grid.cursor()),
+                                            backgrounds.data(), glyphs.data(),
+                                            nullptr, lines.data(), get_glyph);
+
+        cells += grid.cells_size();
+        spans += counts.backgrounds;
+    }
+
+    XCTAssertLessThan(spans, cells);
+    NSLog(@"%zu frames: %zu background spans, %zu per cell instances (%.1f%%)",
+          grids.size(), spans, cells, 100.0 * spans / cells);
+
+    [self measureBlock:^{
+        for (const nvim::grid &grid : grids) {
+            builder.build(adjusted_grid(grid, grid.cursor()), backgrounds.data(),
+                          glyphs.data(), nullptr, lines.data(), get_glyph);
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,124 @@
+//
+//  Neovim Mac Test
+//  Grid.mm
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <map>
+#include <tuple>
+#include <vector>
+#include <XCTest/XCTest.h>
+#include "ui.hpp"
+
+using attr_map = std::map<std::string_view, bool>;
+using empty_array = std::vector<int>;
+
+/// Packs events into a redraw notification and sends it to the controller.
+template<typename ...Events>
+static void redraw(nvim::ui_controller &ui, const Events& ...events) {
+    msg::packer packer;
+    packer.pack(std::make_tuple(events...));
+
+    msg::unpacker unpacker;
+    unpacker.feed(packer.data(), packer.size());
+
+    msg::object *object = unpacker.unpack();
+    ui.redraw(object->get<msg::array>());
+    unpacker.unpack();
+}
+
+static auto flush() {
+    return std::make_tuple("flush", std::tuple<>());
+}
+
+@interface testGrid : XCTestCase
+@end
+
+@implementation testGrid {
+    nvim::ui_controller ui;
+}
+
+- (void)setUp {
+    [super setUp];
+    ui.window = nvim::window_controller(nullptr);
+
+    redraw(ui,
+        std::make_tuple("grid_resize", std::make_tuple(1, 10, 4)),
+        std::make_tuple("hl_attr_define",
+            std::make_tuple(1, attr_map{{"underline", true}}, attr_map{}, empty_array{}),
+            std::make_tuple(2, attr_map{{"undercurl", true}, {"strikethrough", true}},
+                            attr_map{}, empty_array{})),
+        std::make_tuple("grid_line",
+            std::make_tuple(1, 0, 0, std::make_tuple(std::make_tuple("a", 1, 5))),
+            std::make_tuple(1, 1, 2, std::make_tuple(std::make_tuple("b", 2, 3)))),
+        flush());
+}
+
+- (void)testLineEmphasisCount {
+    const nvim::grid *grid = ui.get_global_grid();
+
+    XCTAssertEqual(grid->line_emphasis_count(0), 5);
+    XCTAssertEqual(grid->line_emphasis_count(1), 6);
+    XCTAssertEqual(grid->line_emphasis_count(2), 0);
+    XCTAssertEqual(grid->line_emphasis_count(), 11);
+}
+
+- (void)testLineEmphasisCountOverwrite {
+    redraw(ui,
+        std::make_tuple("grid_line",
+            std::make_tuple(1, 0, 3, std::make_tuple(std::make_tuple("c", 0, 4))),
+            std::make_tuple(1, 1, 0, std::make_tuple(std::make_tuple("d", 1, 3)))),
+        flush());
+
+    const nvim::grid *grid = ui.get_global_grid();
+    XCTAssertEqual(grid->line_emphasis_count(0), 3);
+    XCTAssertEqual(grid->line_emphasis_count(1), 7);
+    XCTAssertEqual(grid->line_emphasis_count(), 10);
+}
+
+- (void)testLineEmphasisCountScroll {
+    redraw(ui, std::make_tuple("grid_scroll", std::make_tuple(1, 0, 4, 0, 10, 1)), flush());
+
+    const nvim::grid *grid = ui.get_global_grid();
+    XCTAssertEqual(grid->line_emphasis_count(0), 6);
+    XCTAssertEqual(grid->line_emphasis_count(1), 0);
+    XCTAssertEqual(grid->line_emphasis_count(), 6);
+
+    redraw(ui, std::make_tuple("grid_scroll", std::make_tuple(1, 0, 4, 0, 10, -2)), flush());
+
+    grid = ui.get_global_grid();
+    XCTAssertEqual(grid->line_emphasis_count(2), 6);
+    XCTAssertEqual(grid->line_emphasis_count(), 12);
+}
+
+- (void)testLineEmphasisCountPartialScroll {
+    redraw(ui, std::make_tuple("grid_scroll", std::make_tuple(1, 0, 2, 0, 3, 1)), flush());
+
+    // Only the first 3 columns moved. Row 0 keeps two underlines from cells
+    // 3 and 4, and gains the undercurl and strikethrough of cell 2 from row 1.
+    const nvim::grid *grid = ui.get_global_grid();
+    XCTAssertEqual(grid->line_emphasis_count(0), 4);
+    XCTAssertEqual(grid->line_emphasis_count(), 10);
+}
+
+- (void)testLineEmphasisCountClear {
+    redraw(ui, std::make_tuple("grid_clear", std::make_tuple(1)), flush());
+
+    const nvim::grid *grid = ui.get_global_grid();
+    XCTAssertEqual(grid->line_emphasis_count(), 0);
+}
+
+- (void)testLineEmphasisCountResize {
+    redraw(ui, std::make_tuple("grid_resize", std::make_tuple(1, 5, 4)), flush());
+
+    // Resizing reflows the cell vector, the first 5 cells remain in row 0.
+    const nvim::grid *grid = ui.get_global_grid();
+    XCTAssertEqual(grid->line_emphasis_count(0), 5);
+    XCTAssertEqual(grid->line_emphasis_count(2), 6);
+    XCTAssertEqual(grid->line_emphasis_count(), 11);
+}
+
+@end
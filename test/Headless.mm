@@ -0,0 +1,146 @@
+//
+//  Neovim Mac Test
+//  Headless.mm
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <XCTest/XCTest.h>
+#include "headless.hpp"
+
+using attr_map = std::map<std::string_view, int>;
+using empty_array = std::vector<int>;
+
+/// Packs events into a redraw notification.
+template<typename ...Events>
+static void redraw(msg::packer &packer, const Events& ...events) {
+    packer.pack(std::make_tuple(2, "redraw", std::make_tuple(events...)));
+}
+
+static auto flush() {
+    return std::make_tuple("flush", std::tuple<>());
+}
+
+/// A recorded session: two flushed frames, and a non redraw notification.
+static msg::packer make_stream() {
+    msg::packer packer;
+
+    redraw(packer,
+        std::make_tuple("grid_resize", std::make_tuple(1, 6, 2)),
+        std::make_tuple("default_colors_set", std::make_tuple(0xFFFFFF, 0x000000, 0xFF0000)),
+        std::make_tuple("hl_attr_define",
+            std::make_tuple(1, attr_map{{"bold", true}, {"foreground", 0x102030}},
+                            attr_map{}, empty_array{})),
+        std::make_tuple("grid_line",
+            std::make_tuple(1, 0, 0, std::make_tuple(std::make_tuple("a", 0),
+                                                     std::make_tuple("b", 1, 2)))),
+        std::make_tuple("grid_cursor_goto", std::make_tuple(1, 1, 3)),
+        flush());
+
+    packer.pack(std::make_tuple(2, "nvim_buf_lines_event", std::tuple<>()));
+
+    redraw(packer,
+        std::make_tuple("grid_line",
+            std::make_tuple(1, 1, 0, std::make_tuple(std::make_tuple("c", 0, 3)))),
+        flush());
+
+    return packer;
+}
+
+@interface testHeadless : XCTestCase
+@end
+
+@implementation testHeadless
+
+- (void)testGridDumps {
+    msg::packer stream = make_stream();
+    nvim::headless_ui headless(nvim::headless_ui::flush_record::dump);
+    headless.feed(stream.data(), stream.size());
+
+    XCTAssertEqual(headless.flush_count(), 2);
+    XCTAssertEqual(headless.ignored_count(), 1);
+    XCTAssertEqual(headless.dumps().size(), 2);
+    XCTAssertEqual(headless.hashes().size(), 2);
+
+    // Cells that were never drawn have zeroed attributes.
+    std::string expected =
+        "grid 6x2 cursor 1,3\n"
+        "abb   \n"
+        "      \n"
+        "row 0: 0-0 fg=ffffff bg=000000 sp=ff0000;"
+        " 1-2 fg=102030 bg=000000 sp=ff0000 bold;"
+        " 3-5 fg=000000 bg=000000 sp=000000\n"
+        "row 1: 0-5 fg=000000 bg=000000 sp=000000\n";
+
+    XCTAssert(headless.dumps()[0] == expected);
+    XCTAssertNotEqual(headless.hashes()[0], headless.hashes()[1]);
+
+    const nvim::grid *grid = headless.controller().get_global_grid();
+    XCTAssertEqual(headless.hashes()[1], nvim::grid_hash(*grid));
+    XCTAssert(headless.dumps()[1] == nvim::grid_dump(*grid));
+}
+
+- (void)testSplitFeeds {
+    msg::packer stream = make_stream();
+    nvim::headless_ui whole;
+    whole.feed(stream.data(), stream.size());
+
+    // Messages split at any byte boundary produce the same frames.
+    for (size_t split : {1, 3, 7, 64}) {
+        nvim::headless_ui headless;
+
+        for (size_t i=0; i<stream.size(); i += split) {
+            headless.feed(stream.data() + i, std::min(split, stream.size() - i));
+        }
+
+        XCTAssertEqual(headless.flush_count(), 2);
+        XCTAssertEqual(headless.ignored_count(), 1);
+        XCTAssert(headless.hashes() == whole.hashes());
+    }
+}
+
+- (void)testEventTimings {
+    msg::packer stream = make_stream();
+    nvim::headless_ui headless(nvim::headless_ui::flush_record::none);
+    headless.feed(stream.data(), stream.size());
+
+    auto &timings = headless.event_timings();
+    XCTAssertEqual(timings.at("grid_line").count, 2);
+    XCTAssertEqual(timings.at("flush").count, 2);
+    XCTAssertEqual(timings.at("grid_resize").count, 1);
+    XCTAssertEqual(timings.count("nvim_buf_lines_event"), 0);
+
+    XCTAssertEqual(headless.flush_count(), 2);
+    XCTAssertTrue(headless.hashes().empty());
+    XCTAssertTrue(headless.timing_report().find("grid_line") != std::string::npos);
+}
+
+- (void)testReplayPerformance {
+    msg::packer packer;
+
+    redraw(packer, std::make_tuple("grid_resize", std::make_tuple(1, 200, 60)), flush());
+
+    for (int frame=0; frame<100; ++frame) {
+        for (int row=0; row<60; ++row) {
+            redraw(packer,
+                std::make_tuple("grid_line",
+                    std::make_tuple(1, row, 0, std::make_tuple(std::make_tuple("x", 0, 200)))));
+        }
+
+        redraw(packer, std::make_tuple("grid_scroll", std::make_tuple(1, 0, 60, 0, 200, 1)),
+               flush());
+    }
+
+    [self measureBlock:^{
+        nvim::headless_ui headless;
+        headless.feed(packer.data(), packer.size());
+    }];
+}
+
+@end
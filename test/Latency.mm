@@ -0,0 +1,69 @@
+//
+//  Neovim Mac Test
+//  Latency.mm
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <tuple>
+#include <XCTest/XCTest.h>
+#include "latency.hpp"
+#include "ui.hpp"
+
+/// Packs events into a redraw notification and sends it to the controller.
+template<typename ...Events>
+static void redraw(nvim::ui_controller &ui, const Events& ...events) {
+    msg::packer packer;
+    packer.pack(std::make_tuple(events...));
+
+    msg::unpacker unpacker;
+    unpacker.feed(packer.data(), packer.size());
+
+    msg::object *object = unpacker.unpack();
+    ui.redraw(object->get<msg::array>());
+}
+
+static auto flush() {
+    return std::make_tuple("flush", std::tuple<>());
+}
+
+@interface testLatency : XCTestCase
+@end
+
+@implementation testLatency
+
+- (void)testEchoedInput {
+    nvim::ui_controller ui;
+    ui.window = nvim::window_controller(nullptr);
+
+    redraw(ui, std::make_tuple("grid_resize", std::make_tuple(1, 10, 2)), flush());
+    XCTAssertEqual(ui.latency.flush_latency().count(), 0);
+
+    // A fake Neovim echoes each key back in a grid_line and flushes.
+    const char *keys[] = {"a", "b", "c"};
+
+    for (int i=0; i<3; ++i) {
+        ui.latency.input();
+
+        redraw(ui,
+            std::make_tuple("grid_line",
+                std::make_tuple(1, 0, i, std::make_tuple(std::make_tuple(keys[i], 0)))),
+            flush());
+
+        const nvim::grid *grid = ui.get_global_grid();
+        XCTAssertEqual(grid->get(0, i)->grapheme_view(), std::string_view(keys[i]));
+        ui.latency.present(grid->tick());
+    }
+
+    nvim::latency_histogram flushes = ui.latency.flush_latency();
+    nvim::latency_histogram presents = ui.latency.present_latency();
+
+    XCTAssertEqual(flushes.count(), 3);
+    XCTAssertEqual(presents.count(), 3);
+    XCTAssertLessThanOrEqual(flushes.max(), presents.max());
+    XCTAssertTrue(ui.latency.report().find("count=3") != std::string::npos);
+}
+
+@end
@@ -0,0 +1,77 @@
+//
+//  Neovim Mac Test
+//  PortableTests.mm
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <objc/runtime.h>
+#include <XCTest/XCTest.h>
+#include "portable/check.hpp"
+
+// Runs the tests in portable/ under XCTest. Each test becomes a method of
+// the test<Suite> class, which is created unless an XCTest file already
+// defines it for the suite's tests that need dispatch. Benchmarks run as
+// tests, like XCTest's own measureBlock tests.
+
+/// The test case running a portable test, failures are recorded against it.
+static XCTestCase *current_test;
+
+namespace check {
+
+registrar::registrar(const char *suite, const char *name,
+                     void (*function)(), bool benchmark) {
+    std::string class_name = std::string("test") + suite;
+    Class test_class = objc_getClass(class_name.c_str());
+
+    if (!test_class) {
+        test_class = objc_allocateClassPair([XCTestCase class], class_name.c_str(), 0);
+        objc_registerClassPair(test_class);
+    }
+
+    IMP implementation = imp_implementationWithBlock(^(XCTestCase *test) {
+        current_test = test;
+        function();
+        current_test = nil;
+    });
+
+    std::string method = std::string("test") + name;
+
+    if (!class_addMethod(test_class, sel_registerName(method.c_str()),
+                         implementation, "v@:")) {
+        fprintf(stderr, "%s.%s is defined twice\n", suite, name);
+        abort();
+    }
+}
+
+void fail(const char *file, int line, const std::string &message) {
+    NSString *filename = [NSString stringWithUTF8String:file];
+    NSString *description = [NSString stringWithUTF8String:message.c_str()];
+
+    XCTSourceCodeLocation *location = [[XCTSourceCodeLocation alloc] initWithFilePath:filename lineNumber:line];
+    XCTSourceCodeContext *sourceCodeContext = [[XCTSourceCodeContext alloc] initWithLocation:location];
+
+    XCTIssue *issue = [[XCTIssue alloc] initWithType:XCTIssueTypeAssertionFailure
+                                  compactDescription:description
+                                 detailedDescription:nil
+                                   sourceCodeContext:sourceCodeContext
+                                     associatedError:nil
+                                         attachments:@[]];
+
+    [current_test recordIssue:issue];
+}
+
+void measure(const std::function<void()> &function) {
+    const std::function<void()> *body = &function;
+
+    [current_test measureBlock:^{
+        (*body)();
+    }];
+}
+
+} // namespace check
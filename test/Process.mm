@@ -0,0 +1,947 @@
+//
+//  Neovim Mac Test
+//  Process.mm
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <XCTest/XCTest.h>
+#include "neovim.hpp"
+
+/// A fake Neovim server, listening on a Unix domain socket.
+class fake_server {
+private:
+    std::string path;
+    int listener;
+    int client;
+    char buffer[65536];
+    msg::unpacker unpacker;
+
+public:
+    fake_server(): listener(-1), client(-1) {
+        static int count = 0;
+        path = std::string(NSTemporaryDirectory().UTF8String) +
+               "nvim-" + std::to_string(getpid()) + "-" + std::to_string(count++);
+    }
+
+    fake_server(const fake_server&) = delete;
+    fake_server& operator=(const fake_server&) = delete;
+
+    ~fake_server() {
+        disconnect();
+
+        if (listener != -1) {
+            close(listener);
+            unlink(path.c_str());
+        }
+    }
+
+    /// Starts listening, returns the socket address.
+    const std::string& listen() {
+        // As in the app, writes to a disconnected server fail with EPIPE.
+        signal(SIGPIPE, SIG_IGN);
+
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+
+        sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        memcpy(addr.sun_path, path.data(), path.size());
+
+        unlink(path.c_str());
+        bind(listener, (sockaddr*)&addr, sizeof(addr));
+        ::listen(listener, 1);
+        return path;
+    }
+
+    void accept() {
+        client = ::accept(listener, nullptr, nullptr);
+    }
+
+    /// Closes the connection. Returns false if there was nothing to close.
+    bool disconnect() {
+        if (client == -1) {
+            return false;
+        }
+
+        close(client);
+        client = -1;
+        return true;
+    }
+
+    void send(const void *data, size_t size) {
+        const char *bytes = static_cast<const char*>(data);
+
+        while (size) {
+            ssize_t written = write(client, bytes, size);
+            if (written <= 0) return;
+
+            bytes += written;
+            size -= written;
+        }
+    }
+
+    void send(const msg::packer &packer) {
+        send(packer.data(), packer.size());
+    }
+
+    /// Blocks until a message arrives. Valid until the next call to receive.
+    msg::array receive() {
+        for (;;) {
+            if (msg::object *object = unpacker.unpack()) {
+                return object->get<msg::array>();
+            }
+
+            ssize_t bytes = read(client, buffer, sizeof(buffer));
+            if (bytes <= 0) return msg::array();
+
+            unpacker.feed(buffer, bytes);
+        }
+    }
+
+    /// Sends a successful response to the request with the given msgid.
+    template<typename T>
+    void respond(uint64_t msgid, const T &result) {
+        msg::packer packer;
+        packer.pack(std::make_tuple(1, msgid, nullptr, result));
+        send(packer);
+    }
+
+    /// Waits for the response to a request with the given msgid.
+    msg::array response(uint32_t msgid) {
+        for (;;) {
+            msg::array message = receive();
+
+            if (!message.size() || (message[0].get<msg::integer>() == 1 &&
+                                    message[1].get<msg::integer>() == msgid)) {
+                return message;
+            }
+        }
+    }
+};
+
+/// Returns a redraw notification with the given number of 200 cell lines.
+static msg::packer redraw_burst(int lines) {
+    msg::packer packer;
+    packer.start_array(3);
+    packer.pack(2);
+    packer.pack("redraw");
+    packer.start_array(2);
+    packer.start_array(lines + 1);
+    packer.pack("grid_line");
+
+    for (int i=0; i<lines; ++i) {
+        packer.start_array(4);
+        packer.pack(1);
+        packer.pack(i % 50);
+        packer.pack(0);
+
+        // The first cell of a line always has a highlight ID.
+        packer.start_array(200);
+        packer.pack(std::make_tuple("x", 0));
+
+        for (int j=1; j<200; ++j) {
+            packer.pack(std::make_tuple("x"));
+        }
+    }
+
+    packer.pack(std::make_tuple("flush", std::tuple<>()));
+    return packer;
+}
+
+/// Waits for the process to see its connection close.
+/// @returns False if it hasn't within 5 seconds.
+static bool wait_for_cancel(nvim::process &nvim) {
+    dispatch_time_t deadline = dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC);
+
+    // get_mode() times out after 100ms, so the loop checks the deadline.
+    while (nvim.get_mode() != nvim::mode::cancelled) {
+        if (dispatch_time(DISPATCH_TIME_NOW, 0) > deadline) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// Connects a process to a fake server.
+/// @returns An errno code if an error occurred, 0 if no error occurred.
+static int connect(fake_server &server, nvim::process &nvim) {
+    nvim.set_controller(nvim::window_controller(nullptr));
+
+    if (int error = nvim.connect(server.listen())) {
+        return error;
+    }
+
+    server.accept();
+    return 0;
+}
+
+/// Closes the server's end of the connection and waits for the process to see
+/// it. Does nothing if the server has already disconnected.
+/// @returns False if the process didn't see the connection close.
+static bool disconnect(fake_server &server, nvim::process &nvim) {
+    if (server.disconnect()) {
+        return wait_for_cancel(nvim);
+    }
+
+    return true;
+}
+
+struct stream_result {
+    size_t sent = 0;
+    bool responded = false;
+    bool cancelled = false;
+    nvim::rpc_counts counts;
+};
+
+/// Streams at least bytes worth of redraw bursts through a process.
+static stream_result stream(size_t bytes) {
+    stream_result result;
+    fake_server server;
+    nvim::process nvim;
+
+    if (connect(server, nvim)) {
+        return result;
+    }
+
+    msg::packer resize;
+    resize.pack(std::make_tuple(2, "redraw", std::make_tuple(
+        std::make_tuple("grid_resize", std::make_tuple(1, 200, 50)))));
+
+    server.send(resize);
+    result.sent += resize.size();
+
+    msg::packer burst = redraw_burst(50);
+
+    while (result.sent < bytes) {
+        server.send(burst);
+        result.sent += burst.size();
+    }
+
+    // Once the process responds, it has read everything we've sent.
+    msg::packer request;
+    request.pack(std::make_tuple(0, 7, "redraw_stats", std::tuple<>()));
+    server.send(request);
+    result.sent += request.size();
+    result.responded = server.response(7).size() == 4;
+    result.cancelled = disconnect(server, nvim);
+
+    result.counts = nvim.get_rpc_stats().get();
+    return result;
+}
+
+struct contend_result {
+    int inputs = 0;
+    int responses = 0;
+    bool cancelled = false;
+};
+
+/// Sends count mouse drags from one thread while the process responds to
+/// count requests on the IO thread. Returns once the server has seen them all.
+static contend_result contend(int count) {
+    contend_result result;
+    fake_server server;
+    nvim::process nvim;
+
+    if (connect(server, nvim)) {
+        return result;
+    }
+
+    // The process responds to requests it doesn't know with an error.
+    msg::packer requests;
+
+    for (int i=0; i<count; ++i) {
+        requests.pack(std::make_tuple(0, i, "contend", std::tuple<>()));
+    }
+
+    std::thread responses([&]() {
+        server.send(requests);
+    });
+
+    std::thread inputs([&]() {
+        for (int i=0; i<count; ++i) {
+            nvim.input_mouse("left", "drag", "", i % 50, i % 200);
+        }
+    });
+
+    while (result.inputs < count || result.responses < count) {
+        msg::array message = server.receive();
+        if (!message.size()) break;
+
+        if (message[0].get<msg::integer>() == 1) {
+            result.responses += 1;
+        } else if (message[2].get<msg::string>() == "nvim_input_mouse") {
+            result.inputs += 1;
+        }
+    }
+
+    inputs.join();
+    responses.join();
+
+    result.cancelled = disconnect(server, nvim);
+    return result;
+}
+
+struct request_results {
+    nvim::rpc_result<int64_t> sum;
+    nvim::rpc_result<std::vector<std::string>> lines;
+    nvim::rpc_result<void> command;
+    nvim::rpc_result<bool> timeout;
+};
+
+/// Makes a sequence of requests, each sent once the last has completed.
+static nvim::task make_requests(nvim::process &nvim, dispatch_queue_t queue,
+                                request_results &results,
+                                dispatch_semaphore_t done) {
+    dispatch_time_t forever = DISPATCH_TIME_FOREVER;
+    results.sum = co_await nvim.request<int64_t>(queue, forever, "nvim_eval", "1 + 1");
+
+    results.lines = co_await nvim.request<std::vector<std::string>>(
+        queue, forever, "nvim_buf_get_lines", 0, 0, results.sum.value, false);
+
+    // The awaitable owns its method, so it can outlive a temporary name.
+    auto command = nvim.request<void>(queue, forever, std::string("nvim_") + "command", "bad");
+    results.command = co_await command;
+
+    dispatch_time_t timeout = dispatch_time(DISPATCH_TIME_NOW, 20 * NSEC_PER_MSEC);
+    results.timeout = co_await nvim.request<bool>(queue, timeout, "nvim_eval", "v:true");
+
+    dispatch_semaphore_signal(done);
+}
+
+@interface testProcess : XCTestCase
+@end
+
+@implementation testProcess {
+    fake_server server;
+    nvim::process nvim;
+}
+
+- (void)setUp {
+    [super setUp];
+    XCTAssertEqual(connect(server, nvim), 0);
+}
+
+- (void)tearDown {
+    XCTAssertTrue(disconnect(server, nvim));
+    [super tearDown];
+}
+
+- (void)testRedrawStream {
+    stream_result result = stream(1 << 20);
+    XCTAssertTrue(result.responded);
+    XCTAssertTrue(result.cancelled);
+    XCTAssertEqual(result.counts.bytes_read, result.sent);
+    XCTAssertGreaterThan(result.counts.messages, 30);
+    XCTAssertLessThanOrEqual(result.counts.wakeups, result.counts.reads);
+}
+
+- (void)testLargeMessage {
+    msg::packer resize;
+    resize.pack(std::make_tuple(2, "redraw", std::make_tuple(
+        std::make_tuple("grid_resize", std::make_tuple(1, 200, 50)))));
+
+    // A message many times larger than the initial read size. The input
+    // buffer has to grow while the message is partially unpacked.
+    msg::packer burst = redraw_burst(10000);
+    XCTAssertGreaterThan(burst.size(), 4 << 20);
+
+    msg::packer request;
+    request.pack(std::make_tuple(0, 7, "redraw_stats", std::tuple<>()));
+
+    server.send(resize);
+    server.send(burst);
+    server.send(request);
+    XCTAssertEqual(server.response(7).size(), 4);
+
+    XCTAssertTrue(disconnect(server, nvim));
+
+    nvim::rpc_counts counts = nvim.get_rpc_stats().get();
+    XCTAssertEqual(counts.bytes_read, resize.size() + burst.size() + request.size());
+    XCTAssertEqual(counts.messages, 3);
+}
+
+- (void)testOutputShrinksAfterDrop {
+    std::string text(32 << 20, 'x');
+    std::vector<std::string_view> lines = {text};
+    nvim.drop_text(lines);
+
+    for (;;) {
+        msg::array message = server.receive();
+        XCTAssertTrue(message.size());
+
+        if (!message.size() || message[2].get<msg::string>() == "nvim_call_function") {
+            break;
+        }
+    }
+
+    // The drop's buffer is kept until enough quiet messages follow it.
+    nvim::rpc_counts counts = nvim.get_rpc_stats().get();
+    XCTAssertGreaterThanOrEqual(counts.output_capacity, text.size());
+    XCTAssertEqual(counts.shrinks, 0);
+
+    for (int i=0; i<nvim::shrink_policy::shrink_after; ++i) {
+        nvim.command("echo");
+        XCTAssert(server.receive()[2].get<msg::string>() == "nvim_command");
+    }
+
+    XCTAssertTrue(disconnect(server, nvim));
+
+    counts = nvim.get_rpc_stats().get();
+    XCTAssertGreaterThanOrEqual(counts.output_peak_capacity, text.size());
+    XCTAssertLessThanOrEqual(counts.output_capacity, nvim::shrink_policy::target_capacity);
+    XCTAssertEqual(counts.shrinks, 1);
+}
+
+- (void)testStreamingPaste {
+    std::string text;
+
+    while (text.size() < 3 * nvim::process::paste_chunk_size) {
+        text += "Grüße " + std::to_string(text.size()) + "\n";
+    }
+
+    // Queued behind the streaming paste.
+    nvim.paste(text);
+    nvim.paste("tail");
+
+    std::string pasted;
+    std::vector<int> phases;
+
+    while (phases.empty() || phases.back() != 3) {
+        msg::array message = server.receive();
+        if (!message.size()) break;
+
+        XCTAssert(message[2].get<msg::string>() == "nvim_paste");
+        msg::array args = message[3].get<msg::array>();
+        msg::string chunk = args[0].get<msg::string>();
+
+        XCTAssertLessThanOrEqual(chunk.size(), nvim::process::paste_chunk_size);
+        XCTAssertEqual(chunk.back(), '\n');
+
+        pasted += chunk;
+        phases.push_back(args[2].get<msg::integer>().as<int>());
+        server.respond(message[1].get<msg::integer>().as<uint32_t>(), true);
+    }
+
+    XCTAssert(pasted == text);
+    XCTAssertGreaterThanOrEqual(phases.size(), 3);
+    XCTAssertEqual(phases.front(), 1);
+
+    for (size_t i=1; i<phases.size() - 1; ++i) {
+        XCTAssertEqual(phases[i], 2);
+    }
+
+    msg::array message = server.receive();
+    msg::array args = message[3].get<msg::array>();
+    XCTAssert(args[0].get<msg::string>() == "tail");
+    XCTAssertEqual(args[2].get<msg::integer>().as<int>(), -1);
+
+    XCTAssertTrue(disconnect(server, nvim));
+
+    // Only a chunk at a time is packed.
+    nvim::rpc_counts counts = nvim.get_rpc_stats().get();
+    XCTAssertLessThan(counts.output_peak_capacity, 4 * nvim::process::paste_chunk_size);
+}
+
+- (void)testCancelledPaste {
+    std::string text(3 * nvim::process::paste_chunk_size, 'x');
+    nvim.paste(text);
+
+    msg::array message = server.receive();
+    msg::array args = message[3].get<msg::array>();
+    XCTAssertEqual(args[2].get<msg::integer>().as<int>(), 1);
+
+    // Neovim cancels the paste. Nothing more of it is sent. The command is
+    // on the same lane, so anything sent for the paste would arrive first.
+    server.respond(message[1].get<msg::integer>().as<uint32_t>(), false);
+    nvim.command("echo");
+
+    message = server.receive();
+    XCTAssert(message[2].get<msg::string>() == "nvim_command");
+}
+
+- (void)testRequestsWaitForPaste {
+    std::string text(3 * nvim::process::paste_chunk_size, 'x');
+    nvim.paste(text);
+    nvim.command("write");
+    nvim.paste("tail");
+
+    // Interactive requests aren't held.
+    nvim.input("x");
+
+    std::vector<std::string> methods;
+    std::vector<int> phases;
+
+    while (methods.empty() || methods.back() != "nvim_paste" || phases.back() != -1) {
+        msg::array message = server.receive();
+        if (!message.size()) break;
+
+        methods.emplace_back(message[2].get<msg::string>());
+
+        if (methods.back() == "nvim_paste") {
+            msg::array args = message[3].get<msg::array>();
+            phases.push_back(args[2].get<msg::integer>().as<int>());
+
+            if (phases.back() != -1) {
+                server.respond(message[1].get<msg::integer>().as<uint32_t>(), true);
+            }
+        }
+    }
+
+    XCTAssert(std::find(methods.begin(), methods.end(), "nvim_input") != methods.end());
+    methods.erase(std::remove(methods.begin(), methods.end(), "nvim_input"), methods.end());
+
+    std::vector<std::string> expected = {
+        "nvim_paste", "nvim_paste", "nvim_paste", "nvim_command", "nvim_paste"
+    };
+
+    XCTAssert(methods == expected);
+    XCTAssert(phases == std::vector<int>({1, 2, 3, -1}));
+}
+
+- (void)testSyncCommandSkipsPaste {
+    auto text = std::make_shared<const std::string>(3 * nvim::process::paste_chunk_size, 'x');
+    nvim.paste(text);
+    nvim.command("write");
+
+    nvim::rpc_response response;
+    dispatch_time_t timeout = dispatch_time(DISPATCH_TIME_NOW, NSEC_PER_SEC);
+
+    std::thread sync([&]() {
+        response = nvim.sync_command("echo", timeout);
+    });
+
+    msg::array message = server.receive();
+    XCTAssert(message[2].get<msg::string>() == "nvim_paste");
+
+    // The paste is still streaming, the synchronous command isn't held
+    // behind it, but the asynchronous one is.
+    message = server.receive();
+    XCTAssert(message[2].get<msg::string>() == "nvim_command");
+    XCTAssert(message[3].get<msg::array>()[0].get<msg::string>() == "echo");
+
+    server.respond(message[1].get<msg::integer>().as<uint32_t>(), nullptr);
+    sync.join();
+    XCTAssertFalse(response.timed_out);
+}
+
+- (void)testSyncCommandBetweenPasteChunks {
+    std::string text;
+
+    while (text.size() < 3 * nvim::process::paste_chunk_size) {
+        text += "line " + std::to_string(text.size()) + "\n";
+    }
+
+    nvim.paste(text);
+    nvim.command("write");
+
+    msg::array message = server.receive();
+    msg::array args = message[3].get<msg::array>();
+    XCTAssertEqual(args[2].get<msg::integer>().as<int>(), 1);
+
+    std::string pasted(args[0].get<msg::string>());
+    uint32_t chunk_id = message[1].get<msg::integer>().as<uint32_t>();
+
+    // The synchronous command lands between the first and second chunks, as
+    // a whole message of its own.
+    nvim::rpc_response response;
+    dispatch_time_t timeout = dispatch_time(DISPATCH_TIME_NOW, NSEC_PER_SEC);
+
+    std::thread sync([&]() {
+        response = nvim.sync_command("echo", timeout);
+    });
+
+    message = server.receive();
+    XCTAssert(message[2].get<msg::string>() == "nvim_command");
+    XCTAssert(message[3].get<msg::array>()[0].get<msg::string>() == "echo");
+
+    server.respond(message[1].get<msg::integer>().as<uint32_t>(), nullptr);
+    sync.join();
+    XCTAssertFalse(response.timed_out);
+
+    // The paste picks up where it left off, none of it is lost or reordered,
+    // and the held command still follows the last chunk.
+    std::vector<int> phases = {1};
+    server.respond(chunk_id, true);
+
+    while (phases.back() != 3) {
+        message = server.receive();
+        if (!message.size()) break;
+
+        XCTAssert(message[2].get<msg::string>() == "nvim_paste");
+        args = message[3].get<msg::array>();
+        pasted += args[0].get<msg::string>();
+        phases.push_back(args[2].get<msg::integer>().as<int>());
+        server.respond(message[1].get<msg::integer>().as<uint32_t>(), true);
+    }
+
+    XCTAssert(pasted == text);
+
+    for (size_t i=1; i<phases.size() - 1; ++i) {
+        XCTAssertEqual(phases[i], 2);
+    }
+
+    message = server.receive();
+    XCTAssert(message[2].get<msg::string>() == "nvim_command");
+    XCTAssert(message[3].get<msg::array>()[0].get<msg::string>() == "write");
+}
+
+- (void)testUiAttachRequests {
+    std::thread attach([&]() {
+        nvim.ui_attach(80, 24, nvim::ui_options{});
+    });
+
+    // The client info is set before the UI attaches.
+    msg::array message = server.receive();
+    XCTAssert(message[2].get<msg::string>() == "nvim_set_client_info");
+
+    // ui_attach returns on the next flush.
+    msg::packer redraw;
+    redraw.pack(std::make_tuple(2, "redraw", std::make_tuple(
+        std::make_tuple("grid_resize", std::make_tuple(1, 80, 24)),
+        std::make_tuple("flush", std::tuple<>()))));
+
+    server.send(redraw);
+    attach.join();
+
+    // Sent after ui_attach returns, so a missing nvim_ui_attach fails rather
+    // than blocking the receive.
+    nvim.command("echo");
+
+    message = server.receive();
+    XCTAssert(message[2].get<msg::string>() == "nvim_ui_attach");
+}
+
+- (void)testResponseHandlers {
+    constexpr uint32_t count = 1000;
+
+    std::vector<int64_t> results(count, -1);
+    dispatch_semaphore_t handled = dispatch_semaphore_create(0);
+
+    for (int round=0; round<2; ++round) {
+        for (uint32_t i=0; i<count; ++i) {
+            nvim.command(std::to_string(i), [&, i](const msg::object &error,
+                                                   const msg::object &result, bool timed_out) {
+                results[i] = result.get<msg::integer>().as<int64_t>();
+                dispatch_semaphore_signal(handled);
+            });
+        }
+
+        std::vector<uint32_t> msgids;
+
+        for (uint32_t i=0; i<count; ++i) {
+            msgids.push_back(server.receive()[1].get<msg::integer>().as<uint32_t>());
+        }
+
+        // Every request in flight has its own msgid. Once they've completed,
+        // the next round reuses them.
+        std::vector<uint32_t> sorted = msgids;
+        std::sort(sorted.begin(), sorted.end());
+        XCTAssert(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+        XCTAssertLessThan(sorted.back(), count);
+
+        // Respond out of order, each result is the index of its request.
+        for (uint32_t i=count; i--;) {
+            server.respond(msgids[i], i);
+        }
+
+        dispatch_time_t timeout = dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC);
+
+        for (uint32_t i=0; i<count; ++i) {
+            XCTAssertEqual(dispatch_semaphore_wait(handled, timeout), 0);
+        }
+
+        for (uint32_t i=0; i<count; ++i) {
+            XCTAssertEqual(results[i], (int64_t)i);
+        }
+
+        results.assign(count, -1);
+    }
+
+    dispatch_release(handled);
+}
+
+- (void)testRequestTimeout {
+    dispatch_time_t start = dispatch_time(DISPATCH_TIME_NOW, 0);
+    dispatch_time_t timeout = dispatch_time(start, 20 * NSEC_PER_MSEC);
+    nvim::rpc_response response = nvim.sync_command("sleep", timeout);
+
+    XCTAssertTrue(response.timed_out);
+    XCTAssertGreaterThanOrEqual(dispatch_time(DISPATCH_TIME_NOW, 0), timeout);
+    uint32_t late = server.receive()[1].get<msg::integer>().as<uint32_t>();
+
+    // The timed out request keeps its msgid until the server responds.
+    dispatch_semaphore_t handled = dispatch_semaphore_create(0);
+    std::atomic<int64_t> result = -1;
+
+    nvim.command("echo", [&](const msg::object &error,
+                             const msg::object &response, bool timed_out) {
+        result = response.get<msg::integer>().as<int64_t>();
+        dispatch_semaphore_signal(handled);
+    });
+
+    uint32_t msgid = server.receive()[1].get<msg::integer>().as<uint32_t>();
+    XCTAssertNotEqual(msgid, late);
+
+    // The late response is dropped, without calling any handler.
+    server.respond(late, 1);
+    server.respond(msgid, 2);
+
+    dispatch_time_t wait = dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC);
+    XCTAssertEqual(dispatch_semaphore_wait(handled, wait), 0);
+    XCTAssertEqual(result.load(), 2);
+
+    dispatch_release(handled);
+}
+
+- (void)testRequest {
+    dispatch_queue_t queue = dispatch_queue_create(nullptr, DISPATCH_QUEUE_SERIAL);
+    dispatch_semaphore_t done = dispatch_semaphore_create(0);
+    request_results results;
+    make_requests(nvim, queue, results, done);
+
+    msg::array message = server.receive();
+    XCTAssert(message[2].get<msg::string>() == "nvim_eval");
+    server.respond(message[1].get<msg::integer>().as<uint32_t>(), 2);
+
+    message = server.receive();
+    XCTAssert(message[2].get<msg::string>() == "nvim_buf_get_lines");
+    XCTAssertEqual(message[3].get<msg::array>()[2].get<msg::integer>().as<int64_t>(), 2);
+    server.respond(message[1].get<msg::integer>().as<uint32_t>(),
+                   std::make_tuple("first", "second"));
+
+    message = server.receive();
+    XCTAssert(message[2].get<msg::string>() == "nvim_command");
+
+    msg::packer error;
+    error.pack(std::make_tuple(1, message[1].get<msg::integer>().as<uint32_t>(),
+                               std::make_tuple(0, "Vim:E492: Not an editor command"),
+                               nullptr));
+    server.send(error);
+
+    // The last request is never answered.
+    message = server.receive();
+    XCTAssert(message[2].get<msg::string>() == "nvim_eval");
+    dispatch_time_t timeout = dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC);
+    XCTAssertEqual(dispatch_semaphore_wait(done, timeout), 0);
+
+    XCTAssertTrue(results.sum.ok());
+    XCTAssertEqual(results.sum.value, 2);
+
+    XCTAssertTrue(results.lines.ok());
+    XCTAssertEqual(results.lines.value.size(), 2);
+    XCTAssert(results.lines.value[0] == "first");
+    XCTAssert(results.lines.value[1] == "second");
+
+    XCTAssertFalse(results.command.ok());
+    XCTAssert(results.command.error == "Vim:E492: Not an editor command");
+
+    XCTAssertFalse(results.timeout.ok());
+    XCTAssertTrue(results.timeout.timed_out);
+
+    dispatch_release(done);
+    dispatch_release(queue);
+}
+
+- (void)testConcurrentSyncCalls {
+    constexpr int threads = 8;
+    constexpr int calls = 200;
+
+    std::atomic<int> mismatches = 0;
+    std::vector<std::thread> clients;
+
+    // Each client alternates between sync_command and get_mode. Commands are
+    // numbered, the server answers each with its number.
+    for (int t=0; t<threads; ++t) {
+        clients.emplace_back([&, t] {
+            for (int i=0; i<calls; ++i) {
+                if (i % 2) {
+                    if (nvim.get_mode() != nvim::mode::insert) mismatches += 1;
+                    continue;
+                }
+
+                int64_t number = t * calls + i;
+                auto response = nvim.sync_command(std::to_string(number),
+                                                  DISPATCH_TIME_FOREVER);
+
+                if (response.timed_out || !response.result.is<msg::integer>() ||
+                    response.result.get<msg::integer>().as<int64_t>() != number) {
+                    mismatches += 1;
+                }
+            }
+        });
+    }
+
+    // Every client has one call in flight per round. Wait for all of them,
+    // then respond in reverse order.
+    std::array<std::pair<msg::string, msg::string>, 1> mode{{
+        {"mode", "i"}
+    }};
+
+    for (int round=0; round<calls; ++round) {
+        std::vector<std::pair<uint32_t, int64_t>> pending;
+
+        while (pending.size() < threads) {
+            msg::array message = server.receive();
+            uint32_t msgid = message[1].get<msg::integer>().as<uint32_t>();
+
+            if (message[2].get<msg::string>() == "nvim_get_mode") {
+                pending.emplace_back(msgid, -1);
+            } else {
+                msg::string command = message[3].get<msg::array>()[0].get<msg::string>();
+                pending.emplace_back(msgid, std::stoll(std::string(command)));
+            }
+        }
+
+        for (size_t i=pending.size(); i--;) {
+            if (pending[i].second == -1) {
+                server.respond(pending[i].first, mode);
+            } else {
+                server.respond(pending[i].first, pending[i].second);
+            }
+        }
+    }
+
+    for (std::thread &client : clients) {
+        client.join();
+    }
+
+    XCTAssertEqual(mismatches.load(), 0);
+}
+
+- (void)testConcurrentWrites {
+    contend_result result = contend(10000);
+    XCTAssertEqual(result.inputs, 10000);
+    XCTAssertEqual(result.responses, 10000);
+    XCTAssertTrue(result.cancelled);
+}
+
+- (void)testInlineWrite {
+    // Nothing else is being written, the keypress is written immediately.
+    nvim.input("x");
+    msg::array message = server.receive();
+    XCTAssert(message[2].get<msg::string>() == "nvim_input");
+
+    nvim::rpc_counts counts = nvim.get_rpc_stats().get();
+    XCTAssertEqual(counts.writes, 1);
+    XCTAssertEqual(counts.inline_writes, 1);
+}
+
+- (void)testInlineBulkWrite {
+    // Bulk messages are written from the queue once bulk_lock is released,
+    // still by the sending thread.
+    nvim.command("echo");
+    msg::array message = server.receive();
+    XCTAssert(message[2].get<msg::string>() == "nvim_command");
+
+    nvim::rpc_counts counts = nvim.get_rpc_stats().get();
+    XCTAssertEqual(counts.writes, 1);
+    XCTAssertEqual(counts.inline_writes, 1);
+}
+
+- (void)testInteractiveLane {
+    // The server isn't reading yet. The first drop is partially written, the
+    // others are queued behind it. The keypress overtakes the queued drops,
+    // but not the one that has been partially written.
+    std::string text(4 << 20, 'x');
+    std::vector<std::string_view> files = {text};
+
+    nvim.drop_text(files);
+    nvim.drop_text(files);
+    nvim.drop_text(files);
+    nvim.input("x");
+
+    std::vector<std::string> methods;
+
+    while (methods.size() < 4) {
+        msg::array message = server.receive();
+        if (!message.size()) break;
+
+        methods.emplace_back(message[2].get<msg::string>());
+    }
+
+    std::vector<std::string> expected = {
+        "nvim_call_function",
+        "nvim_input",
+        "nvim_call_function",
+        "nvim_call_function"
+    };
+
+    XCTAssert(methods == expected);
+}
+
+- (void)testScrollIsInteractive {
+    // As above, the scroll overtakes the queued drops. Its lines are sent as
+    // separate nvim_input_mouse requests, but published together.
+    std::string text(4 << 20, 'x');
+    std::vector<std::string_view> files = {text};
+
+    nvim.drop_text(files);
+    nvim.drop_text(files);
+    nvim.input_mouse("wheel", "down", "", 1, 2, 3);
+
+    std::vector<std::string> methods;
+
+    while (methods.size() < 5) {
+        msg::array message = server.receive();
+        if (!message.size()) break;
+
+        methods.emplace_back(message[2].get<msg::string>());
+
+        if (methods.back() == "nvim_input_mouse") {
+            msg::array args = message[3].get<msg::array>();
+            XCTAssert(args[0].get<msg::string>() == "wheel");
+            XCTAssert(args[1].get<msg::string>() == "down");
+            XCTAssertEqual(args[4].get<msg::integer>().as<int>(), 1);
+            XCTAssertEqual(args[5].get<msg::integer>().as<int>(), 2);
+        }
+    }
+
+    std::vector<std::string> expected = {
+        "nvim_call_function",
+        "nvim_input_mouse",
+        "nvim_input_mouse",
+        "nvim_input_mouse",
+        "nvim_call_function"
+    };
+
+    XCTAssert(methods == expected);
+}
+
+- (void)testKeypressPerformance {
+    // Round trips of a single keypress, from input() to the server.
+    [self measureBlock:^{
+        for (int i=0; i<10000; ++i) {
+            nvim.input("x");
+            server.receive();
+        }
+    }];
+}
+
+- (void)testContentionPerformance {
+    [self measureBlock:^{
+        contend(100000);
+    }];
+}
+
+- (void)testStreamPerformance {
+    [self measureBlock:^{
+        stream(16 << 20);
+    }];
+}
+
+@end
@@ -0,0 +1,186 @@
+//
+//  Neovim Mac Test
+//  RecordedSession.h
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef RECORDED_SESSION_H
+#define RECORDED_SESSION_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <unistd.h>
+#include <Foundation/Foundation.h>
+#include "headless.hpp"
+#include "rpc_capture.hpp"
+
+/// A capture of a Neovim session, replayed through a headless_ui.
+///
+/// Set NVIM_MAC_REPLAY_CAPTURE to the path of a capture recorded by a Debug
+/// build with NVIM_MAC_CAPTURE_DIR to replay a real session. Otherwise a
+/// synthetic session is recorded to a temporary file: 40 frames of a 120x40
+/// grid of syntax highlighted text, scrolling a line at a time, with a cursor
+/// line.
+class recorded_session {
+private:
+    std::string path;
+    bool temporary;
+
+    /// Packs a grid_line redraw event for a row of random words.
+    static void pack_row(msg::packer &packer, std::mt19937 &rng, int row, int hl_offset) {
+        constexpr int width = 120;
+        std::uniform_int_distribution<int> letter('a', 'z');
+        std::uniform_int_distribution<int> word(1, 8);
+        std::uniform_int_distribution<int> hl_id(1, 8);
+
+        std::vector<std::tuple<std::string, int>> cells;
+        int col = 0;
+
+        while (col < width) {
+            int length = std::min(word(rng), width - col);
+            int id = hl_id(rng) + hl_offset;
+
+            for (int i=0; i<length; ++i) {
+                cells.emplace_back(std::string(1, static_cast<char>(letter(rng))), id);
+            }
+
+            col += length;
+
+            if (col < width) {
+                cells.emplace_back(" ", id);
+                col += 1;
+            }
+        }
+
+        packer.start_array(2);
+        packer.pack("grid_line");
+        packer.start_array(4);
+        packer.pack(1);
+        packer.pack(row);
+        packer.pack(0);
+        packer.pack(cells);
+    }
+
+    static void record_synthetic(const char *path) {
+        std::mt19937 rng(26);
+        msg::packer packer;
+
+        // Syntax colors on the normal background (ids 1-8) and on the cursor
+        // line (ids 9-16). Id 8 is a low contrast comment color.
+        uint32_t colors[] = {
+            0xD4D4D4, 0x569CD6, 0xCE9178, 0xB5CEA8,
+            0xC586C0, 0x4EC9B0, 0xDCDCAA, 0x3C3C3C
+        };
+
+        packer.start_array(3);
+        packer.pack(2);
+        packer.pack("redraw");
+        packer.start_array(2 + 16);
+        packer.pack(std::make_tuple("grid_resize", std::make_tuple(1, 120, 40)));
+        packer.pack(std::make_tuple("default_colors_set",
+                                    std::make_tuple(0xD4D4D4, 0x1E1E1E, 0xFF0000)));
+
+        for (int i=0; i<16; ++i) {
+            std::map<std::string_view, uint32_t> attrs = {
+                {"foreground", colors[i % 8]},
+                {"background", i < 8 ? 0x1E1E1E : 0x2A2D2E}
+            };
+
+            packer.pack(std::make_tuple("hl_attr_define",
+                std::make_tuple(i + 1, attrs, std::map<std::string_view, int>(),
+                                std::vector<int>())));
+        }
+
+        nvim::rpc_capture capture;
+        capture.open(path);
+        capture.record(nvim::rpc_direction::read, packer.data(), packer.size());
+
+        for (int frame=0; frame<40; ++frame) {
+            packer.clear();
+            packer.start_array(3);
+            packer.pack(2);
+            packer.pack("redraw");
+
+            // The first frame draws every row, the rest scroll by a line and
+            // draw the new last row and the cursor line.
+            int rows = frame ? 3 : 40;
+            packer.start_array(rows + (frame ? 2 : 1));
+
+            if (frame) {
+                packer.pack(std::make_tuple("grid_scroll",
+                                            std::make_tuple(1, 0, 40, 0, 120, 1, 0)));
+                pack_row(packer, rng, 39, 0);
+                pack_row(packer, rng, 19, 0);
+                pack_row(packer, rng, 20, 8);
+            } else {
+                for (int row=0; row<40; ++row) {
+                    pack_row(packer, rng, row, row == 20 ? 8 : 0);
+                }
+            }
+
+            packer.pack(std::make_tuple("flush", std::tuple<>()));
+            capture.record(nvim::rpc_direction::read, packer.data(), packer.size());
+        }
+
+        capture.close();
+    }
+
+public:
+    recorded_session(): temporary(false) {
+        if (const char *env = getenv("NVIM_MAC_REPLAY_CAPTURE")) {
+            path = env;
+            return;
+        }
+
+        static int count = 0;
+        path = std::string(NSTemporaryDirectory().UTF8String) +
+               "session-" + std::to_string(getpid()) + "-" + std::to_string(count++);
+
+        temporary = true;
+        record_synthetic(path.c_str());
+    }
+
+    recorded_session(const recorded_session&) = delete;
+    recorded_session& operator=(const recorded_session&) = delete;
+
+    ~recorded_session() {
+        if (temporary) {
+            unlink(path.c_str());
+        }
+    }
+
+    /// Replays the session, calling observer with the grid at every flush.
+    /// @returns The number of flushes, or 0 if the capture couldn't be read.
+    template<typename Observer>
+    size_t replay(Observer &observer) const {
+        nvim::rpc_capture_file file;
+
+        if (file.open(path.c_str())) {
+            return 0;
+        }
+
+        nvim::headless_ui ui(nvim::headless_ui::flush_record::none);
+
+        ui.set_flush_observer(&observer, [](void *context, const nvim::grid &grid) {
+            (*static_cast<Observer*>(context))(grid);
+        });
+
+        nvim::replay(file, ui, nvim::replay_speed::maximum);
+
+        // The headless UI's window messages are queued on the main queue, a
+        // no-op per flush. Drain them, so long replays don't leave them
+        // behind for the following tests.
+        CFRunLoopRunInMode(kCFRunLoopDefaultMode, 0, false);
+        return ui.flush_count();
+    }
+};
+
+#endif // RECORDED_SESSION_H
@@ -0,0 +1,151 @@
+//
+//  Neovim Mac Test
+//  RpcCapture.mm
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
+#include <XCTest/XCTest.h>
+#include "headless.hpp"
+#include "rpc_capture.hpp"
+
+/// Packs events into a redraw notification.
+template<typename ...Events>
+static void redraw(msg::packer &packer, const Events& ...events) {
+    packer.pack(std::make_tuple(2, "redraw", std::make_tuple(events...)));
+}
+
+static auto flush() {
+    return std::make_tuple("flush", std::tuple<>());
+}
+
+static std::string temporary_path() {
+    static int count = 0;
+    return std::string(NSTemporaryDirectory().UTF8String) +
+           "capture-" + std::to_string(getpid()) + "-" + std::to_string(count++);
+}
+
+@interface testRpcCapture : XCTestCase
+@end
+
+@implementation testRpcCapture {
+    std::string path;
+    msg::packer stream;
+}
+
+- (void)setUp {
+    [super setUp];
+    path = temporary_path();
+
+    redraw(stream, std::make_tuple("grid_resize", std::make_tuple(1, 8, 2)), flush());
+
+    for (int i=0; i<4; ++i) {
+        redraw(stream,
+            std::make_tuple("grid_line",
+                std::make_tuple(1, i % 2, i, std::make_tuple(std::make_tuple("x", 0, 2)))),
+            flush());
+    }
+}
+
+- (void)tearDown {
+    unlink(path.c_str());
+    [super tearDown];
+}
+
+- (void)testRoundTrip {
+    const char request[] = "request bytes";
+
+    nvim::rpc_capture capture;
+    XCTAssertEqual(capture.open(path.c_str()), 0);
+    capture.record(nvim::rpc_direction::write, request, sizeof(request));
+    capture.record(nvim::rpc_direction::read, stream.data(), 10);
+    capture.record(nvim::rpc_direction::read, stream.data() + 10, stream.size() - 10);
+    capture.close();
+    XCTAssertFalse(capture.is_open());
+
+    nvim::rpc_capture_file file;
+    XCTAssertEqual(file.open(path.c_str()), 0);
+
+    auto &records = file.records();
+    XCTAssertEqual(records.size(), 3);
+    XCTAssertEqual(records[0].direction, nvim::rpc_direction::write);
+    XCTAssertEqual(records[0].data, std::string_view(request, sizeof(request)));
+    XCTAssertEqual(records[1].direction, nvim::rpc_direction::read);
+    XCTAssertEqual(records[1].data.size(), 10);
+    XCTAssertEqual(records[2].data.size(), stream.size() - 10);
+    XCTAssertLessThanOrEqual(records[0].timestamp, records[1].timestamp);
+    XCTAssertLessThanOrEqual(records[1].timestamp, records[2].timestamp);
+}
+
+- (void)testInvalidFiles {
+    nvim::rpc_capture_file file;
+    XCTAssertEqual(file.open(path.c_str()), ENOENT);
+
+    FILE *handle = fopen(path.c_str(), "wb");
+    fputs("not a capture", handle);
+    fclose(handle);
+    XCTAssertEqual(file.open(path.c_str()), EINVAL);
+
+    // A truncated record.
+    nvim::rpc_capture capture;
+    capture.open(path.c_str());
+    capture.record(nvim::rpc_direction::read, stream.data(), stream.size());
+    capture.close();
+    truncate(path.c_str(), 8 + 16 + stream.size() - 1);
+    XCTAssertEqual(file.open(path.c_str()), EINVAL);
+}
+
+- (void)testReplayMatchesDirectFeed {
+    nvim::rpc_capture capture;
+    capture.open(path.c_str());
+
+    for (size_t i=0; i<stream.size(); i += 7) {
+        capture.record(nvim::rpc_direction::read, stream.data() + i,
+                       std::min<size_t>(7, stream.size() - i));
+    }
+
+    // Outgoing bytes aren't fed to the UI.
+    capture.record(nvim::rpc_direction::write, "\xFF\xFF", 2);
+    capture.close();
+
+    nvim::rpc_capture_file file;
+    XCTAssertEqual(file.open(path.c_str()), 0);
+
+    nvim::headless_ui direct;
+    direct.feed(stream.data(), stream.size());
+
+    nvim::headless_ui replayed;
+    nvim::replay(file, replayed, nvim::replay_speed::maximum);
+
+    XCTAssertEqual(replayed.flush_count(), 5);
+    XCTAssertEqual(replayed.ignored_count(), 0);
+    XCTAssert(replayed.hashes() == direct.hashes());
+}
+
+- (void)testReplayAtRecordedSpeed {
+    nvim::rpc_capture capture;
+    capture.open(path.c_str());
+    capture.record(nvim::rpc_direction::read, stream.data(), stream.size() / 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    capture.record(nvim::rpc_direction::read, stream.data() + stream.size() / 2,
+                   stream.size() - stream.size() / 2);
+    capture.close();
+
+    nvim::rpc_capture_file file;
+    XCTAssertEqual(file.open(path.c_str()), 0);
+    XCTAssertGreaterThanOrEqual(file.duration(), 20000000);
+
+    nvim::headless_ui ui;
+    uint64_t elapsed = nvim::replay(file, ui, nvim::replay_speed::recorded);
+
+    XCTAssertGreaterThanOrEqual(elapsed, file.duration());
+    XCTAssertEqual(ui.flush_count(), 5);
+}
+
+@end
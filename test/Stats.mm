@@ -0,0 +1,104 @@
+//
+//  Neovim Mac Test
+//  Stats.mm
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <map>
+#include <tuple>
+#include <vector>
+#include <XCTest/XCTest.h>
+#include "stats.hpp"
+#include "ui.hpp"
+
+using attr_map = std::map<std::string_view, bool>;
+using empty_array = std::vector<int>;
+
+/// Packs events into a redraw notification and sends it to the controller.
+template<typename ...Events>
+static void redraw(nvim::ui_controller &ui, const Events& ...events) {
+    msg::packer packer;
+    packer.pack(std::make_tuple(events...));
+
+    msg::unpacker unpacker;
+    unpacker.feed(packer.data(), packer.size());
+
+    msg::object *object = unpacker.unpack();
+    ui.redraw(object->get<msg::array>());
+}
+
+static auto flush() {
+    return std::make_tuple("flush", std::tuple<>());
+}
+
+@interface testStats : XCTestCase
+@end
+
+@implementation testStats {
+    nvim::ui_controller ui;
+}
+
+- (void)setUp {
+    [super setUp];
+    ui.window = nvim::window_controller(nullptr);
+}
+
+- (void)testControllerRedrawCounts {
+    redraw(ui,
+        std::make_tuple("grid_resize", std::make_tuple(1, 10, 4)),
+        std::make_tuple("hl_attr_define",
+            std::make_tuple(1, attr_map{{"bold", true}}, attr_map{}, empty_array{}),
+            std::make_tuple(2, attr_map{{"italic", true}}, attr_map{}, empty_array{})),
+        std::make_tuple("grid_line",
+            std::make_tuple(1, 0, 0, std::make_tuple(std::make_tuple("a", 1, 5),
+                                                     std::make_tuple("é", 2))),
+            std::make_tuple(1, 1, 0, std::make_tuple(std::make_tuple("好", 0),
+                                                     std::make_tuple("")))),
+        std::make_tuple("mouse_on"),
+        std::make_tuple("some_future_event", std::make_tuple(1)),
+        flush());
+
+    const nvim::redraw_stats &stats = ui.stats;
+    nvim::redraw_counts lines = stats.get(nvim::redraw_event_type::grid_line);
+
+    XCTAssertEqual(lines.events, 1);
+    XCTAssertEqual(lines.calls, 2);
+    XCTAssertEqual(lines.cells, 8);
+    XCTAssertEqual(lines.bytes, 1 + 2 + 3);
+
+    XCTAssertEqual(stats.get(nvim::redraw_event_type::hl_attr_define).calls, 2);
+    XCTAssertEqual(stats.get(nvim::redraw_event_type::flush).events, 1);
+    XCTAssertEqual(stats.get(nvim::redraw_event_type::ignored).events, 1);
+    XCTAssertEqual(stats.get(nvim::redraw_event_type::unknown).events, 1);
+    XCTAssertEqual(stats.get(nvim::redraw_event_type::grid_scroll).events, 0);
+    XCTAssertEqual(stats.total().events, 6);
+
+    ui.stats.reset();
+    XCTAssertEqual(stats.total().events, 0);
+    XCTAssertEqual(stats.total().cells, 0);
+}
+
+- (void)testRedrawPerformance {
+    msg::packer packer;
+    packer.start_array(6001);
+    packer.pack(std::make_tuple("grid_resize", std::make_tuple(1, 200, 60)));
+
+    for (int i=0; i<6000; ++i) {
+        packer.pack(std::make_tuple("grid_line",
+            std::make_tuple(1, i % 60, 0, std::make_tuple(std::make_tuple("x", 0, 100),
+                                                          std::make_tuple("y", 0, 100)))));
+    }
+
+    msg::unpacker unpacker;
+    unpacker.feed(packer.data(), packer.size());
+    msg::array events = unpacker.unpack()->get<msg::array>();
+
+    [self measureBlock:^{
+        ui.redraw(events);
+    }];
+}
+
+@end
@@ -0,0 +1,56 @@
+//
+//  Neovim Mac Test
+//  Trace.mm
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+#include <XCTest/XCTest.h>
+#include "trace.hpp"
+#include "ui.hpp"
+
+/// Returns the number of events with the given name.
+static size_t count(const std::vector<nvim::trace_event> &events, std::string_view name) {
+    return std::count_if(events.begin(), events.end(), [name](const auto &event) {
+        return name == event.name;
+    });
+}
+
+@interface testTrace : XCTestCase
+@end
+
+@implementation testTrace
+
+- (void)tearDown {
+    nvim::trace_stop();
+    [super tearDown];
+}
+
+- (void)testRedrawSpans {
+    nvim::ui_controller ui;
+    ui.window = nvim::window_controller(nullptr);
+
+    msg::packer packer;
+    packer.pack(std::make_tuple(std::make_tuple("grid_resize", std::make_tuple(1, 10, 2)),
+                                std::make_tuple("flush", std::tuple<>())));
+
+    msg::unpacker unpacker;
+    unpacker.feed(packer.data(), packer.size());
+    msg::array events = unpacker.unpack()->get<msg::array>();
+
+    nvim::trace_start();
+    ui.redraw(events);
+    ui.get_global_grid();
+
+    std::vector<nvim::trace_event> spans = nvim::trace_snapshot();
+    XCTAssertEqual(count(spans, "redraw"), 1);
+    XCTAssertEqual(count(spans, "flush"), 1);
+    XCTAssertEqual(count(spans, "get_global_grid"), 1);
+}
+
+@end
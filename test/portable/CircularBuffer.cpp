@@ -0,0 +1,484 @@
+//
+//  Neovim Mac Test
+//  CircularBuffer.cpp
+//
+//  Copyright © 2020 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "circular_buffer.hpp"
+#include "check.hpp"
+
+// Compares ranges element wise, for CHECK_EQ.
+template<typename Range1, typename Range2>
+static bool operator==(const Range1 &r1, const Range2 &r2) {
+    return std::equal(r1.begin(), r1.end(), r2.begin(), r2.end());
+}
+
+static inline bool all_of(const circular_buffer &buffer, char val) {
+    return std::all_of(buffer.begin(), buffer.end(), [val](char x){
+        return x == val;
+    });
+}
+
+TEST(CircularBuffer, DefaultContructor) {
+    circular_buffer buffer;
+    CHECK_EQ(buffer.size(), 0);
+    CHECK_EQ(buffer.capacity(), 0);
+    CHECK_EQ(buffer.data(), nullptr);
+    CHECK_EQ(buffer.begin(), buffer.end());
+}
+
+TEST(CircularBuffer, InitialCapacityConstructor) {
+    circular_buffer buffer(1024);
+    CHECK_GE(buffer.capacity(), 1024);
+    CHECK_EQ(buffer.size(), 0);
+    CHECK_EQ(buffer.begin(), buffer.end());
+    CHECK(buffer.data());
+}
+
+TEST(CircularBuffer, DestructorDeallocates) {
+    char *data;
+    
+    {
+        circular_buffer buffer(1024);
+        data = buffer.data();
+    }
+
+    CHECK_ADDRESS_POISONED(data);
+}
+
+TEST(CircularBuffer, MoveConstructor) {
+    std::string_view input("input");
+    
+    circular_buffer moved_from;
+    moved_from.insert(input.data(), input.size());
+    
+    size_t size = moved_from.size();
+    size_t capacity = moved_from.capacity();
+    const char *data = moved_from.data();
+
+    circular_buffer moved_to(std::move(moved_from));
+    
+    CHECK_EQ(moved_from.size(), 0);
+    CHECK_EQ(moved_from.capacity(), 0);
+    CHECK_EQ(moved_from.data(), nullptr);
+    CHECK_EQ(moved_from.begin(), moved_from.end());
+    
+    CHECK_EQ(moved_to.size(), size);
+    CHECK_EQ(moved_to.capacity(), capacity);
+    CHECK_EQ(moved_to.data(), data);
+    CHECK_EQ(moved_to, input);
+}
+
+TEST(CircularBuffer, MoveAssignment) {
+    std::string_view input("input");
+    
+    circular_buffer moved_to;
+    circular_buffer moved_from;
+    moved_from.insert(input.data(), input.size());
+    
+    size_t size = moved_from.size();
+    size_t capacity = moved_from.capacity();
+    const char *data = moved_from.data();
+    
+    moved_to = std::move(moved_from);
+    
+    CHECK_EQ(moved_from.size(), 0);
+    CHECK_EQ(moved_from.capacity(), 0);
+    CHECK_EQ(moved_from.data(), nullptr);
+    CHECK_EQ(moved_from.begin(), moved_from.end());
+    
+    CHECK_EQ(moved_to.size(), size);
+    CHECK_EQ(moved_to.capacity(), capacity);
+    CHECK_EQ(moved_to.data(), data);
+    CHECK_EQ(moved_to, input);
+}
+
+TEST(CircularBuffer, MoveAssignmentDeallocates) {
+    circular_buffer moved_to(1024);
+    char *ptr = moved_to.data();
+    moved_to = circular_buffer();
+    
+    CHECK_ADDRESS_POISONED(ptr);
+}
+
+TEST(CircularBuffer, CopyConstructor) {
+    const char input[] = "input";
+    
+    circular_buffer original;
+    original.insert(input, sizeof(input));
+    circular_buffer copy(original);
+    
+    CHECK_EQ(original, copy);
+    CHECK_EQ(original.size(), copy.size());
+    CHECK_EQ(original.capacity(), copy.capacity());
+    CHECK_NE(original.data(), copy.data());
+}
+
+TEST(CircularBuffer, CopyAssigment) {
+    std::string_view input("input");
+    
+    circular_buffer original;
+    original.insert(input.data(), input.size());
+    
+    circular_buffer copy;
+    copy = original;
+    
+    CHECK_EQ(original, copy);
+    CHECK_EQ(original.size(), copy.size());
+    CHECK_EQ(original.capacity(), copy.capacity());
+    CHECK_NE(original.data(), copy.data());
+}
+
+TEST(CircularBuffer, CopyAssingmentReusesBufferWhenPossible) {
+    std::string_view input("input");
+    circular_buffer original;
+    original.insert(input.data(), input.size());
+    
+    circular_buffer copy(1024);
+    char *old_data = copy.data();
+    copy = original;
+    
+    CHECK_EQ(copy.data(), old_data);
+}
+
+TEST(CircularBuffer, CopyAssigmentDeallocatesWhenResizing) {
+    circular_buffer small(1024);
+    size_t large_capacity = small.capacity() + 1024;
+    
+    circular_buffer large(large_capacity);
+    
+    for (int i=0; i<large_capacity; ++i) {
+        large.push_back('x');
+    }
+    
+    char *old_data = small.data();
+    size_t old_capacity = small.capacity();
+    small = large;
+    
+    CHECK_GT(small.capacity(), old_capacity);
+    CHECK_NE(old_data, small.data());
+    CHECK_ADDRESS_POISONED(old_data);
+}
+
+TEST(CircularBuffer, ClearResetsBuffer) {
+    circular_buffer buffer(1024);
+    char *data = buffer.data();
+    
+    buffer.push_back('x');
+    buffer.push_back('x');
+    buffer.consume(1);
+    buffer.clear();
+    
+    CHECK_EQ(buffer.size(), 0);
+    CHECK_EQ(buffer.data(), data);
+}
+
+TEST(CircularBuffer, ReserveResizesAsNeeded) {
+    circular_buffer buffer(1024);
+    size_t capacity = buffer.capacity();
+    char *data = buffer.data();
+    
+    buffer.reserve(capacity - 1);
+    CHECK_EQ(buffer.capacity(), capacity);
+    
+    buffer.reserve(capacity);
+    CHECK_EQ(buffer.capacity(), capacity);
+    
+    buffer.reserve(capacity + 1);
+    CHECK_GT(buffer.capacity(), capacity);
+    CHECK_NE(buffer.data(), data);
+    
+    CHECK_ADDRESS_POISONED(data, "Buffer not deallocated");
+}
+
+TEST(CircularBuffer, CanInsertIntoDefaultConstructedBuffer) {
+    std::string_view input("input");
+    circular_buffer buffer;
+    
+    buffer.insert(input.data(), input.size());
+    
+    CHECK_GE(buffer.capacity(), input.size());
+    CHECK_EQ(buffer.size(), input.size());
+    CHECK_EQ(buffer, input);
+}
+
+TEST(CircularBuffer, CanPushBackIntoDefaultConstructedBuffer) {
+    circular_buffer buffer;
+    buffer.push_back('x');
+    
+    CHECK_GE(buffer.capacity(), 1);
+    CHECK_EQ(buffer.size(), 1);
+    CHECK_EQ(buffer[0], 'x');
+    CHECK(buffer.data());
+}
+
+TEST(CircularBuffer, PushBackWithinCapacityDoesNotResize) {
+    circular_buffer buffer(1024);
+    size_t capacity = buffer.capacity();
+    char *data = buffer.data();
+    
+    for (int i=0; i<capacity; ++i) {
+        buffer.push_back('x');
+    }
+    
+    CHECK_EQ(buffer.capacity(), capacity);
+    CHECK_EQ(buffer.size(), capacity);
+    CHECK_EQ(buffer.data(), data);
+    CHECK(all_of(buffer, 'x'));
+}
+
+TEST(CircularBuffer, PushBackAtCapacityResizes) {
+    circular_buffer buffer(1024);
+    size_t capacity = buffer.capacity();
+    char *data = buffer.data();
+    
+    for (int i=0; i<=capacity; ++i) {
+        buffer.push_back('x');
+    }
+    
+    CHECK_GT(buffer.capacity(), capacity);
+    CHECK_NE(buffer.data(), data);
+    CHECK(all_of(buffer, 'x'));
+    CHECK_ADDRESS_POISONED(data, "Buffer not deallocated");
+}
+
+TEST(CircularBuffer, InsertingCapacityDoesNotResize) {
+    circular_buffer buffer(1024);
+    
+    char *data = buffer.data();
+    size_t capacity = buffer.capacity();
+    std::string input(capacity, 'x');
+    
+    buffer.insert(input.data(), input.size());
+    
+    CHECK_EQ(buffer.capacity(), capacity);
+    CHECK_EQ(buffer.data(), data);
+    CHECK_EQ(buffer.size(), input.size());
+    CHECK_EQ(buffer, input);
+}
+
+TEST(CircularBuffer, InsertingMoreThanCapacityResizes) {
+    circular_buffer buffer(1024);
+    
+    char *data = buffer.data();
+    size_t capacity = buffer.capacity();
+    std::string input(capacity + 64, 'x');
+    
+    buffer.insert(input.data(), input.size());
+    
+    CHECK_GT(buffer.capacity(), capacity);
+    CHECK_NE(buffer.data(), data);
+    CHECK_EQ(buffer.size(), input.size());
+    CHECK_EQ(buffer, input);
+    CHECK_ADDRESS_POISONED(data, "Buffer not deallocated");
+}
+
+TEST(CircularBuffer, CanPushBackMultiple) {
+    circular_buffer buffer;
+    
+    for (int i=0; i<16384; ++i) {
+        buffer.push_back('x');
+    }
+    
+    CHECK_EQ(buffer.size(), 16384);
+    CHECK(all_of(buffer, 'x'));
+}
+
+TEST(CircularBuffer, CanInsertMultiple) {
+    std::string_view input("1234567890123");
+    std::vector<char> vector;
+    circular_buffer buffer;
+
+    for (int i=0; i<128; ++i) {
+        buffer.insert(input.data(), input.size());
+        vector.insert(vector.end(), input.data(), input.end());
+    }
+    
+    CHECK_EQ(buffer, vector);
+}
+
+TEST(CircularBuffer, CanConsumeMultiple) {
+    circular_buffer buffer;
+    
+    for (int i=0; i<256; ++i) {
+        buffer.push_back('x');
+    }
+    
+    for (int i=256; i; --i) {
+        buffer.consume(1);
+        CHECK_EQ(buffer.size(), i - 1);
+    }
+}
+
+TEST(CircularBuffer, PushBackAndConsumeDoesNotResize) {
+    circular_buffer buffer(1024);
+    size_t capacity = buffer.capacity();
+    size_t lim = capacity * 4;
+
+    for (int i=0; i<lim; ++i) {
+        char c = i % 256;
+        
+        buffer.push_back(c);
+        CHECK_EQ(buffer.size(), 1);
+        CHECK_EQ(buffer[0], c);
+        
+        buffer.consume(1);
+        CHECK_EQ(buffer.size(), 0);
+        CHECK_EQ(buffer.capacity(), capacity);
+    }
+}
+
+TEST(CircularBuffer, InsertAndConsumeDoesNotResize) {
+    std::string_view input("1234567890123");
+    
+    circular_buffer buffer(1024);
+    size_t capacity = buffer.capacity();
+    size_t lim = capacity * 4;
+
+    for (int i=0; i<lim; ++i) {
+        buffer.insert(input.data(), input.size());
+        CHECK_EQ(buffer.size(), input.size());
+        CHECK_EQ(buffer, input);
+        
+        buffer.consume(input.size());
+        CHECK_EQ(buffer.size(), 0);
+        CHECK_EQ(buffer.capacity(), capacity);
+    }
+}
+
+TEST(CircularBuffer, PrepareIntoDefaultConstructedBuffer) {
+    circular_buffer buffer;
+    char *tail = buffer.prepare(100);
+
+    CHECK_GE(buffer.capacity(), 100);
+    CHECK_EQ(buffer.size(), 0);
+
+    memset(tail, 'x', 100);
+    buffer.commit(100);
+
+    CHECK_EQ(buffer.size(), 100);
+    CHECK(all_of(buffer, 'x'));
+}
+
+TEST(CircularBuffer, PrepareWithinCapacityDoesNotResize) {
+    circular_buffer buffer(1024);
+    size_t capacity = buffer.capacity();
+
+    CHECK_EQ(buffer.prepare(capacity), buffer.end());
+    buffer.commit(capacity / 2);
+    CHECK_EQ(buffer.prepare(capacity / 2), buffer.end());
+    CHECK_EQ(buffer.capacity(), capacity);
+}
+
+TEST(CircularBuffer, PrepareBeyondCapacityResizes) {
+    circular_buffer buffer(1024);
+    size_t capacity = buffer.capacity();
+    std::string input(capacity / 2, 'x');
+    buffer.insert(input.data(), input.size());
+
+    char *data = buffer.data();
+    char *tail = buffer.prepare(capacity);
+
+    CHECK_GE(buffer.capacity(), capacity + input.size());
+    CHECK_NE(buffer.data(), data);
+    CHECK_EQ(tail, buffer.end());
+    CHECK_EQ(buffer, input);
+    CHECK_ADDRESS_POISONED(data, "Buffer not deallocated");
+}
+
+TEST(CircularBuffer, PrepareAndCommitWrapsAround) {
+    circular_buffer buffer(1024);
+    size_t capacity = buffer.capacity();
+    std::vector<char> pending;
+    size_t written = 0;
+
+    // Writes and consumes at sizes coprime with the capacity, so the
+    // writable region regularly straddles the end of the buffer.
+    while (written < capacity * 8) {
+        char *tail = buffer.prepare(capacity / 3);
+
+        for (size_t i=0; i<capacity / 3; ++i) {
+            tail[i] = static_cast<char>(written + i);
+            pending.push_back(tail[i]);
+        }
+
+        buffer.commit(capacity / 3);
+        written += capacity / 3;
+
+        CHECK_EQ(buffer, pending);
+        buffer.consume(capacity / 5);
+        pending.erase(pending.begin(), pending.begin() + capacity / 5);
+    }
+
+    CHECK_LE(buffer.capacity(), capacity * 8);
+}
+
+TEST(CircularBuffer, ShrinkKeepsContents) {
+    circular_buffer buffer(1024 * 1024);
+    std::string input(5000, 'x');
+
+    buffer.insert(input.data(), input.size());
+    buffer.consume(1000);
+    buffer.shrink(0);
+
+    CHECK_LT(buffer.capacity(), 1024 * 1024);
+    CHECK_GE(buffer.capacity(), 4000);
+    CHECK_EQ(buffer.size(), 4000);
+    CHECK(all_of(buffer, 'x'));
+}
+
+TEST(CircularBuffer, ShrinkNeverGrows) {
+    circular_buffer buffer(1024);
+    size_t capacity = buffer.capacity();
+    char *data = buffer.data();
+
+    buffer.shrink(capacity * 4);
+    CHECK_EQ(buffer.capacity(), capacity);
+    CHECK_EQ(buffer.data(), data);
+}
+
+TEST(CircularBuffer, LargeBufferWraparound) {
+    // Large enough to be backed by huge pages, if they're enabled.
+    circular_buffer buffer(4 * 1024 * 1024);
+    size_t capacity = buffer.capacity();
+    std::string input(capacity / 3, 'x');
+
+    for (int i=0; i<8; ++i) {
+        buffer.insert(input.data(), input.size());
+        CHECK_EQ(buffer, input);
+        buffer.consume(input.size());
+    }
+
+    CHECK_EQ(buffer.capacity(), capacity);
+}
+
+BENCHMARK(CircularBuffer, WraparoundWritePerformance) {
+    // Writes are an odd size, so most of them straddle the end of the buffer.
+    // The mirrored mapping makes them a single contiguous copy.
+    std::string input(3001, 'x');
+    circular_buffer buffer(1024 * 1024);
+    size_t checksum = 0;
+
+    check::measure([&] {
+        for (int i=0; i<100000; ++i) {
+            char *tail = buffer.prepare(input.size());
+            memcpy(tail, input.data(), input.size());
+            buffer.commit(input.size());
+
+            if (buffer.size() > buffer.capacity() / 2) {
+                checksum += buffer[buffer.size() - 1];
+                buffer.consume(buffer.size());
+            }
+        }
+    });
+
+    CHECK_GT(checksum, 0);
+}
+
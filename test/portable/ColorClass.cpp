@@ -0,0 +1,141 @@
+//
+//  Neovim Mac Test
+//  ColorClass.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <random>
+#include <vector>
+#include "color_class.hpp"
+#include "check.hpp"
+
+// The replayed session report is in ColorClass.mm, the headless UI that
+// replays sessions depends on dispatch.
+
+static nvim::cell make_cell(std::string_view text,
+                            nvim::rgb_color foreground,
+                            nvim::rgb_color background) {
+    nvim::cell_attributes attrs = {};
+    attrs.foreground = foreground;
+    attrs.background = background;
+    return nvim::cell(text, &attrs);
+}
+
+TEST(ColorClass, Levels) {
+    CHECK_EQ(color_class::level(nvim::rgb_color(0, 0, 0)), 0);
+    CHECK_EQ(color_class::level(nvim::rgb_color(255, 255, 255)), GLYPH_COLOR_CLASS_LEVELS - 1);
+
+    for (uint32_t level=0; level<GLYPH_COLOR_CLASS_LEVELS; ++level) {
+        uint32_t grey = glyph_color_class_grey(level);
+        CHECK_EQ(color_class::level(nvim::rgb_color(grey, grey, grey)), level);
+    }
+}
+
+TEST(ColorClass, RepresentativeColors) {
+    nvim::rgb_color fg(0xEE, 0xEE, 0xEE);
+    nvim::rgb_color bg(0x10, 0x10, 0x20);
+    color_class cls = color_class::make(fg, bg);
+
+    CHECK(cls);
+    CHECK_EQ(color_class::level(cls.foreground()), color_class::level(fg));
+    CHECK_EQ(color_class::level(cls.background()), color_class::level(bg));
+    CHECK_EQ(color_class::make(cls.foreground(), cls.background()).index(), cls.index());
+}
+
+TEST(ColorClass, LowContrastHasNoClass) {
+    color_class cls = color_class::make(nvim::rgb_color(0x30, 0x30, 0x30),
+                                        nvim::rgb_color(0x20, 0x20, 0x20));
+
+    CHECK(!cls);
+    CHECK_EQ(cls.index(), GLYPH_NO_COLOR_CLASS);
+}
+
+TEST(ColorClass, Eligible) {
+    CHECK(color_class::eligible("a"));
+    CHECK(color_class::eligible("é"));
+    CHECK(color_class::eligible("Ω"));
+    CHECK(color_class::eligible("é"));
+    CHECK(!color_class::eligible("©️"));
+    CHECK(!color_class::eligible("\U0001F600"));
+
+    // Box drawing, block elements and powerline symbols.
+    CHECK(color_class::eligible("\u2500"));
+    CHECK(color_class::eligible("\u257F"));
+    CHECK(color_class::eligible("\u2588"));
+    CHECK(color_class::eligible("\u259F"));
+    CHECK(color_class::eligible("\uE0B0"));
+    CHECK(color_class::eligible("\uF8FF"));
+
+    // Neighbouring symbols that have emoji presentations.
+    CHECK(!color_class::eligible("\u2122"));
+    CHECK(!color_class::eligible("\u25B6"));
+    CHECK(!color_class::eligible("\u2600"));
+    CHECK(!color_class::eligible("\u2B50"));
+    CHECK(!color_class::eligible("\u2500\uFE0F"));
+
+    // Truncated sequences.
+    CHECK(!color_class::eligible("\xE2\x94"));
+}
+
+TEST(ColorClass, IneligibleCellHasNoClass) {
+    nvim::cell cell = make_cell("\U0001F600", nvim::rgb_color(255, 255, 255),
+                                nvim::rgb_color(0, 0, 0));
+
+    CHECK(!color_class::make(cell));
+}
+
+TEST(ColorClass, StatsCountsSavedEntries) {
+    color_class_stats stats;
+
+    // Two syntax colors on the same dark background share a class.
+    stats.add(make_cell("a", nvim::rgb_color(0xEE, 0xEE, 0xEE), nvim::rgb_color(0, 0, 0)));
+    stats.add(make_cell("a", nvim::rgb_color(0xFF, 0xF0, 0xD0), nvim::rgb_color(0, 0, 0)));
+    stats.add(make_cell("a", nvim::rgb_color(0xEE, 0xEE, 0xEE), nvim::rgb_color(0, 0, 0)));
+
+    // Low contrast pairs keep their exact colors.
+    stats.add(make_cell("b", nvim::rgb_color(0x30, 0x30, 0x30), nvim::rgb_color(0, 0, 0)));
+    stats.add(make_cell("b", nvim::rgb_color(0x28, 0x28, 0x28), nvim::rgb_color(0, 0, 0)));
+
+    // Empty cells don't have glyphs.
+    stats.add(make_cell(" ", nvim::rgb_color(0xEE, 0xEE, 0xEE), nvim::rgb_color(0, 0, 0)));
+
+    CHECK_EQ(stats.exact_entries(), 4);
+    CHECK_EQ(stats.class_entries(), 3);
+    CHECK_EQ(stats.saved_entries(), 1);
+}
+
+BENCHMARK(ColorClass, StatsPerformance) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<uint32_t> component(0, 255);
+    std::uniform_int_distribution<uint32_t> letter('a', 'z');
+
+    std::vector<nvim::rgb_color> palette;
+
+    for (int i=0; i<16; ++i) {
+        palette.push_back(nvim::rgb_color(component(rng), component(rng), component(rng)));
+    }
+
+    std::vector<nvim::cell> cells;
+    cells.reserve(200 * 60);
+
+    for (int i=0; i<200 * 60; ++i) {
+        char text = static_cast<char>(letter(rng));
+        cells.push_back(make_cell(std::string_view(&text, 1),
+                                  palette[rng() % palette.size()],
+                                  palette[rng() % 2]));
+    }
+
+    check::measure([&] {
+        color_class_stats stats;
+
+        for (const nvim::cell &cell : cells) {
+            stats.add(cell);
+        }
+
+        CHECK_LE(stats.class_entries(), stats.exact_entries());
+    });
+}
+
@@ -0,0 +1,466 @@
+//
+//  Neovim Mac Test
+//  FrameBuilder.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <random>
+#include <vector>
+#include "frame_builder.hpp"
+#include "frame_helpers.hpp"
+#include "check.hpp"
+
+// Tests of grids built by a ui_controller, and the replayed session
+// benchmark, are in FrameBuilder.mm. The UI depends on dispatch.
+
+static nvim::cell make_cell(std::string_view text,
+                            nvim::rgb_color background,
+                            uint16_t flags = 0) {
+    nvim::cell_attributes attrs = {};
+    attrs.foreground = nvim::rgb_color(255, 255, 255);
+    attrs.background = background;
+    attrs.flags = flags;
+    return nvim::cell(text, &attrs);
+}
+
+static nvim::cursor make_cursor(const std::vector<nvim::cell> &cells,
+                                size_t width, size_t row, size_t col,
+                                nvim::cursor_shape shape) {
+    nvim::cursor_attributes attrs = {};
+    attrs.background = nvim::rgb_color(255, 0, 0);
+    attrs.foreground = nvim::rgb_color(0, 0, 0);
+    attrs.shape = shape;
+    return nvim::cursor(row, col, cells.data() + (row * width) + col, attrs);
+}
+
+/// Builds a frame for cells and returns the instance counts.
+struct test_frame {
+    std::vector<background_data> backgrounds;
+    std::vector<glyph_data> glyphs;
+    std::vector<line_data> lines;
+    frame_counts counts;
+
+    test_frame(const std::vector<nvim::cell> &cells, size_t width,
+               const nvim::cursor &cursor) {
+        size_t height = cells.size() / width;
+        backgrounds.resize(frame_builder::max_backgrounds(cells.size()));
+        glyphs.resize(frame_builder::max_glyphs(cells.size()));
+        lines.resize(frame_builder::max_lines(cells.size()));
+
+        frame_builder builder;
+        adjusted_grid grid(cells.data(), width, height, cursor);
+
+        counts = builder.build(grid, backgrounds.data(), glyphs.data(), nullptr,
+                               lines.data(), [](const nvim::cell &cell, simd_short2 gridpos) {
+            return glyph_data(gridpos, cell.width(), glyph_rect());
+        });
+    }
+};
+
+/// A large grid with undercurls, underlines, and color changes on every row.
+static std::vector<nvim::cell> make_large_grid(size_t width, size_t height) {
+    std::mt19937 rng(7);
+    std::vector<nvim::cell> cells;
+    cells.reserve(width * height);
+
+    nvim::rgb_color colors[] = {
+        nvim::rgb_color(0x1E, 0x1E, 0x1E),
+        nvim::rgb_color(0x26, 0x4F, 0x78)
+    };
+
+    for (size_t row=0; row<height; ++row) {
+        for (size_t col=0; col<width; ++col) {
+            uint16_t flags = 0;
+
+            // Undercurls run to the end of every 3rd row, checking that
+            // continuations don't leak into the next row or band.
+            if (row % 3 == 0 && col > width / 2) {
+                flags |= nvim::cell_attributes::undercurl;
+            }
+
+            if (rng() % 32 == 0) {
+                flags |= nvim::cell_attributes::strikethrough;
+            }
+
+            char text[] = {static_cast<char>('a' + rng() % 26), 0};
+            cells.push_back(make_cell(rng() % 5 ? text : " ",
+                                      colors[(col / 17 + row) % 2], flags));
+        }
+    }
+
+    return cells;
+}
+
+TEST(FrameBuilder, BackgroundSpans) {
+    const size_t width = 10;
+    nvim::rgb_color red(255, 0, 0);
+    nvim::rgb_color blue(0, 0, 255);
+    std::vector<nvim::cell> cells;
+
+    // Row 0: One run of a single color.
+    for (size_t i=0; i<width; ++i) {
+        cells.push_back(make_cell(" ", blue));
+    }
+
+    // Row 1: Two runs.
+    for (size_t i=0; i<width; ++i) {
+        cells.push_back(make_cell("a", i < 5 ? blue : red));
+    }
+
+    // Row 2: Alternating colors, every cell is a run.
+    for (size_t i=0; i<width; ++i) {
+        cells.push_back(make_cell(" ", i % 2 ? blue : red));
+    }
+
+    auto cursor = make_cursor(cells, width, 0, 0, nvim::cursor_shape::vertical);
+    test_frame frame(cells, width, cursor);
+
+    CHECK_EQ(frame.counts.backgrounds, 13);
+    CHECK_EQ(frame.counts.glyphs, 10);
+    CHECK_EQ(frame.counts.lines, 0);
+
+    const background_data &first = frame.backgrounds[0];
+    CHECK_EQ(first.grid_position.x, 0);
+    CHECK_EQ(first.grid_position.y, 0);
+    CHECK_EQ(first.length, width);
+
+    const background_data &second = frame.backgrounds[2];
+    CHECK_EQ(second.grid_position.x, 5);
+    CHECK_EQ(second.grid_position.y, 1);
+    CHECK_EQ(second.length, 5);
+    CHECK_EQ(second.color, red.opaque());
+}
+
+TEST(FrameBuilder, SpansDoNotCrossRows) {
+    const size_t width = 4;
+    std::vector<nvim::cell> cells(width * 3, make_cell(" ", nvim::rgb_color(1, 2, 3)));
+
+    auto cursor = make_cursor(cells, width, 0, 0, nvim::cursor_shape::vertical);
+    test_frame frame(cells, width, cursor);
+
+    CHECK_EQ(frame.counts.backgrounds, 3);
+
+    for (size_t i=0; i<3; ++i) {
+        CHECK_EQ(frame.backgrounds[i].grid_position.y, i);
+        CHECK_EQ(frame.backgrounds[i].length, width);
+    }
+}
+
+TEST(FrameBuilder, BlockCursorSplitsSpan) {
+    const size_t width = 8;
+    std::vector<nvim::cell> cells(width, make_cell(" ", nvim::rgb_color(0, 0, 0)));
+
+    auto cursor = make_cursor(cells, width, 0, 3, nvim::cursor_shape::block);
+    test_frame frame(cells, width, cursor);
+
+    CHECK_EQ(frame.counts.backgrounds, 3);
+    CHECK_EQ(frame.backgrounds[0].length, 3);
+    CHECK_EQ(frame.backgrounds[1].grid_position.x, 3);
+    CHECK_EQ(frame.backgrounds[1].length, 1);
+    CHECK_EQ(frame.backgrounds[1].color, nvim::rgb_color(255, 0, 0).opaque());
+    CHECK_EQ(frame.backgrounds[2].length, 4);
+}
+
+TEST(FrameBuilder, UndercurlContinuation) {
+    const size_t width = 6;
+    nvim::rgb_color black(0, 0, 0);
+    std::vector<nvim::cell> cells;
+
+    for (size_t i=0; i<width; ++i) {
+        uint16_t flags = i == 2 ? 0 : nvim::cell_attributes::undercurl;
+        cells.push_back(make_cell("a", black, flags));
+    }
+
+    auto cursor = make_cursor(cells, width, 0, 0, nvim::cursor_shape::vertical);
+    test_frame frame(cells, width, cursor);
+
+    CHECK_EQ(frame.counts.lines, 5);
+    CHECK_EQ(frame.lines[0].count, 0);
+    CHECK_EQ(frame.lines[1].count, 1);
+    CHECK_EQ(frame.lines[2].count, 0);
+    CHECK_EQ(frame.lines[4].count, 2);
+}
+
+TEST(FrameBuilder, CursorOverlay) {
+    const size_t width = 6;
+    std::vector<nvim::cell> cells;
+
+    for (size_t i=0; i<width; ++i) {
+        cells.push_back(make_cell("a", nvim::rgb_color(0, 0, 0),
+                                  nvim::cell_attributes::undercurl));
+    }
+
+    auto cursor = make_cursor(cells, width, 0, 3, nvim::cursor_shape::block);
+    test_frame frame(cells, width, cursor);
+
+    background_data backgrounds[frame_builder::max_cursor_counts.backgrounds];
+    glyph_data glyphs[frame_builder::max_cursor_counts.glyphs];
+    glyph_colors colors[frame_builder::max_cursor_counts.glyphs];
+    line_data lines[frame_builder::max_cursor_counts.lines];
+    nvim::rgb_color glyph_background;
+
+    frame_builder builder;
+    frame_counts counts = builder.build_cursor(cursor, width, backgrounds, glyphs, colors, lines,
+                                               [&](const nvim::cell &cell, simd_short2 gridpos) {
+        glyph_background = cell.background();
+        return glyph_data(gridpos, cell.width(), glyph_rect());
+    });
+
+    CHECK_EQ(counts.backgrounds, 1);
+    CHECK_EQ(counts.glyphs, 1);
+    CHECK_EQ(counts.lines, 1);
+
+    CHECK_EQ(backgrounds[0].grid_position.x, 3);
+    CHECK_EQ(backgrounds[0].length, 1);
+    CHECK_EQ(backgrounds[0].color, nvim::rgb_color(255, 0, 0).opaque());
+    CHECK_EQ(glyph_background.opaque(), nvim::rgb_color(255, 0, 0).opaque());
+    CHECK_EQ(colors[0].background, nvim::rgb_color(255, 0, 0).opaque());
+    CHECK_EQ(glyphs[0].grid_position.x, 3);
+
+    // The overlay's undercurl continues from the cells to its left, exactly
+    // like the cursor adjusted frame's.
+    CHECK_EQ(lines[0].grid_position.x, 3);
+    CHECK_EQ(lines[0].count, frame.lines[3].count);
+    CHECK_EQ(lines[0].count, 3);
+}
+
+TEST(FrameBuilder, CursorOverlayRedrawsOverhangs) {
+    // Row 0 is underlined. Row 1 starts with a double width cell, and the
+    // cursor is on the cell it overhangs into.
+    const size_t width = 4;
+    nvim::rgb_color black(0, 0, 0);
+    std::vector<nvim::cell> cells(width, make_cell("a", black, nvim::cell_attributes::underline));
+    cells.push_back(make_cell("b", black, nvim::cell_attributes::doublewidth));
+    cells.push_back(make_cell("", black));
+    cells.push_back(make_cell("c", black));
+    cells.push_back(make_cell("d", black));
+
+    auto cursor = make_cursor(cells, width, 1, 1, nvim::cursor_shape::block);
+
+    background_data backgrounds[frame_builder::max_cursor_counts.backgrounds];
+    glyph_data glyphs[frame_builder::max_cursor_counts.glyphs];
+    glyph_colors colors[frame_builder::max_cursor_counts.glyphs];
+    line_data lines[frame_builder::max_cursor_counts.lines];
+
+    frame_builder builder;
+    frame_counts counts = builder.build_cursor(cursor, width, backgrounds, glyphs,
+                                               colors, lines, make_glyph);
+
+    // The double width glyph is redrawn with its own colors, the cursor's
+    // cell is empty.
+    CHECK_EQ(counts.glyphs, 1);
+    CHECK_EQ(glyphs[0].grid_position.x, 0);
+    CHECK_EQ(glyphs[0].grid_position.y, 1);
+    CHECK_EQ(glyphs[0].rect.texture_origin.x, 'b');
+    CHECK_EQ(colors[0].background, black.opaque());
+
+    // So is the underline above the cursor.
+    CHECK_EQ(counts.lines, 1);
+    CHECK_EQ(lines[0].grid_position.x, 1);
+    CHECK_EQ(lines[0].grid_position.y, 0);
+
+    // Cursors on the first row and column have no neighbours to redraw.
+    cursor = make_cursor(cells, width, 0, 0, nvim::cursor_shape::block);
+    counts = builder.build_cursor(cursor, width, backgrounds, glyphs, colors, lines, make_glyph);
+
+    CHECK_EQ(counts.glyphs, 1);
+    CHECK_EQ(glyphs[0].grid_position.x, 0);
+    CHECK_EQ(glyphs[0].grid_position.y, 0);
+    CHECK_EQ(counts.lines, 1);
+    CHECK_EQ(lines[0].grid_position.y, 0);
+}
+
+TEST(FrameBuilder, CursorOverlayOtherShapes) {
+    std::vector<nvim::cell> cells(4, make_cell("a", nvim::rgb_color(0, 0, 0)));
+    auto cursor = make_cursor(cells, 4, 0, 1, nvim::cursor_shape::vertical);
+
+    background_data backgrounds[frame_builder::max_cursor_counts.backgrounds];
+    glyph_data glyphs[frame_builder::max_cursor_counts.glyphs];
+    line_data lines[frame_builder::max_cursor_counts.lines];
+
+    auto get_glyph = [](const nvim::cell &cell, simd_short2 gridpos) {
+        return glyph_data(gridpos, cell.width(), glyph_rect());
+    };
+
+    frame_builder builder;
+    frame_counts counts = builder.build_cursor(cursor, 4, backgrounds, glyphs, nullptr, lines, get_glyph);
+    CHECK_EQ(counts.backgrounds + counts.glyphs + counts.lines, 0);
+
+    // Hidden block cursors have no overlay.
+    cursor = make_cursor(cells, 4, 0, 1, nvim::cursor_shape::block);
+    cursor.toggle_off();
+
+    counts = builder.build_cursor(cursor, 4, backgrounds, glyphs, nullptr, lines, get_glyph);
+    CHECK_EQ(counts.backgrounds + counts.glyphs + counts.lines, 0);
+}
+
+TEST(FrameBuilder, GridWithoutCursor) {
+    const size_t width = 8;
+    std::vector<nvim::cell> cells(width * 2, make_cell("a", nvim::rgb_color(0, 0, 0)));
+
+    std::vector<background_data> backgrounds(cells.size());
+    std::vector<glyph_data> glyphs(cells.size());
+
+    frame_builder builder;
+    frame_counts counts = builder.build(adjusted_grid(cells.data(), width, 2),
+                                        backgrounds.data(), glyphs.data(), nullptr, nullptr,
+                                        [](const nvim::cell &cell, simd_short2 gridpos) {
+        return glyph_data(gridpos, cell.width(), glyph_rect());
+    });
+
+    CHECK_EQ(counts.backgrounds, 2);
+    CHECK_EQ(counts.glyphs, 16);
+    CHECK_EQ(backgrounds[0].length, width);
+}
+
+TEST(FrameBuilder, ParallelMatchesSerial) {
+    const size_t width = 400;
+    const size_t height = 300;
+    std::vector<nvim::cell> cells = make_large_grid(width, height);
+
+    // Put the block cursor at the start of a band.
+    const size_t band_count = std::min((width * height) / frame_builder::min_band_cells,
+                                       frame_builder::max_bands);
+    const size_t band_rows = (height + band_count - 1) / band_count;
+    auto cursor = make_cursor(cells, width, band_rows, 5, nvim::cursor_shape::block);
+    adjusted_grid grid(cells.data(), width, height, cursor);
+
+    CHECK_GT(band_count, 1);
+
+    std::vector<background_data> serial_backgrounds(cells.size());
+    std::vector<glyph_data> serial_glyphs(cells.size());
+    std::vector<glyph_colors> serial_colors(cells.size());
+    std::vector<line_data> serial_lines(cells.size() * 2);
+
+    frame_builder builder;
+    frame_counts serial = builder.build(grid, serial_backgrounds.data(),
+                                        serial_glyphs.data(), serial_colors.data(),
+                                        serial_lines.data(), make_glyph);
+
+    // The counting pass sizes the output exactly, bands write straight into
+    // it.
+    frame_counts counted = builder.count(grid, apply_auto);
+    CHECK_EQ(counted.backgrounds, serial.backgrounds);
+    CHECK_EQ(counted.glyphs, serial.glyphs);
+    CHECK_EQ(counted.lines, serial.lines);
+
+    std::vector<background_data> backgrounds(counted.backgrounds);
+    std::vector<glyph_data> glyphs(counted.glyphs);
+    std::vector<glyph_colors> colors(counted.glyphs);
+    std::vector<line_data> lines(counted.lines);
+
+    test_glyph_source source;
+    frame_counts parallel = builder.build(grid, backgrounds.data(), glyphs.data(),
+                                          colors.data(), lines.data(), source, apply_auto);
+
+    CHECK_EQ(parallel.backgrounds, serial.backgrounds);
+    CHECK_EQ(parallel.glyphs, serial.glyphs);
+    CHECK_EQ(parallel.lines, serial.lines);
+
+    for (size_t i=0; i<serial.backgrounds; ++i) {
+        CHECK(simd_equal(backgrounds[i].grid_position,
+                                 serial_backgrounds[i].grid_position));
+        CHECK_EQ(backgrounds[i].length, serial_backgrounds[i].length);
+        CHECK_EQ(backgrounds[i].color, serial_backgrounds[i].color);
+    }
+
+    for (size_t i=0; i<serial.glyphs; ++i) {
+        CHECK(simd_equal(glyphs[i].grid_position, serial_glyphs[i].grid_position));
+        CHECK_EQ(glyphs[i].rect.texture_origin.x, serial_glyphs[i].rect.texture_origin.x);
+        CHECK_EQ(colors[i].foreground, serial_colors[i].foreground);
+        CHECK_EQ(colors[i].background, serial_colors[i].background);
+    }
+
+    for (size_t i=0; i<serial.lines; ++i) {
+        CHECK(simd_equal(lines[i].grid_position, serial_lines[i].grid_position));
+        CHECK_EQ(lines[i].count, serial_lines[i].count);
+        CHECK_EQ(lines[i].period, serial_lines[i].period);
+    }
+
+    // Glyph misses are resolved with get(), a second frame finds every glyph.
+    CHECK_GT(source.get_count, 0);
+    source.get_count = 0;
+    builder.count(grid, apply_auto);
+    builder.build(grid, backgrounds.data(), glyphs.data(), nullptr, lines.data(),
+                  source, apply_auto);
+
+    CHECK_EQ(source.get_count, 0);
+}
+
+TEST(FrameBuilder, CountSmallGrid) {
+    // Grids too small to split are counted and built on the calling thread.
+    const size_t width = 40;
+    const size_t height = 10;
+    std::vector<nvim::cell> cells = make_large_grid(width, height);
+    auto cursor = make_cursor(cells, width, 3, 5, nvim::cursor_shape::block);
+    test_frame frame(cells, width, cursor);
+
+    frame_builder builder;
+    adjusted_grid grid(cells.data(), width, height, cursor);
+    frame_counts counted = builder.count(grid, apply_auto);
+
+    CHECK_EQ(counted.backgrounds, frame.counts.backgrounds);
+    CHECK_EQ(counted.glyphs, frame.counts.glyphs);
+    CHECK_EQ(counted.lines, frame.counts.lines);
+
+    std::vector<background_data> backgrounds(counted.backgrounds);
+    std::vector<glyph_data> glyphs(counted.glyphs);
+    std::vector<line_data> lines(counted.lines);
+    test_glyph_source source;
+
+    frame_counts built = builder.build(grid, backgrounds.data(), glyphs.data(),
+                                       nullptr, lines.data(), source, apply_auto);
+
+    CHECK_EQ(built.backgrounds, counted.backgrounds);
+    CHECK_EQ(built.glyphs, counted.glyphs);
+    CHECK_EQ(built.lines, counted.lines);
+}
+
+BENCHMARK(FrameBuilder, ParallelBuildPerformance) {
+    const size_t width = 960;
+    const size_t height = 270;
+    std::vector<nvim::cell> cells = make_large_grid(width, height);
+    auto cursor = make_cursor(cells, width, 10, 10, nvim::cursor_shape::block);
+    adjusted_grid grid(cells.data(), width, height, cursor);
+
+    std::vector<background_data> backgrounds(cells.size());
+    std::vector<glyph_data> glyphs(cells.size());
+    std::vector<line_data> lines(cells.size() * 2);
+    test_glyph_source source;
+    frame_builder builder;
+
+    check::measure([&] {
+        builder.count(grid, apply_auto);
+        builder.build(grid, backgrounds.data(), glyphs.data(), nullptr,
+                      lines.data(), source, apply_auto);
+    });
+}
+
+BENCHMARK(FrameBuilder, BuildPerformance) {
+    // A 4K sized grid with syntax highlighting like background changes.
+    const size_t width = 400;
+    const size_t height = 120;
+    std::mt19937 rng(42);
+    std::vector<nvim::cell> cells;
+    cells.reserve(width * height);
+
+    nvim::rgb_color background(0x1E, 0x1E, 0x1E);
+    nvim::rgb_color highlight(0x26, 0x4F, 0x78);
+
+    for (size_t i=0; i<width * height; ++i) {
+        bool highlighted = (i % width) > 80 && (rng() % 64) == 0;
+        cells.push_back(make_cell(rng() % 4 ? "a" : " ",
+                                  highlighted ? highlight : background));
+    }
+
+    auto cursor = make_cursor(cells, width, 10, 10, nvim::cursor_shape::block);
+
+    check::measure([&] {
+        test_frame frame(cells, width, cursor);
+        CHECK_LT(frame.counts.backgrounds, cells.size() / 8);
+    });
+}
+
@@ -0,0 +1,148 @@
+//
+//  Neovim Mac Test
+//  InlineFunction.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <cstdio>
+#include <memory>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "inline_function.hpp"
+#include "check.hpp"
+
+using nvim::inline_function;
+
+/// Calls function in a child process. Returns true if the child aborted.
+static bool aborts(inline_function<void()> &function) {
+    pid_t pid = fork();
+
+    if (pid == 0) {
+        freopen("/dev/null", "w", stderr);
+        function();
+        _exit(0);
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT;
+}
+
+/// Counts live copies, so we can check callables are destroyed exactly once.
+struct counted {
+    int *live;
+
+    explicit counted(int *live): live(live) {
+        *live += 1;
+    }
+
+    counted(counted &&other): live(other.live) {
+        *live += 1;
+    }
+
+    ~counted() {
+        *live -= 1;
+    }
+
+    int operator()(int value) {
+        return value + 1;
+    }
+};
+
+TEST(InlineFunction, Empty) {
+    inline_function<void()> function;
+    CHECK(!function);
+
+    inline_function<void()> null = nullptr;
+    CHECK(!null);
+}
+
+TEST(InlineFunction, EmptyCallAborts) {
+    inline_function<void()> empty;
+    CHECK(aborts(empty));
+
+    inline_function<void()> function = []() {};
+    CHECK(!aborts(function));
+
+    inline_function<void()> moved = std::move(function);
+    CHECK(aborts(function));
+}
+
+TEST(InlineFunction, Invoke) {
+    int total = 0;
+    inline_function<int(int)> function = [&total](int value) {
+        total += value;
+        return total;
+    };
+
+    CHECK(function);
+    CHECK_EQ(function(2), 2);
+    CHECK_EQ(function(3), 5);
+    CHECK_EQ(total, 5);
+}
+
+TEST(InlineFunction, MoveOnlyCapture) {
+    auto value = std::make_unique<int>(42);
+    inline_function<int()> function = [value = std::move(value)]() {
+        return *value;
+    };
+
+    CHECK_EQ(function(), 42);
+}
+
+TEST(InlineFunction, Move) {
+    int live = 0;
+
+    {
+        inline_function<int(int)> first = counted(&live);
+        CHECK_EQ(live, 1);
+
+        inline_function<int(int)> second = std::move(first);
+        CHECK(!first);
+        CHECK(second);
+        CHECK_EQ(second(1), 2);
+        CHECK_EQ(live, 1);
+
+        inline_function<int(int)> third = counted(&live);
+        CHECK_EQ(live, 2);
+
+        third = std::move(second);
+        CHECK(!second);
+        CHECK_EQ(third(2), 3);
+        CHECK_EQ(live, 1);
+    }
+
+    CHECK_EQ(live, 0);
+}
+
+TEST(InlineFunction, Reset) {
+    int live = 0;
+    inline_function<int(int)> function = counted(&live);
+    CHECK_EQ(live, 1);
+
+    function.reset();
+    CHECK(!function);
+    CHECK_EQ(live, 0);
+
+    function = counted(&live);
+    function = nullptr;
+    CHECK(!function);
+    CHECK_EQ(live, 0);
+}
+
+TEST(InlineFunction, Capacity) {
+    void *a = nullptr, *b = nullptr, *c = nullptr;
+    void *d = nullptr, *e = nullptr, *f = nullptr;
+
+    inline_function<bool()> function = [a, b, c, d, e, f]() {
+        return !a && !b && !c && !d && !e && !f;
+    };
+
+    CHECK(function());
+    CHECK_EQ(sizeof(function), 8 * sizeof(void*));
+}
+
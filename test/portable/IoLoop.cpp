@@ -0,0 +1,457 @@
+//
+//  Neovim Mac Test
+//  IoLoop.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "io_loop.hpp"
+#include "check.hpp"
+
+/// A counting semaphore whose waits time out after a second.
+class semaphore {
+private:
+    std::mutex lock;
+    std::condition_variable condition;
+    size_t count = 0;
+
+public:
+    void signal() {
+        std::lock_guard guard(lock);
+        count += 1;
+        condition.notify_one();
+    }
+
+    /// Returns false if no signal arrives within a second.
+    bool wait() {
+        std::unique_lock guard(lock);
+
+        if (!condition.wait_for(guard, std::chrono::seconds(1), [this] { return count; })) {
+            return false;
+        }
+
+        count -= 1;
+        return true;
+    }
+};
+
+/// State shared between a test and its loop callbacks. The loop is the last
+/// member, so it stops before the rest of the state is destroyed.
+struct loop_state {
+    int read_fd = -1;
+    int write_fd = -1;
+    std::string received;
+    std::string outgoing;
+    std::atomic<int> cancels = 0;
+    std::vector<int> order;
+    semaphore signals;
+    nvim::io_loop loop;
+
+    /// Opens the loop. Reads are echoed into received, writes drain outgoing.
+    /// Reading EOF cancels the loop.
+    int open(int readfd, int writefd) {
+        read_fd = readfd;
+        write_fd = writefd;
+
+        nvim::io_handlers handlers;
+        handlers.context = this;
+
+        handlers.can_read = [](void *context) {
+            loop_state *state = static_cast<loop_state*>(context);
+            char buffer[16384];
+            ssize_t bytes = read(state->read_fd, buffer, sizeof(buffer));
+
+            if (bytes <= 0) {
+                state->loop.cancel();
+            } else {
+                state->received.append(buffer, bytes);
+                state->signals.signal();
+            }
+        };
+
+        handlers.can_write = [](void *context) {
+            loop_state *state = static_cast<loop_state*>(context);
+            ssize_t bytes = write(state->write_fd, state->outgoing.data(),
+                                  state->outgoing.size());
+
+            state->outgoing.erase(0, bytes);
+
+            if (state->outgoing.empty()) {
+                state->loop.suspend_writes();
+                state->signals.signal();
+            }
+        };
+
+        handlers.cancelled = [](void *context) {
+            loop_state *state = static_cast<loop_state*>(context);
+            state->cancels += 1;
+            state->signals.signal();
+        };
+
+        return loop.open(readfd, writefd, handlers);
+    }
+
+    /// Cancels the loop from the loop and waits for the cancelled handler.
+    void cancel() {
+        loop.sync(this, [](void *context) {
+            static_cast<loop_state*>(context)->loop.cancel();
+        });
+
+        while (!cancels) {
+            signals.wait();
+        }
+    }
+
+    /// Waits for a signal, returns false if none arrives within a second.
+    bool wait() {
+        return signals.wait();
+    }
+
+    /// Returns the number of bytes received, read on the loop.
+    size_t received_size() {
+        std::pair<loop_state*, size_t> size = {this, 0};
+
+        loop.sync(&size, [](void *context) {
+            auto size = static_cast<std::pair<loop_state*, size_t>*>(context);
+            size->second = size->first->received.size();
+        });
+
+        return size.second;
+    }
+};
+
+/// A pair of pipes, input is read by the loop and output is written by it.
+struct pipes {
+    int input[2];
+    int output[2];
+
+    pipes() {
+        CHECK_EQ(pipe(input), 0);
+        CHECK_EQ(pipe(output), 0);
+    }
+
+    ~pipes() {
+        close(input[0]);
+        close(output[0]);
+        close(output[1]);
+    }
+};
+
+TEST(IoLoop, Reads) {
+    pipes fds;
+    loop_state state;
+    CHECK_EQ(state.open(fds.input[0], fds.output[1]), 0);
+
+    write(fds.input[1], "hello", 5);
+    CHECK(state.wait());
+    write(fds.input[1], " world", 6);
+
+    while (state.received_size() < 11) {
+        CHECK(state.wait());
+    }
+
+    CHECK_EQ(state.received, "hello world");
+
+    // EOF cancels the loop, the cancelled handler is called once.
+    close(fds.input[1]);
+
+    while (!state.cancels) {
+        CHECK(state.wait());
+    }
+
+    CHECK(state.loop.is_cancelled());
+    CHECK_EQ(state.cancels.load(), 1);
+}
+
+TEST(IoLoop, Writes) {
+    pipes fds;
+    loop_state state;
+    CHECK_EQ(state.open(fds.input[0], fds.output[1]), 0);
+
+    state.loop.sync(&state, [](void *context) {
+        loop_state *state = static_cast<loop_state*>(context);
+        state->outgoing = "written on the loop";
+        state->loop.resume_writes();
+    });
+
+    CHECK(state.wait());
+
+    char buffer[64] = {};
+    read(fds.output[0], buffer, sizeof(buffer));
+    CHECK_EQ(std::string(buffer), "written on the loop");
+
+    state.cancel();
+    close(fds.input[1]);
+}
+
+TEST(IoLoop, SameDescriptor) {
+    pipes fds;
+    int sockets[2];
+    CHECK_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0);
+
+    loop_state state;
+    CHECK_EQ(state.open(sockets[0], sockets[0]), 0);
+
+    state.loop.sync(&state, [](void *context) {
+        loop_state *state = static_cast<loop_state*>(context);
+        state->outgoing = "ping";
+        state->loop.resume_writes();
+    });
+
+    CHECK(state.wait());
+
+    char buffer[8] = {};
+    read(sockets[1], buffer, sizeof(buffer));
+    CHECK_EQ(std::string(buffer), "ping");
+
+    write(sockets[1], "pong", 4);
+    CHECK(state.wait());
+    CHECK_EQ(state.received, "pong");
+
+    close(sockets[1]);
+
+    while (!state.cancels) {
+        CHECK(state.wait());
+    }
+
+    close(sockets[0]);
+    close(fds.input[1]);
+}
+
+TEST(IoLoop, AsyncOrder) {
+    pipes fds;
+    loop_state state;
+    CHECK_EQ(state.open(fds.input[0], fds.output[1]), 0);
+
+    for (int i=0; i<100; ++i) {
+        state.loop.async(&state, [](void *context) {
+            loop_state *state = static_cast<loop_state*>(context);
+            state->order.push_back(static_cast<int>(state->order.size()));
+        });
+    }
+
+    // Sync functions run after previously submitted async functions.
+    state.loop.sync(&state, [](void *context) {
+        static_cast<loop_state*>(context)->order.push_back(-1);
+    });
+
+    CHECK_EQ(state.order.size(), 101);
+    CHECK_EQ(state.order[99], 99);
+    CHECK_EQ(state.order.back(), -1);
+
+    state.cancel();
+    close(fds.input[1]);
+}
+
+TEST(IoLoop, Timeouts) {
+    struct timeout_context : nvim::wheel_timer {
+        loop_state *state;
+        int id;
+        nvim::io_time deadline;
+        nvim::io_time fired;
+    };
+
+    auto fire = [](void *context) {
+        timeout_context *timeout = static_cast<timeout_context*>(context);
+        timeout->fired = nvim::io_time_after(0);
+        timeout->state->order.push_back(timeout->id);
+        timeout->state->signals.signal();
+    };
+
+    pipes fds;
+    timeout_context timeouts[5];
+
+    {
+        loop_state state;
+        CHECK_EQ(state.open(fds.input[0], fds.output[1]), 0);
+
+        constexpr uint64_t msec = 1000000;
+
+        nvim::io_time deadlines[] = {
+            nvim::io_time_after(30 * msec),
+            nvim::io_time_after(10 * msec),
+            0,
+            nvim::io_time_after(20 * msec),
+            nvim::io_time_after(3600 * 1000 * msec)
+        };
+
+        for (int i=0; i<5; ++i) {
+            timeouts[i].state = &state;
+            timeouts[i].id = i;
+            timeouts[i].deadline = deadlines[i];
+            timeouts[i].fired = 0;
+            timeouts[i].context = &timeouts[i];
+            timeouts[i].function = fire;
+            state.loop.add_timeout(&timeouts[i], deadlines[i]);
+        }
+
+        // The last timeout outlives the state, it only records when it fired.
+        timeouts[4].function = [](void *context) {
+            static_cast<timeout_context*>(context)->fired = nvim::io_time_after(0);
+        };
+
+        state.loop.sync(&timeouts[3], [](void *context) {
+            timeout_context *timeout = static_cast<timeout_context*>(context);
+            timeout->state->loop.remove_timeout(timeout);
+        });
+
+        for (int i=0; i<3; ++i) {
+            CHECK(state.wait());
+        }
+
+        CHECK_EQ(state.order.size(), 3);
+        CHECK_EQ(state.order[0], 2);
+        CHECK_EQ(state.order[1], 1);
+        CHECK_EQ(state.order[2], 0);
+
+        // Timeouts never fire early, removed timeouts never fire.
+        CHECK_GE(timeouts[0].fired, timeouts[0].deadline);
+        CHECK_GE(timeouts[1].fired, timeouts[1].deadline);
+        CHECK_EQ(timeouts[3].fired, 0);
+        CHECK_EQ(timeouts[4].fired, 0);
+
+        state.cancel();
+    }
+
+    // Pending timeouts run when the loop is destroyed.
+    CHECK_NE(timeouts[4].fired, 0);
+    CHECK_EQ(timeouts[3].fired, 0);
+    close(fds.input[1]);
+}
+
+TEST(IoLoop, Finalizer) {
+    pipes fds;
+    semaphore finalized;
+
+    {
+        loop_state state;
+        CHECK_EQ(state.open(fds.input[0], fds.output[1]), 0);
+
+        state.loop.set_finalizer(&finalized, [](void *context) {
+            static_cast<semaphore*>(context)->signal();
+        });
+
+        state.cancel();
+    }
+
+    CHECK(finalized.wait());
+    close(fds.input[1]);
+}
+
+/// Streams bytes into the loop from one thread, while other threads submit
+/// async functions and timeouts. Checks every byte, function and timeout
+/// arrives, and that no timeout runs early.
+static void run_under_load(size_t bytes, int threads, int tasks, int timeouts) {
+    struct load_timer : nvim::wheel_timer {
+        nvim::io_time deadline;
+        nvim::io_time fired = 0;
+    };
+
+    pipes fds;
+    loop_state state;
+    std::atomic<int> ran = 0;
+    std::vector<load_timer> timers(threads * timeouts);
+    CHECK_EQ(state.open(fds.input[0], fds.output[1]), 0);
+
+    std::string data(bytes, 0);
+
+    for (size_t i=0; i<bytes; ++i) {
+        data[i] = static_cast<char>(i * 31);
+    }
+
+    std::thread writer([&] {
+        for (size_t offset = 0; offset < data.size();) {
+            ssize_t written = write(fds.input[1], data.data() + offset,
+                                    std::min<size_t>(65536, data.size() - offset));
+            if (written <= 0) break;
+            offset += written;
+        }
+
+        close(fds.input[1]);
+    });
+
+    std::vector<std::thread> submitters;
+
+    for (int t=0; t<threads; ++t) {
+        submitters.emplace_back([&, t] {
+            std::mt19937 random(t);
+            std::uniform_int_distribution<uint64_t> delays(0, 20000000);
+
+            for (int i=0; i<tasks; ++i) {
+                state.loop.async(&ran, [](void *context) {
+                    *static_cast<std::atomic<int>*>(context) += 1;
+                });
+
+                if (i % (tasks / timeouts) == 0 && i / (tasks / timeouts) < timeouts) {
+                    load_timer &timer = timers[t * timeouts + i / (tasks / timeouts)];
+                    timer.deadline = nvim::io_time_after(delays(random));
+                    timer.context = &timer;
+                    timer.function = [](void *context) {
+                        static_cast<load_timer*>(context)->fired = nvim::io_time_after(0);
+                    };
+
+                    state.loop.add_timeout(&timer, timer.deadline);
+                }
+            }
+        });
+    }
+
+    for (std::thread &thread : submitters) {
+        thread.join();
+    }
+
+    writer.join();
+
+    // EOF cancels the loop once every byte is read.
+    while (!state.cancels) {
+        if (!state.wait() && !state.cancels) {
+            CHECK(!"timed out");
+            break;
+        }
+    }
+
+    // Timeouts are at most 20ms away, wait for the last of them on the loop.
+    for (int attempts=0; attempts<100; ++attempts) {
+        state.loop.sync(nullptr, [](void*) {});
+        bool done = true;
+
+        for (load_timer &timer : timers) {
+            if (!timer.fired) done = false;
+        }
+
+        if (done) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    CHECK_EQ(ran.load(), threads * tasks);
+    CHECK(state.received == data);
+
+    for (load_timer &timer : timers) {
+        CHECK_NE(timer.fired, 0);
+        CHECK_GE(timer.fired, timer.deadline);
+    }
+}
+
+TEST(IoLoop, Load) {
+    run_under_load(8 << 20, 4, 20000, 500);
+}
+
+BENCHMARK(IoLoop, ReadThroughput) {
+    check::measure([] {
+        run_under_load(64 << 20, 1, 100, 1);
+    });
+}
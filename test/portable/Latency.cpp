@@ -0,0 +1,126 @@
+//
+//  Neovim Mac Test
+//  Latency.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <random>
+#include <vector>
+#include "latency.hpp"
+#include "check.hpp"
+
+// The echoed input test is in Latency.mm, it drives a ui_controller, which
+// depends on dispatch.
+
+TEST(Latency, EmptyHistogram) {
+    nvim::latency_histogram histogram;
+    CHECK_EQ(histogram.count(), 0);
+    CHECK_EQ(histogram.min(), 0);
+    CHECK_EQ(histogram.max(), 0);
+    CHECK_EQ(histogram.mean(), 0);
+    CHECK_EQ(histogram.percentile(50), 0);
+}
+
+TEST(Latency, SmallValuesAreExact) {
+    nvim::latency_histogram histogram;
+
+    for (uint64_t i=1; i<=20; ++i) {
+        histogram.record(i);
+    }
+
+    CHECK_EQ(histogram.count(), 20);
+    CHECK_EQ(histogram.min(), 1);
+    CHECK_EQ(histogram.max(), 20);
+    CHECK_EQ(histogram.mean(), 10);
+    CHECK_EQ(histogram.percentile(0), 1);
+    CHECK_EQ(histogram.percentile(50), 10);
+    CHECK_EQ(histogram.percentile(95), 19);
+    CHECK_EQ(histogram.percentile(100), 20);
+}
+
+TEST(Latency, PercentilePrecision) {
+    nvim::latency_histogram histogram;
+    std::vector<uint64_t> values;
+    std::mt19937_64 rng(7);
+    std::lognormal_distribution<double> distribution(15, 1.5);
+
+    for (int i=0; i<100000; ++i) {
+        uint64_t value = distribution(rng);
+        values.push_back(value);
+        histogram.record(value);
+    }
+
+    std::sort(values.begin(), values.end());
+
+    for (double percentile : {50.0, 90.0, 99.0, 99.9}) {
+        size_t index = std::ceil(percentile / 100.0 * values.size()) - 1;
+        double exact = values[index];
+        double estimate = histogram.percentile(percentile);
+
+        // Estimates are upper bounds within the bucket precision.
+        CHECK_GE(estimate, exact);
+        CHECK_LE(estimate, exact * (1 + 1.0 / 32));
+    }
+
+    CHECK_EQ(histogram.max(), values.back());
+    CHECK_EQ(histogram.percentile(100), values.back());
+}
+
+TEST(Latency, LargeValues) {
+    nvim::latency_histogram histogram;
+    histogram.record(UINT64_MAX);
+    histogram.record(uint64_t(1) << 63);
+
+    CHECK_EQ(histogram.percentile(100), UINT64_MAX);
+    CHECK_GE(histogram.percentile(50), uint64_t(1) << 63);
+    CHECK_LT(histogram.percentile(50), UINT64_MAX);
+}
+
+TEST(Latency, TrackerCorrelation) {
+    nvim::latency_tracker tracker;
+
+    // Inputs before a flush are measured from the earliest input.
+    tracker.input(1000);
+    tracker.input(2000);
+    tracker.flush(1, 5000);
+    tracker.present(1, 9000);
+
+    CHECK_EQ(tracker.flush_latency().count(), 1);
+    CHECK_EQ(tracker.flush_latency().max(), 4000);
+    CHECK_EQ(tracker.present_latency().count(), 1);
+    CHECK_EQ(tracker.present_latency().max(), 8000);
+
+    // Flushes and presents without input aren't measured.
+    tracker.flush(2, 10000);
+    tracker.present(2, 11000);
+    CHECK_EQ(tracker.flush_latency().count(), 1);
+    CHECK_EQ(tracker.present_latency().count(), 1);
+
+    // Frames presenting older grids don't complete a measurement.
+    tracker.input(20000);
+    tracker.flush(3, 21000);
+    tracker.present(2, 22000);
+    CHECK_EQ(tracker.present_latency().count(), 1);
+    tracker.present(3, 23000);
+    CHECK_EQ(tracker.present_latency().count(), 2);
+    CHECK_EQ(tracker.present_latency().max(), 8000);
+    CHECK_EQ(tracker.present_latency().min(), 3000);
+
+    tracker.reset();
+    CHECK_EQ(tracker.flush_latency().count(), 0);
+    CHECK_EQ(tracker.present_latency().count(), 0);
+}
+
+BENCHMARK(Latency, RecordPerformance) {
+    nvim::latency_histogram histogram;
+
+    check::measure([&] {
+        for (uint64_t i=0; i<1000000; ++i) {
+            histogram.record(i * 7919);
+        }
+    });
+}
+
@@ -1,6 +1,6 @@
 //
 //  Neovim Mac Test
-//  Msgpack.mm
+//  Msgpack.cpp
 //
 //  Copyright © 2020 Jay Sandhu. All rights reserved.
 //  This file is distributed under the MIT License.
@@ -8,9 +8,8 @@
 //
 
 #include <array>
-#include <XCTest/XCTest.h>
-#include "AsanAssert.h"
 #include "msgpack.hpp"
+#include "check.hpp"
 
 template<size_t N>
 static constexpr std::string_view packed_data(const char (&string)[N]) {
@@ -25,66 +24,56 @@ static inline bool all_a(const char *begin, const char *end) {
     return true;
 }
 
-@interface testMsgpack : XCTestCase
-@end
+TEST(Msgpack, IntegerRoundTrip) {
+    CHECK_EQ(UINT8_MAX, msg::integer(UINT8_MAX));
+    CHECK_EQ(UINT8_MAX, msg::integer(UINT8_MAX).as<uint8_t>());
 
-@implementation testMsgpack : XCTestCase
+    CHECK_EQ(UINT16_MAX, msg::integer(UINT16_MAX));
+    CHECK_EQ(UINT16_MAX, msg::integer(UINT16_MAX).as<uint16_t>());
 
- - (void)setUp {
-    [super setUp];
-    [self setContinueAfterFailure:NO];
-}
-
-- (void)testIntegerRoundTrip {
-    XCTAssertEqual(UINT8_MAX,  msg::integer(UINT8_MAX));
-    XCTAssertEqual(UINT8_MAX,  msg::integer(UINT8_MAX).as<uint8_t>());
-
-    XCTAssertEqual(UINT16_MAX, msg::integer(UINT16_MAX));
-    XCTAssertEqual(UINT16_MAX, msg::integer(UINT16_MAX).as<uint16_t>());
-
-    XCTAssertEqual(UINT32_MAX, msg::integer(UINT32_MAX));
-    XCTAssertEqual(UINT32_MAX, msg::integer(UINT32_MAX).as<uint32_t>());
+    CHECK_EQ(UINT32_MAX, msg::integer(UINT32_MAX));
+    CHECK_EQ(UINT32_MAX, msg::integer(UINT32_MAX).as<uint32_t>());
 
-    XCTAssertEqual(UINT64_MAX, msg::integer(UINT64_MAX));
-    XCTAssertEqual(UINT64_MAX, msg::integer(UINT64_MAX).as<uint64_t>());
+    CHECK_EQ(UINT64_MAX, msg::integer(UINT64_MAX));
+    CHECK_EQ(UINT64_MAX, msg::integer(UINT64_MAX).as<uint64_t>());
 
-    XCTAssertEqual(INT8_MAX,  msg::integer(INT8_MAX));
-    XCTAssertEqual(INT8_MAX,  msg::integer(INT8_MAX).as<int8_t>());
-    XCTAssertEqual(INT8_MIN,  msg::integer(INT8_MIN));
-    XCTAssertEqual(INT8_MIN,  msg::integer(INT8_MIN).as<int8_t>());
+    CHECK_EQ(INT8_MAX, msg::integer(INT8_MAX));
+    CHECK_EQ(INT8_MAX, msg::integer(INT8_MAX).as<int8_t>());
+    CHECK_EQ(INT8_MIN, msg::integer(INT8_MIN));
+    CHECK_EQ(INT8_MIN, msg::integer(INT8_MIN).as<int8_t>());
 
-    XCTAssertEqual(INT16_MAX, msg::integer(INT16_MAX));
-    XCTAssertEqual(INT16_MAX, msg::integer(INT16_MAX).as<int16_t>());
-    XCTAssertEqual(INT16_MIN, msg::integer(INT16_MIN));
-    XCTAssertEqual(INT16_MIN, msg::integer(INT16_MIN).as<int16_t>());
+    CHECK_EQ(INT16_MAX, msg::integer(INT16_MAX));
+    CHECK_EQ(INT16_MAX, msg::integer(INT16_MAX).as<int16_t>());
+    CHECK_EQ(INT16_MIN, msg::integer(INT16_MIN));
+    CHECK_EQ(INT16_MIN, msg::integer(INT16_MIN).as<int16_t>());
 
-    XCTAssertEqual(INT32_MAX, msg::integer(INT32_MAX));
-    XCTAssertEqual(INT32_MAX, msg::integer(INT32_MAX).as<int32_t>());
-    XCTAssertEqual(INT32_MIN, msg::integer(INT32_MIN));
-    XCTAssertEqual(INT32_MIN, msg::integer(INT32_MIN).as<int32_t>());
+    CHECK_EQ(INT32_MAX, msg::integer(INT32_MAX));
+    CHECK_EQ(INT32_MAX, msg::integer(INT32_MAX).as<int32_t>());
+    CHECK_EQ(INT32_MIN, msg::integer(INT32_MIN));
+    CHECK_EQ(INT32_MIN, msg::integer(INT32_MIN).as<int32_t>());
 
-    XCTAssertEqual(INT64_MAX, msg::integer(INT64_MAX));
-    XCTAssertEqual(INT64_MAX, msg::integer(INT64_MAX).as<int64_t>());
-    XCTAssertEqual(INT64_MIN, msg::integer(INT64_MIN));
-    XCTAssertEqual(INT64_MIN, msg::integer(INT64_MIN).as<int64_t>());
+    CHECK_EQ(INT64_MAX, msg::integer(INT64_MAX));
+    CHECK_EQ(INT64_MAX, msg::integer(INT64_MAX).as<int64_t>());
+    CHECK_EQ(INT64_MIN, msg::integer(INT64_MIN));
+    CHECK_EQ(INT64_MIN, msg::integer(INT64_MIN).as<int64_t>());
 }
 
-- (void)testArrayViewDefaultConstructor {
+TEST(Msgpack, ArrayViewDefaultConstructor) {
     msg::array_view<int> view;
-    XCTAssertEqual(view.data(), nullptr);
-    XCTAssertEqual(view.size(), 0);
-    XCTAssertEqual(view.begin(), view.end());
+    CHECK_EQ(view.data(), nullptr);
+    CHECK_EQ(view.size(), 0);
+    CHECK_EQ(view.begin(), view.end());
 }
 
-- (void)testArrayViewConstructor {
+TEST(Msgpack, ArrayViewConstructor) {
     int array[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
     msg::array_view<int> view(array, 10);
-    XCTAssertEqual(view.data(), +array);
-    XCTAssertEqual(view.size(), 10);
-    XCTAssertEqual(std::distance(view.begin(), view.end()), 10);
+    CHECK_EQ(view.data(), +array);
+    CHECK_EQ(view.size(), 10);
+    CHECK_EQ(std::distance(view.begin(), view.end()), 10);
 }
 
-- (void)testArrayViewEquality {
+TEST(Msgpack, ArrayViewEquality) {
     int array1[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
     int array2[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
     int array3[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 0};
@@ -95,13 +84,13 @@ static inline bool all_a(const char *begin, const char *end) {
     msg::array_view<int> view3(array3, 10);
     msg::array_view<int> subview1(array1, 5);
     
-    XCTAssertTrue(view1 == view2);
-    XCTAssertFalse(view1 == empty);
-    XCTAssertFalse(view1 == subview1);
-    XCTAssertFalse(view1 == view3);
+    CHECK(view1 == view2);
+    CHECK(!(view1 == empty));
+    CHECK(!(view1 == subview1));
+    CHECK(!(view1 == view3));
 }
 
-- (void)testArrayViewComparisons {
+TEST(Msgpack, ArrayViewComparisons) {
     int array1[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
     int array2[10] = {1, 2, 3, 0, 0, 0, 0, 0, 0, 0};
     
@@ -110,20 +99,20 @@ static inline bool all_a(const char *begin, const char *end) {
     msg::array_view<int> view2(array2, 10);
     msg::array_view<int> subview1(array1, 5);
     
-    XCTAssertTrue(empty < view1);
-    XCTAssertTrue(subview1 < view1);
-    XCTAssertTrue(view2 < view1);
-    XCTAssertTrue(view2 < subview1);
+    CHECK(empty < view1);
+    CHECK(subview1 < view1);
+    CHECK(view2 < view1);
+    CHECK(view2 < subview1);
 }
 
-- (void)testMapViewDefaultConstructor {
+TEST(Msgpack, MapViewDefaultConstructor) {
     msg::map_view<msg::string, int> view;
-    XCTAssertEqual(view.data(), nullptr);
-    XCTAssertEqual(view.size(), 0);
-    XCTAssertEqual(view.begin(), view.end());
+    CHECK_EQ(view.data(), nullptr);
+    CHECK_EQ(view.size(), 0);
+    CHECK_EQ(view.begin(), view.end());
 }
 
-- (void)testMapViewConstructor {
+TEST(Msgpack, MapViewConstructor) {
     using map_view = msg::map_view<msg::string, int>;
     
     map_view::value_type pairs[5] = {
@@ -132,12 +121,12 @@ static inline bool all_a(const char *begin, const char *end) {
     
     map_view view(pairs, 5);
     
-    XCTAssertEqual(view.data(), +pairs);
-    XCTAssertEqual(view.size(), 5);
-    XCTAssertEqual(std::distance(view.begin(), view.end()), 5);
+    CHECK_EQ(view.data(), +pairs);
+    CHECK_EQ(view.size(), 5);
+    CHECK_EQ(std::distance(view.begin(), view.end()), 5);
 }
 
-- (void)testMapViewEquality {
+TEST(Msgpack, MapViewEquality) {
     using map_view = msg::map_view<msg::string, int>;
     
     map_view::value_type pairs1[5] = {
@@ -158,14 +147,14 @@ static inline bool all_a(const char *begin, const char *end) {
     map_view view3(pairs3, 5);
     map_view subview1(pairs1, 3);
     
-    XCTAssertTrue(empty == empty);
-    XCTAssertTrue(view1 == view2);
-    XCTAssertFalse(view1 == view3);
-    XCTAssertFalse(view1 == empty);
-    XCTAssertFalse(view1 == subview1);
+    CHECK(empty == empty);
+    CHECK(view1 == view2);
+    CHECK(!(view1 == view3));
+    CHECK(!(view1 == empty));
+    CHECK(!(view1 == subview1));
 }
 
-- (void)testMapViewComparisons {
+TEST(Msgpack, MapViewComparisons) {
     using map_view = msg::map_view<msg::string, int>;
     
     map_view::value_type pairs1[5] = {
@@ -181,14 +170,14 @@ static inline bool all_a(const char *begin, const char *end) {
     map_view view2(pairs2, 5);
     map_view subview1(pairs1, 3);
     
-    XCTAssertTrue(empty < view1);
-    XCTAssertTrue(subview1 < view1);
-    XCTAssertTrue(view1 < view2);
-    XCTAssertFalse(empty < empty);
-    XCTAssertFalse(view1 < view1);
+    CHECK(empty < view1);
+    CHECK(subview1 < view1);
+    CHECK(view1 < view2);
+    CHECK(!(empty < empty));
+    CHECK(!(view1 < view1));
 }
 
-- (void)testMapViewGet {
+TEST(Msgpack, MapViewGet) {
     using map_view = msg::map_view<msg::string, int>;
     using pair = std::pair<msg::string, int>;
     
@@ -198,20 +187,20 @@ static inline bool all_a(const char *begin, const char *end) {
     
     map_view view(pairs, 5);
     
-    XCTAssertFalse(view.get("invalid"));
-    XCTAssertEqual(1, *view.get("one"));
-    XCTAssertEqual(2, *view.get("two"));
-    XCTAssertEqual(3, *view.get("three"));
-    XCTAssertEqual(4, *view.get("four"));
-    XCTAssertEqual(5, *view.get("five"));
+    CHECK(!view.get("invalid"));
+    CHECK_EQ(1, *view.get("one"));
+    CHECK_EQ(2, *view.get("two"));
+    CHECK_EQ(3, *view.get("three"));
+    CHECK_EQ(4, *view.get("four"));
+    CHECK_EQ(5, *view.get("five"));
 }
 
-- (void)testObjectDefaultConstructor {
+TEST(Msgpack, ObjectDefaultConstructor) {
     msg::object object;
-    XCTAssertTrue(object.is<msg::invalid>());
+    CHECK(object.is<msg::invalid>());
 }
 
-- (void)testObjectEquality {
+TEST(Msgpack, ObjectEquality) {
     msg::object uniques[] = {
         msg::make_object<msg::boolean>(true),
         msg::make_object<msg::boolean>(false),
@@ -230,12 +219,12 @@ static inline bool all_a(const char *begin, const char *end) {
     std::copy(begin, end, copies);
     
     for (int i=0; i<size; ++i) {
-        XCTAssertTrue(std::count(begin, end, uniques[i]) == 1);
-        XCTAssertTrue(uniques[i] == copies[i]);
+        CHECK(std::count(begin, end, uniques[i]) == 1);
+        CHECK(uniques[i] == copies[i]);
     }
 }
 
-- (void)testObjectComparisons {
+TEST(Msgpack, ObjectComparisons) {
     msg::object sorted[] = {
         msg::make_object<msg::integer>(1),
         msg::make_object<msg::integer>(1),
@@ -254,16 +243,16 @@ static inline bool all_a(const char *begin, const char *end) {
     
     auto begin = std::begin(sorted);
     auto end = std::end(sorted);
-    XCTAssertTrue(std::is_sorted(begin, end));
+    CHECK(std::is_sorted(begin, end));
     
     std::sort(std::begin(unsorted), std::end(unsorted));
-    XCTAssertTrue(std::equal(std::begin(unsorted), std::end(unsorted), sorted));
+    CHECK(std::equal(std::begin(unsorted), std::end(unsorted), sorted));
     
     sorted[3] = msg::make_object<msg::integer>(0);
-    XCTAssertFalse(std::is_sorted(begin, end));
+    CHECK(!std::is_sorted(begin, end));
 }
 
-- (void)testUnpackerMoveConstructor {
+TEST(Msgpack, UnpackerMoveConstructor) {
     std::string_view string_test("\xa4test");
     
     msg::unpacker moved_from;
@@ -272,13 +261,13 @@ static inline bool all_a(const char *begin, const char *end) {
 
     {
         msg::unpacker moved_to(std::move(moved_from));
-        AssertAddressValid(str.data());
+        CHECK_ADDRESS_VALID(str.data());
     }
 
-    AssertAddressPoisoned(&str);
+    CHECK_ADDRESS_POISONED(&str);
 }
 
-- (void)testUnpackerMoveAssignment {
+TEST(Msgpack, UnpackerMoveAssignment) {
     std::string_view string_test("\xa4test");
     
     msg::unpacker moved_from;
@@ -288,13 +277,13 @@ static inline bool all_a(const char *begin, const char *end) {
     {
         msg::unpacker moved_to;
         moved_to = std::move(moved_from);
-        AssertAddressValid(str.data());
+        CHECK_ADDRESS_VALID(str.data());
     }
 
-    AssertAddressPoisoned(&str);
+    CHECK_ADDRESS_POISONED(&str);
 }
 
-- (void)testUnpackerMoveAssignmentDestroysObjects {
+TEST(Msgpack, UnpackerMoveAssignmentDestroysObjects) {
     std::string_view string_test("\xa4test");
     
     msg::unpacker moved_to;
@@ -302,10 +291,10 @@ static inline bool all_a(const char *begin, const char *end) {
     msg::string &str = moved_to.unpack()->get<msg::string>();
 
     moved_to = msg::unpacker();
-    AssertAddressPoisoned(&str);
+    CHECK_ADDRESS_POISONED(&str);
 }
 
-- (void)testUnpackInvalid {
+TEST(Msgpack, UnpackInvalid) {
     auto packed = packed_data("\xc1");
     auto value = msg::make_object<msg::invalid>();
 
@@ -313,12 +302,12 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackNull {
+TEST(Msgpack, UnpackNull) {
     auto packed = packed_data("\xc0");
     auto value = msg::make_object<msg::null>();
 
@@ -326,12 +315,12 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackBooleanTrue {
+TEST(Msgpack, UnpackBooleanTrue) {
     auto packed = packed_data("\xc3");
     auto value = msg::make_object<msg::boolean>(true);
 
@@ -339,12 +328,12 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackBooleanFalse {
+TEST(Msgpack, UnpackBooleanFalse) {
     auto packed = packed_data("\xc2");
     auto value = msg::make_object<msg::boolean>(false);
 
@@ -352,12 +341,12 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackUnsignedIntegerFixedMin {
+TEST(Msgpack, UnpackUnsignedIntegerFixedMin) {
     auto packed = packed_data("\x00");
     auto value = msg::make_object<msg::integer>(0);
 
@@ -365,12 +354,12 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackUnsignedIntegerFixedMax {
+TEST(Msgpack, UnpackUnsignedIntegerFixedMax) {
     auto packed = packed_data("\x7f");
     auto value = msg::make_object<msg::integer>(127);
 
@@ -378,12 +367,12 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackUnsignedInteger8bit {
+TEST(Msgpack, UnpackUnsignedInteger8bit) {
     auto packed = packed_data("\xcc\x80");
     auto value = msg::make_object<msg::integer>(128);
 
@@ -391,23 +380,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackUnsignedInteger16bit {
+TEST(Msgpack, UnpackUnsignedInteger16bit) {
     auto packed = packed_data("\xcd\x01\x00");
     auto value = msg::make_object<msg::integer>(256);
 
@@ -415,23 +404,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackUnsignedInteger32bit {
+TEST(Msgpack, UnpackUnsignedInteger32bit) {
     auto packed = packed_data("\xce\x00\x01\x00\x00");
     auto value = msg::make_object<msg::integer>(65536);
 
@@ -439,23 +428,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackUnsignedInteger64bit {
+TEST(Msgpack, UnpackUnsignedInteger64bit) {
     auto packed = packed_data("\xcf\x00\x00\x00\x01\x00\x00\x00\x00");
     auto value = msg::make_object<msg::integer>(4294967296);
 
@@ -463,23 +452,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackNegativeIntegerFixedMin {
+TEST(Msgpack, UnpackNegativeIntegerFixedMin) {
     auto packed = packed_data("\xff");
     auto value = msg::make_object<msg::integer>(-1);
 
@@ -487,12 +476,12 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackNegativeIntegerFixedMax {
+TEST(Msgpack, UnpackNegativeIntegerFixedMax) {
     auto packed = packed_data("\xe0");
     auto value = msg::make_object<msg::integer>(-32);
 
@@ -500,12 +489,12 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackNegativeInteger8bit {
+TEST(Msgpack, UnpackNegativeInteger8bit) {
     auto packed = packed_data("\xd0\x80");
     auto value = msg::make_object<msg::integer>(-128);
 
@@ -513,23 +502,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackNegativeInteger16bit {
+TEST(Msgpack, UnpackNegativeInteger16bit) {
     auto packed = packed_data("\xd1\x80\x00");
     auto value = msg::make_object<msg::integer>(-32768);
 
@@ -537,23 +526,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackNegativeInteger32bit {
+TEST(Msgpack, UnpackNegativeInteger32bit) {
     auto packed = packed_data("\xd2\x80\x00\x00\x00");
     auto value = msg::make_object<msg::integer>(-2147483648);
 
@@ -561,23 +550,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackNegativeInteger64bit {
+TEST(Msgpack, UnpackNegativeInteger64bit) {
     auto packed = packed_data("\xd3\xff\xff\xff\xff\x00\x00\x00\x00");
     auto value = msg::make_object<msg::integer>(-4294967296);
 
@@ -585,23 +574,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackFloatZero {
+TEST(Msgpack, UnpackFloatZero) {
     auto packed = packed_data("\xcb\x00\x00\x00\x00\x00\x00\x00\x00");
     auto value = msg::make_object<msg::float64>(0.0);
 
@@ -609,23 +598,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackFloatMin {
+TEST(Msgpack, UnpackFloatMin) {
     auto packed = packed_data("\xcb\xff\xef\xff\xff\xff\xff\xff\xff");
     auto value = msg::make_object<msg::float64>(-1.7976931348623157e+308);
 
@@ -633,23 +622,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackFloatMax {
+TEST(Msgpack, UnpackFloatMax) {
     auto packed = packed_data("\xcb\x7f\xef\xff\xff\xff\xff\xff\xff");
     auto value = msg::make_object<msg::float64>(1.7976931348623157e+308);
 
@@ -657,23 +646,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackFloatSmallest {
+TEST(Msgpack, UnpackFloatSmallest) {
     auto packed = packed_data("\xcb\x00\x10\x00\x00\x00\x00\x00\x00");
     auto value = msg::make_object<msg::float64>(2.2250738585072014e-308);
 
@@ -681,23 +670,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackStringEmpty {
+TEST(Msgpack, UnpackStringEmpty) {
     auto packed = packed_data("\xa0");
     auto value = msg::make_object<msg::string>();
 
@@ -705,12 +694,12 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackStringFixedMin {
+TEST(Msgpack, UnpackStringFixedMin) {
     auto packed = packed_data("\xa1\x61");
     auto value = msg::make_object<msg::string>("a");
 
@@ -718,23 +707,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackStringFixedMax {
+TEST(Msgpack, UnpackStringFixedMax) {
     std::string string(31, 'a');
     auto packed = packed_data("\xbf\x61\x61\x61\x61\x61\x61\x61\x61\x61"
                               "\x61\x61\x61\x61\x61\x61\x61\x61\x61\x61"
@@ -746,23 +735,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackString8bitLength {
+TEST(Msgpack, UnpackString8bitLength) {
     auto packed = packed_data("\xd9\x04\x74\x65\x73\x74");
     auto value = msg::make_object<msg::string>("test");
 
@@ -770,23 +759,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackString16bitLength {
+TEST(Msgpack, UnpackString16bitLength) {
     auto packed = packed_data("\xda\x00\x04\x74\x65\x73\x74");
     auto value = msg::make_object<msg::string>("test");
 
@@ -794,23 +783,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackString32bitLength {
+TEST(Msgpack, UnpackString32bitLength) {
     auto packed = packed_data("\xdb\x00\x00\x00\x04\x74\x65\x73\x74");
     auto value = msg::make_object<msg::string>("test");
 
@@ -818,23 +807,72 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
+}
+
+TEST(Msgpack, UnpackStringInPlace) {
+    auto packed = packed_data("\x92\xa4\x74\x65\x73\x74\xa4\x74\x65\x73\x74\xc0");
+
+    msg::unpacker unpacker;
+    unpacker.feed_in_place(packed.data(), packed.size());
+    msg::object *obj = unpacker.unpack();
+
+    CHECK(obj);
+    CHECK_EQ(unpacker.remaining(), 1);
+
+    msg::array array = obj->get<msg::array>();
+    CHECK_EQ(array[0].get<msg::string>().data(), packed.data() + 2);
+    CHECK_EQ(array[1].get<msg::string>().data(), packed.data() + 7);
+
+    CHECK(unpacker.unpack());
+    CHECK_EQ(unpacker.remaining(), 0);
+    CHECK(!unpacker.unpack());
+}
+
+TEST(Msgpack, UnpackStringInPlaceSpanningInputs) {
+    auto packed = packed_data("\x92\xa4\x74\x65\x73\x74\xa4\x74\x65\x73\x74");
+
+    // Strings split across input buffers are copied, whole strings are not.
+    msg::unpacker unpacker;
+    unpacker.feed_in_place(packed.data(), 9);
+    CHECK(!unpacker.unpack());
+    unpacker.feed_in_place(packed.data() + 9, packed.size() - 9);
+    msg::object *obj = unpacker.unpack();
+
+    CHECK(obj);
+    msg::array array = obj->get<msg::array>();
+    CHECK_EQ(array[0].get<msg::string>().data(), packed.data() + 2);
+    CHECK(array[1].get<msg::string>() == "test");
+    CHECK_NE(array[1].get<msg::string>().data(), packed.data() + 7);
+    CHECK(!unpacker.unpack());
+}
+
+TEST(Msgpack, UnpackStringCopiedByDefault) {
+    auto packed = packed_data("\xa4\x74\x65\x73\x74");
+
+    msg::unpacker unpacker;
+    unpacker.feed(packed.data(), packed.size());
+    msg::object *obj = unpacker.unpack();
+
+    CHECK(obj);
+    CHECK(obj->get<msg::string>() == "test");
+    CHECK_NE(obj->get<msg::string>().data(), packed.data() + 1);
 }
 
-- (void)testUnpackArrayEmpty {
+TEST(Msgpack, UnpackArrayEmpty) {
     auto packed = packed_data("\x90");
     auto value = msg::make_object<msg::array>();
 
@@ -842,12 +880,12 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackArrayFixedMin {
+TEST(Msgpack, UnpackArrayFixedMin) {
     std::array<msg::object, 1> array = {
         msg::integer(0)
     };
@@ -859,23 +897,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackArrayFixedMax {
+TEST(Msgpack, UnpackArrayFixedMax) {
     std::array<msg::object, 15> array = {
         msg::integer(0),
         msg::integer(1),
@@ -902,23 +940,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackArray16bitLength {
+TEST(Msgpack, UnpackArray16bitLength) {
     std::array<msg::object, 4> array = {
         msg::integer(0),
         msg::integer(1),
@@ -933,23 +971,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackArray32bitLength {
+TEST(Msgpack, UnpackArray32bitLength) {
     std::array<msg::object, 4> array = {
         msg::integer(0),
         msg::integer(1),
@@ -964,23 +1002,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackArrayRecursive {
+TEST(Msgpack, UnpackArrayRecursive) {
     std::array<msg::object, 1> rec1{{
         msg::make_object<msg::array>()
     }};
@@ -1004,23 +1042,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackArrayHeterogeneous {
+TEST(Msgpack, UnpackArrayHeterogeneous) {
     std::array<msg::object, 3> array{{
         msg::make_object<msg::integer>(123),
         msg::make_object<msg::string>("test"),
@@ -1034,23 +1072,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackMapEmpty {
+TEST(Msgpack, UnpackMapEmpty) {
     auto packed = packed_data("\x80");
     auto value = msg::make_object<msg::map>();
 
@@ -1058,12 +1096,12 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackMapFixedMin {
+TEST(Msgpack, UnpackMapFixedMin) {
     std::array<msg::pair, 1> map = {{
         {msg::string("0"), msg::integer(0)}
     }};
@@ -1075,23 +1113,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackMapFixedMax {
+TEST(Msgpack, UnpackMapFixedMax) {
     std::array<msg::pair, 15> map = {{
         {msg::string("0"), msg::integer(0)},
         {msg::string("1"), msg::integer(1)},
@@ -1122,23 +1160,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackMap16bitLength {
+TEST(Msgpack, UnpackMap16bitLength) {
     std::array<msg::pair, 3> map = {{
         {msg::string("0"), msg::integer(0)},
         {msg::string("1"), msg::integer(1)},
@@ -1153,23 +1191,23 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testUnpackMap32bitLength {
+TEST(Msgpack, UnpackMap32bitLength) {
     std::array<msg::pair, 3> map = {{
         {msg::string("0"), msg::integer(0)},
         {msg::string("1"), msg::integer(1)},
@@ -1184,528 +1222,528 @@ static inline bool all_a(const char *begin, const char *end) {
     unpacker.feed(packed.data(), packed.size());
     msg::object *obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 
     for (const char &byte : packed) {
-        XCTAssertFalse(unpacker.unpack());
+        CHECK(!unpacker.unpack());
         unpacker.feed(&byte, 1);
     }
 
     obj = unpacker.unpack();
 
-    XCTAssertTrue(obj);
-    XCTAssertTrue(*obj == value);
-    XCTAssertFalse(unpacker.unpack());
+    CHECK(obj);
+    CHECK(*obj == value);
+    CHECK(!unpacker.unpack());
 }
 
-- (void)testOneShotUnpackUnsignedIntegerFixedMin {
+TEST(Msgpack, OneShotUnpackUnsignedIntegerFixedMin) {
     auto value = msg::integer(0);
     auto packed = packed_data("\x00");
     auto unpacked = msg::unpack_integer(packed.data(), packed.size());
 
-    XCTAssertTrue(unpacked);
-    XCTAssertTrue(*unpacked == value);
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() - 1));
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() + 1));
+    CHECK(unpacked);
+    CHECK(*unpacked == value);
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() - 1));
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() + 1));
 }
 
-- (void)testOneShotUnpackUnsignedIntegerFixedMax {
+TEST(Msgpack, OneShotUnpackUnsignedIntegerFixedMax) {
     auto value = msg::integer(127);
     auto packed = packed_data("\x7f");
     auto unpacked = msg::unpack_integer(packed.data(), packed.size());
 
-    XCTAssertTrue(unpacked);
-    XCTAssertTrue(*unpacked == value);
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() - 1));
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() + 1));
+    CHECK(unpacked);
+    CHECK(*unpacked == value);
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() - 1));
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() + 1));
 }
 
-- (void)testOneShotUnpackUnsignedInteger8bit {
+TEST(Msgpack, OneShotUnpackUnsignedInteger8bit) {
     auto value = msg::integer(128);
     auto packed = packed_data("\xcc\x80");
     auto unpacked = msg::unpack_integer(packed.data(), packed.size());
 
-    XCTAssertTrue(unpacked);
-    XCTAssertTrue(*unpacked == value);
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() - 1));
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() + 1));
+    CHECK(unpacked);
+    CHECK(*unpacked == value);
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() - 1));
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() + 1));
 }
 
-- (void)testOneShotUnpackUnsignedInteger16bit {
+TEST(Msgpack, OneShotUnpackUnsignedInteger16bit) {
     auto value = msg::integer(256);
     auto packed = packed_data("\xcd\x01\x00");
     auto unpacked = msg::unpack_integer(packed.data(), packed.size());
 
-    XCTAssertTrue(unpacked);
-    XCTAssertTrue(*unpacked == value);
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() - 1));
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() + 1));
+    CHECK(unpacked);
+    CHECK(*unpacked == value);
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() - 1));
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() + 1));
 }
 
-- (void)testOneShotUnpackUnsignedInteger32bit {
+TEST(Msgpack, OneShotUnpackUnsignedInteger32bit) {
     auto value = msg::integer(65536);
     auto packed = packed_data("\xce\x00\x01\x00\x00");
     auto unpacked = msg::unpack_integer(packed.data(), packed.size());
 
-    XCTAssertTrue(unpacked);
-    XCTAssertTrue(*unpacked == value);
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() - 1));
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() + 1));
+    CHECK(unpacked);
+    CHECK(*unpacked == value);
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() - 1));
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() + 1));
 }
 
-- (void)testOneShotUnpackUnsignedInteger64bit {
+TEST(Msgpack, OneShotUnpackUnsignedInteger64bit) {
     auto value = msg::integer(4294967296);
     auto packed = packed_data("\xcf\x00\x00\x00\x01\x00\x00\x00\x00");
     auto unpacked = msg::unpack_integer(packed.data(), packed.size());
 
-    XCTAssertTrue(unpacked);
-    XCTAssertTrue(*unpacked == value);
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() - 1));
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() + 1));
+    CHECK(unpacked);
+    CHECK(*unpacked == value);
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() - 1));
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() + 1));
 }
 
-- (void)testOneShotUnpackNegativeIntegerFixedMin {
+TEST(Msgpack, OneShotUnpackNegativeIntegerFixedMin) {
     auto value = msg::integer(-1);
     auto packed = packed_data("\xff");
     auto unpacked = msg::unpack_integer(packed.data(), packed.size());
 
-    XCTAssertTrue(unpacked);
-    XCTAssertTrue(*unpacked == value);
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() - 1));
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() + 1));
+    CHECK(unpacked);
+    CHECK(*unpacked == value);
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() - 1));
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() + 1));
 }
 
-- (void)testOneShotUnpackNegativeIntegerFixedMax {
+TEST(Msgpack, OneShotUnpackNegativeIntegerFixedMax) {
     auto value = msg::integer(-32);
     auto packed = packed_data("\xe0");
     auto unpacked = msg::unpack_integer(packed.data(), packed.size());
 
-    XCTAssertTrue(unpacked);
-    XCTAssertTrue(*unpacked == value);
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() - 1));
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() + 1));
+    CHECK(unpacked);
+    CHECK(*unpacked == value);
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() - 1));
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() + 1));
 }
 
-- (void)testOneShotUnpackNegativeInteger8bit {
+TEST(Msgpack, OneShotUnpackNegativeInteger8bit) {
     auto value = msg::integer(-128);
     auto packed = packed_data("\xd0\x80");
     auto unpacked = msg::unpack_integer(packed.data(), packed.size());
 
-    XCTAssertTrue(unpacked);
-    XCTAssertTrue(*unpacked == value);
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() - 1));
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() + 1));
+    CHECK(unpacked);
+    CHECK(*unpacked == value);
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() - 1));
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() + 1));
 }
 
-- (void)testOneShotUnpackNegativeInteger16bit {
+TEST(Msgpack, OneShotUnpackNegativeInteger16bit) {
     auto value = msg::integer(-32768);
     auto packed = packed_data("\xd1\x80\x00");
     auto unpacked = msg::unpack_integer(packed.data(), packed.size());
 
-    XCTAssertTrue(unpacked);
-    XCTAssertTrue(*unpacked == value);
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() - 1));
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() + 1));
+    CHECK(unpacked);
+    CHECK(*unpacked == value);
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() - 1));
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() + 1));
 }
 
-- (void)testOneShotUnpackNegativeInteger32bit {
+TEST(Msgpack, OneShotUnpackNegativeInteger32bit) {
     auto value = msg::integer(-2147483648);
     auto packed = packed_data("\xd2\x80\x00\x00\x00");
     auto unpacked = msg::unpack_integer(packed.data(), packed.size());
 
-    XCTAssertTrue(unpacked);
-    XCTAssertTrue(*unpacked == value);
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() - 1));
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() + 1));
+    CHECK(unpacked);
+    CHECK(*unpacked == value);
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() - 1));
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() + 1));
 }
 
-- (void)testOneShotUnpackNegativeInteger64bit {
+TEST(Msgpack, OneShotUnpackNegativeInteger64bit) {
     auto value = msg::integer(-4294967296);
     auto packed = packed_data("\xd3\xff\xff\xff\xff\x00\x00\x00\x00");
     auto unpacked = msg::unpack_integer(packed.data(), packed.size());
 
-    XCTAssertTrue(unpacked);
-    XCTAssertTrue(*unpacked == value);
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() - 1));
-    XCTAssertFalse(msg::unpack_integer(packed.data(), packed.size() + 1));
+    CHECK(unpacked);
+    CHECK(*unpacked == value);
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() - 1));
+    CHECK(!msg::unpack_integer(packed.data(), packed.size() + 1));
 }
 
-- (void)testPackNull {
+TEST(Msgpack, PackNull) {
     auto packed = packed_data("\xc0");
     msg::packer packer;
     packer.pack_null();
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackBooleanTrue {
+TEST(Msgpack, PackBooleanTrue) {
     auto packed = packed_data("\xc3");
     msg::packer packer;
     packer.pack_bool(true);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackBooleanFalse {
+TEST(Msgpack, PackBooleanFalse) {
     auto packed = packed_data("\xc2");
     msg::packer packer;
     packer.pack_bool(false);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackUnsignedIntegerZero {
+TEST(Msgpack, PackUnsignedIntegerZero) {
     auto packed = packed_data("\x00");
     msg::packer packer;
     packer.pack_uint64(0);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackUnsignedIntegerOne {
+TEST(Msgpack, PackUnsignedIntegerOne) {
     auto packed = packed_data("\x01");
     msg::packer packer;
     packer.pack_uint64(1);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackUnsignedIntegerFixedMax {
+TEST(Msgpack, PackUnsignedIntegerFixedMax) {
     auto packed = packed_data("\x7f");
     msg::packer packer;
     packer.pack_uint64(127);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackUnsignedInteger8bitMin {
+TEST(Msgpack, PackUnsignedInteger8bitMin) {
     auto packed = packed_data("\xcc\x80");
     msg::packer packer;
     packer.pack_uint64(128);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackUnsignedInteger8bitMax {
+TEST(Msgpack, PackUnsignedInteger8bitMax) {
     auto packed = packed_data("\xcc\xff");
     msg::packer packer;
     packer.pack_uint64(255);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackUnsignedInteger16bitMin {
+TEST(Msgpack, PackUnsignedInteger16bitMin) {
     auto packed = packed_data("\xcd\x01\x00");
     msg::packer packer;
     packer.pack_uint64(256);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackUnsignedInteger16bitMax {
+TEST(Msgpack, PackUnsignedInteger16bitMax) {
     auto packed = packed_data("\xcd\xff\xff");
     msg::packer packer;
     packer.pack_uint64(65535);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackUnsignedInteger32bitMin {
+TEST(Msgpack, PackUnsignedInteger32bitMin) {
     auto packed = packed_data("\xce\x00\x01\x00\x00");
     msg::packer packer;
     packer.pack_uint64(65536);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackUnsignedInteger32bitMax {
+TEST(Msgpack, PackUnsignedInteger32bitMax) {
     auto packed = packed_data("\xce\xff\xff\xff\xff");
     msg::packer packer;
     packer.pack_uint64(4294967295);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackUnsignedInteger64bitMin {
+TEST(Msgpack, PackUnsignedInteger64bitMin) {
     auto packed = packed_data("\xcf\x00\x00\x00\x01\x00\x00\x00\x00");
     msg::packer packer;
     packer.pack_uint64(4294967296);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackUnsignedInteger64bitMax {
+TEST(Msgpack, PackUnsignedInteger64bitMax) {
     auto packed = packed_data("\xcf\xff\xff\xff\xff\xff\xff\xff\xff");
     msg::packer packer;
     packer.pack_uint64(18446744073709551615u);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackSignedIntegerZero {
+TEST(Msgpack, PackSignedIntegerZero) {
     auto packed = packed_data("\x00");
     msg::packer packer;
     packer.pack_int64(0);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackSingedIntegerPositive {
+TEST(Msgpack, PackSingedIntegerPositive) {
     auto packed = packed_data("\x01");
     msg::packer packer;
     packer.pack_int64(1);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackNegativeIntegerFixedMax {
+TEST(Msgpack, PackNegativeIntegerFixedMax) {
     auto packed = packed_data("\xff");
     msg::packer packer;
     packer.pack_int64(-1);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackNegativeIntegerFixedMin {
+TEST(Msgpack, PackNegativeIntegerFixedMin) {
     auto packed = packed_data("\xe0");
     msg::packer packer;
     packer.pack_int64(-32);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackNegativeInteger8bitMax {
+TEST(Msgpack, PackNegativeInteger8bitMax) {
     auto packed = packed_data("\xd0\xdf");
     msg::packer packer;
     packer.pack_int64(-33);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackNegativeInteger8bitMin {
+TEST(Msgpack, PackNegativeInteger8bitMin) {
     auto packed = packed_data("\xd0\x80");
     msg::packer packer;
     packer.pack_int64(-128);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackNegativeInteger16bitMax {
+TEST(Msgpack, PackNegativeInteger16bitMax) {
     auto packed = packed_data("\xd1\xff\x7f");
     msg::packer packer;
     packer.pack_int64(-129);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackNegativeInteger16bitMin {
+TEST(Msgpack, PackNegativeInteger16bitMin) {
     auto packed = packed_data("\xd1\x80\x00");
     msg::packer packer;
     packer.pack_int64(-32768);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackNegativeInteger32bitMax {
+TEST(Msgpack, PackNegativeInteger32bitMax) {
     auto packed = packed_data("\xd2\xff\xff\x7f\xff");
     msg::packer packer;
     packer.pack_int64(-32769);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackNegativeInteger32bitMin {
+TEST(Msgpack, PackNegativeInteger32bitMin) {
     auto packed = packed_data("\xd2\x80\x00\x00\x00");
     msg::packer packer;
     packer.pack_int64(-2147483648);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackNegativeInteger64bitMax {
+TEST(Msgpack, PackNegativeInteger64bitMax) {
     auto packed = packed_data("\xd3\xff\xff\xff\xff\x7f\xff\xff\xff");
     msg::packer packer;
     packer.pack_int64(-2147483649);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackNegativeInteger64bitMin {
+TEST(Msgpack, PackNegativeInteger64bitMin) {
     auto packed = packed_data("\xd3\x80\x00\x00\x00\x00\x00\x00\x00");
     msg::packer packer;
     packer.pack_int64(-9223372036854775808u);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackFloatZero {
+TEST(Msgpack, PackFloatZero) {
     auto packed = packed_data("\xcb\x00\x00\x00\x00\x00\x00\x00\x00");
     msg::packer packer;
     packer.pack_float64(0.0);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackFloatMin {
+TEST(Msgpack, PackFloatMin) {
     auto packed = packed_data("\xcb\xff\xef\xff\xff\xff\xff\xff\xff");
     msg::packer packer;
     packer.pack_float64(-1.7976931348623157e+308);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackFloatMax {
+TEST(Msgpack, PackFloatMax) {
     auto packed = packed_data("\xcb\x7f\xef\xff\xff\xff\xff\xff\xff");
     msg::packer packer;
     packer.pack_float64(1.7976931348623157e+308);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackFloatSmallest {
+TEST(Msgpack, PackFloatSmallest) {
     auto packed = packed_data("\xcb\x00\x10\x00\x00\x00\x00\x00\x00");
     msg::packer packer;
     packer.pack_float64(2.2250738585072014e-308);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackStringLiteral {
+TEST(Msgpack, PackStringLiteral) {
     auto packed = packed_data("\xa4\x74\x65\x73\x74");
     msg::packer packer;
     packer.pack_string("test");
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackStringView {
+TEST(Msgpack, PackStringView) {
     auto packed = packed_data("\xa4\x74\x65\x73\x74");
     msg::packer packer;
     packer.pack_string(std::string_view("test"));
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackString {
+TEST(Msgpack, PackString) {
     auto packed = packed_data("\xa4\x74\x65\x73\x74");
     msg::packer packer;
     packer.pack_string(std::string("test"));
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackStringEmpty {
+TEST(Msgpack, PackStringEmpty) {
     auto packed = packed_data("\xa0");
     msg::packer packer;
     packer.pack_string(msg::string());
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackStringFixedMin {
+TEST(Msgpack, PackStringFixedMin) {
     auto packed = packed_data("\xa1");
     msg::packer packer;
     std::string string(1, 'a');
     packer.pack_string(string);
 
-    XCTAssertEqual(packer.size(), packed.size() + string.size());
-    XCTAssertEqual(msg::string(packer.data(), packed.size()), packed);
-    XCTAssertTrue(all_a(packer.begin() + packed.size(), packer.end()));
+    CHECK_EQ(packer.size(), packed.size() + string.size());
+    CHECK_EQ(msg::string(packer.data(), packed.size()), packed);
+    CHECK(all_a(packer.begin() + packed.size(), packer.end()));
 }
 
-- (void)testPackStringFixedMax {
+TEST(Msgpack, PackStringFixedMax) {
     auto packed = packed_data("\xbf");
     msg::packer packer;
     std::string string(31, 'a');
     packer.pack_string(string);
 
-    XCTAssertEqual(packer.size(), packed.size() + string.size());
-    XCTAssertEqual(msg::string(packer.data(), packed.size()), packed);
-    XCTAssertTrue(all_a(packer.begin() + packed.size(), packer.end()));
+    CHECK_EQ(packer.size(), packed.size() + string.size());
+    CHECK_EQ(msg::string(packer.data(), packed.size()), packed);
+    CHECK(all_a(packer.begin() + packed.size(), packer.end()));
 }
 
-- (void)testPackString8bitMin {
+TEST(Msgpack, PackString8bitMin) {
     auto packed = packed_data("\xd9\x20");
     msg::packer packer;
     std::string string(32, 'a');
     packer.pack_string(string);
 
-    XCTAssertEqual(packer.size(), packed.size() + string.size());
-    XCTAssertEqual(msg::string(packer.data(), packed.size()), packed);
-    XCTAssertTrue(all_a(packer.begin() + packed.size(), packer.end()));
+    CHECK_EQ(packer.size(), packed.size() + string.size());
+    CHECK_EQ(msg::string(packer.data(), packed.size()), packed);
+    CHECK(all_a(packer.begin() + packed.size(), packer.end()));
 }
 
-- (void)testPackString8bitMax {
+TEST(Msgpack, PackString8bitMax) {
     auto packed = packed_data("\xd9\xff");
     msg::packer packer;
     std::string string(255, 'a');
     packer.pack_string(string);
 
-    XCTAssertEqual(packer.size(), packed.size() + string.size());
-    XCTAssertEqual(msg::string(packer.data(), packed.size()), packed);
-    XCTAssertTrue(all_a(packer.begin() + packed.size(), packer.end()));
+    CHECK_EQ(packer.size(), packed.size() + string.size());
+    CHECK_EQ(msg::string(packer.data(), packed.size()), packed);
+    CHECK(all_a(packer.begin() + packed.size(), packer.end()));
 }
 
-- (void)testPackString16bitMin {
+TEST(Msgpack, PackString16bitMin) {
     auto packed = packed_data("\xda\x01\x00");
     msg::packer packer;
     std::string string(256, 'a');
     packer.pack_string(string);
 
-    XCTAssertEqual(packer.size(), packed.size() + string.size());
-    XCTAssertEqual(msg::string(packer.data(), packed.size()), packed);
-    XCTAssertTrue(all_a(packer.begin() + packed.size(), packer.end()));
+    CHECK_EQ(packer.size(), packed.size() + string.size());
+    CHECK_EQ(msg::string(packer.data(), packed.size()), packed);
+    CHECK(all_a(packer.begin() + packed.size(), packer.end()));
 }
 
-- (void)testPackString16bitMax {
+TEST(Msgpack, PackString16bitMax) {
     auto packed = packed_data("\xda\xff\xff");
     msg::packer packer;
     std::string string(65535, 'a');
     packer.pack_string(string);
 
-    XCTAssertEqual(packer.size(), packed.size() + string.size());
-    XCTAssertEqual(msg::string(packer.data(), packed.size()), packed);
-    XCTAssertTrue(all_a(packer.begin() + packed.size(), packer.end()));
+    CHECK_EQ(packer.size(), packed.size() + string.size());
+    CHECK_EQ(msg::string(packer.data(), packed.size()), packed);
+    CHECK(all_a(packer.begin() + packed.size(), packer.end()));
 }
 
-- (void)testPackString32bitMin {
+TEST(Msgpack, PackString32bitMin) {
     auto packed = packed_data("\xdb\x00\x01\x00\x00");
     msg::packer packer;
     std::string string(65536, 'a');
     packer.pack_string(string);
 
-    XCTAssertEqual(packer.size(), packed.size() + string.size());
-    XCTAssertEqual(msg::string(packer.data(), packed.size()), packed);
-    XCTAssertTrue(all_a(packer.begin() + packed.size(), packer.end()));
+    CHECK_EQ(packer.size(), packed.size() + string.size());
+    CHECK_EQ(msg::string(packer.data(), packed.size()), packed);
+    CHECK(all_a(packer.begin() + packed.size(), packer.end()));
 }
 
-- (void)testPackArray {
+TEST(Msgpack, PackArray) {
     auto packed = packed_data("\x94\x01\x02\x03\x04");
     msg::packer packer;
     packer.pack_array(std::vector{1, 2, 3, 4});
     
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackArrayTuple {
+TEST(Msgpack, PackArrayTuple) {
     auto packed = packed_data("\x92\xa3\x6f\x6e\x65\x01");
     msg::packer packer;
     packer.pack_tuple(std::tuple<std::string, int>("one", 1));
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackArrayEmpty {
+TEST(Msgpack, PackArrayEmpty) {
     auto packed = packed_data("\x90");
     msg::packer packer;
     packer.pack_array(std::vector<uint64_t>());
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackArrayRecursive {
+TEST(Msgpack, PackArrayRecursive) {
     auto packed = packed_data("\x91\x91\x91\x91\x90");
     msg::packer packer;
     packer.start_array(1);
@@ -1714,66 +1752,66 @@ static inline bool all_a(const char *begin, const char *end) {
     packer.start_array(1);
     packer.start_array(0);
     
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testStartPackArrayEmpty {
+TEST(Msgpack, StartPackArrayEmpty) {
     auto packed = packed_data("\x90");
     msg::packer packer;
     packer.start_array(0);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackStartArrayFixedMin {
+TEST(Msgpack, PackStartArrayFixedMin) {
     auto packed = packed_data("\x91");
     msg::packer packer;
     packer.start_array(1);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackStartArrayFixedMax {
+TEST(Msgpack, PackStartArrayFixedMax) {
     auto packed = packed_data("\x9f");
     msg::packer packer;
     packer.start_array(15);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackStartArray16bitMin {
+TEST(Msgpack, PackStartArray16bitMin) {
     auto packed = packed_data("\xdc\x01\x00");
     msg::packer packer;
     packer.start_array(256);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackStartArray16bitMax {
+TEST(Msgpack, PackStartArray16bitMax) {
     auto packed = packed_data("\xdc\xff\xff");
     msg::packer packer;
     packer.start_array(65535);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackStartArray32bitMin {
+TEST(Msgpack, PackStartArray32bitMin) {
     auto packed = packed_data("\xdd\x00\x01\x00\x00");
     msg::packer packer;
     packer.start_array(65536);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackStartArray32bitMax {
+TEST(Msgpack, PackStartArray32bitMax) {
     auto packed = packed_data("\xdd\xff\xff\xff\xff");
     msg::packer packer;
     packer.start_array(4294967295);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackMap {
+TEST(Msgpack, PackMap) {
     auto packed = packed_data("\x83\xa1\x30\x00\xa1\x31\x01\xa1\x32\x02");
     msg::packer packer;
     packer.pack_map(std::vector{
@@ -1782,74 +1820,74 @@ static inline bool all_a(const char *begin, const char *end) {
         std::pair("2", 2)
     });
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackMapEmpty {
+TEST(Msgpack, PackMapEmpty) {
     auto packed = packed_data("\x80");
     msg::packer packer;
     packer.pack_map(std::vector<std::pair<int, int>>());
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackStartMapEmpty {
+TEST(Msgpack, PackStartMapEmpty) {
     auto packed = packed_data("\x80");
     msg::packer packer;
     packer.start_map(0);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackStartMapFixedMin {
+TEST(Msgpack, PackStartMapFixedMin) {
     auto packed = packed_data("\x81");
     msg::packer packer;
     packer.start_map(1);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackStartMapFixedMax {
+TEST(Msgpack, PackStartMapFixedMax) {
     auto packed = packed_data("\x8f");
     msg::packer packer;
     packer.start_map(15);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackStartMap16bitMin {
+TEST(Msgpack, PackStartMap16bitMin) {
     auto packed = packed_data("\xde\x01\x00");
     msg::packer packer;
     packer.start_map(256);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackStartMap16bitMax {
+TEST(Msgpack, PackStartMap16bitMax) {
     auto packed = packed_data("\xde\xff\xff");
     msg::packer packer;
     packer.start_map(65535);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackStartMap32bitMin {
+TEST(Msgpack, PackStartMap32bitMin) {
     auto packed = packed_data("\xdf\x00\x01\x00\x00");
     msg::packer packer;
     packer.start_map(65536);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackStartMap32bitMax {
+TEST(Msgpack, PackStartMap32bitMax) {
     auto packed = packed_data("\xdf\xff\xff\xff\xff");
     msg::packer packer;
     packer.start_map(4294967295);
 
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-- (void)testPackGeneric {
+TEST(Msgpack, PackGeneric) {
     auto packed = packed_data("\xc3\xcd\x01\xb0\xcb\x40\x09\x1e\xb8\x51"
                               "\xeb\x85\x1f\xa6\x73\x74\x72\x69\x6e\x67"
                               "\x94\x01\x02\x03\x04\x83\xa1\x30\x00\xa1"
@@ -1871,7 +1909,6 @@ static inline bool all_a(const char *begin, const char *end) {
 
     packer.pack(std::tuple<std::string, int>("tuple", 1));
     
-    XCTAssertEqual(msg::string(packer.data(), packer.size()), packed);
+    CHECK_EQ(msg::string(packer.data(), packer.size()), packed);
 }
 
-@end
@@ -0,0 +1,233 @@
+//
+//  Neovim Mac Test
+//  OutboundQueue.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "outbound_queue.hpp"
+#include "check.hpp"
+
+using nvim::outbound_queue;
+using nvim::outbound_segment;
+
+struct tagged {
+    uint32_t producer;
+    uint32_t sequence;
+};
+
+/// Pops everything from a multi producer run, checking each producer's
+/// messages arrive in order. Returns the number of messages popped.
+static size_t drain(outbound_queue &queue, std::vector<uint32_t> &expected,
+                    size_t total, bool &ordered) {
+    size_t count = 0;
+
+    while (count < total) {
+        outbound_segment *segment = queue.pop();
+        if (!segment) continue;
+
+        tagged tag;
+        memcpy(&tag, segment->data(), sizeof(tag));
+        outbound_queue::release(segment);
+
+        if (tag.sequence != expected[tag.producer]++) {
+            ordered = false;
+        }
+
+        count += 1;
+    }
+
+    return count;
+}
+
+TEST(OutboundQueue, Empty) {
+    outbound_queue queue;
+    CHECK_EQ(queue.pop(), nullptr);
+    CHECK_EQ(queue.size(), 0);
+}
+
+TEST(OutboundQueue, Fifo) {
+    outbound_queue queue;
+    queue.push("abc", 3);
+    queue.push("defgh", 5);
+    CHECK_EQ(queue.size(), 8);
+
+    outbound_segment *first = queue.pop();
+    CHECK_EQ(first->size, 3);
+    CHECK_EQ(memcmp(first->data(), "abc", 3), 0);
+    CHECK_EQ(queue.size(), 5);
+
+    // The queue keeps working after it's been emptied.
+    outbound_segment *second = queue.pop();
+    CHECK_EQ(second->size, 5);
+    CHECK_EQ(memcmp(second->data(), "defgh", 5), 0);
+    CHECK_EQ(queue.pop(), nullptr);
+    CHECK_EQ(queue.size(), 0);
+
+    queue.push("ij", 2);
+    outbound_segment *third = queue.pop();
+    CHECK_EQ(third->size, 2);
+    CHECK_EQ(memcmp(third->data(), "ij", 2), 0);
+    CHECK_EQ(queue.pop(), nullptr);
+
+    outbound_queue::release(first);
+    outbound_queue::release(second);
+    outbound_queue::release(third);
+}
+
+TEST(OutboundQueue, PopStatus) {
+    outbound_queue queue;
+    outbound_queue::pop_status status;
+    CHECK(!queue.ready());
+    CHECK_EQ(queue.pop(status), nullptr);
+    CHECK(status == outbound_queue::pop_status::empty);
+
+    queue.push("abc", 3);
+    queue.push("def", 3);
+    CHECK(queue.ready());
+
+    for (int i=0; i<2; ++i) {
+        outbound_segment *segment = queue.pop(status);
+        CHECK_NE(segment, nullptr);
+        CHECK(status == outbound_queue::pop_status::popped);
+        outbound_queue::release(segment);
+    }
+
+    CHECK(!queue.ready());
+    CHECK_EQ(queue.pop(status), nullptr);
+    CHECK(status == outbound_queue::pop_status::empty);
+}
+
+TEST(OutboundQueue, EmptySegment) {
+    outbound_queue queue;
+    queue.push("", 0);
+
+    outbound_segment *segment = queue.pop();
+    CHECK_NE(segment, nullptr);
+    CHECK_EQ(segment->size, 0);
+    outbound_queue::release(segment);
+}
+
+TEST(OutboundQueue, DestructorFreesSegments) {
+    outbound_queue queue;
+    queue.push("abc", 3);
+    queue.push("def", 3);
+}
+
+TEST(OutboundQueue, LargeSegment) {
+    outbound_queue queue;
+    std::vector<char> message(64 * 1024, 'x');
+    queue.push(message.data(), message.size());
+
+    outbound_segment *segment = queue.pop();
+    CHECK_EQ(segment->size, message.size());
+    CHECK_EQ(memcmp(segment->data(), message.data(), message.size()), 0);
+    outbound_queue::release(segment);
+}
+
+TEST(OutboundQueue, SegmentsAreRecycled) {
+    outbound_segment *first = outbound_queue::allocate("abc", 3);
+    outbound_queue::release(first);
+
+    outbound_segment *second = outbound_queue::allocate("defgh", 5);
+    CHECK_EQ(second, first);
+    CHECK_EQ(memcmp(second->data(), "defgh", 5), 0);
+    outbound_queue::release(second);
+}
+
+TEST(OutboundQueue, ConcurrentRecycling) {
+    // Threads allocate and release small segments concurrently, more than
+    // the pool holds, and check nobody else wrote to a segment they own.
+    std::vector<std::thread> threads;
+    std::atomic<bool> intact = true;
+
+    for (uint32_t i=0; i<4; ++i) {
+        threads.emplace_back([&intact, i]() {
+            std::vector<outbound_segment*> owned;
+
+            for (uint32_t j=0; j<100000; ++j) {
+                tagged tag = {i, j};
+                owned.push_back(outbound_queue::allocate(&tag, sizeof(tag)));
+
+                if (owned.size() < 100) continue;
+
+                for (outbound_segment *segment : owned) {
+                    memcpy(&tag, segment->data(), sizeof(tag));
+                    if (tag.producer != i) intact = false;
+                    outbound_queue::release(segment);
+                }
+
+                owned.clear();
+            }
+
+            for (outbound_segment *segment : owned) {
+                outbound_queue::release(segment);
+            }
+        });
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    CHECK(intact);
+}
+
+TEST(OutboundQueue, MultipleProducers) {
+    constexpr uint32_t producers = 4;
+    constexpr uint32_t messages = 100000;
+
+    outbound_queue queue;
+    std::vector<std::thread> threads;
+
+    for (uint32_t i=0; i<producers; ++i) {
+        threads.emplace_back([&queue, i]() {
+            for (uint32_t j=0; j<messages; ++j) {
+                tagged tag = {i, j};
+                queue.push(&tag, sizeof(tag));
+            }
+        });
+    }
+
+    std::vector<uint32_t> expected(producers);
+    bool ordered = true;
+    size_t count = drain(queue, expected, producers * messages, ordered);
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    CHECK_EQ(count, producers * messages);
+    CHECK(ordered);
+    CHECK_EQ(queue.pop(), nullptr);
+    CHECK_EQ(queue.size(), 0);
+
+    for (uint32_t i=0; i<producers; ++i) {
+        CHECK_EQ(expected[i], messages);
+    }
+}
+
+BENCHMARK(OutboundQueue, PushPopPerformance) {
+    // Small messages, gathered in batches like the writer does.
+    outbound_queue queue;
+    char message[64] = {};
+
+    check::measure([&] {
+        for (int i=0; i<1000; ++i) {
+            for (int j=0; j<100; ++j) {
+                queue.push(message, sizeof(message));
+            }
+
+            while (outbound_segment *segment = queue.pop()) {
+                outbound_queue::release(segment);
+            }
+        }
+    });
+}
+
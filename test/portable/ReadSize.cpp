@@ -0,0 +1,75 @@
+//
+//  Neovim Mac Test
+//  ReadSize.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include "read_size.hpp"
+#include "check.hpp"
+
+using nvim::adaptive_read_size;
+
+TEST(ReadSize, ShortReads) {
+    adaptive_read_size size;
+    CHECK_EQ(size.size(), adaptive_read_size::min_size);
+
+    for (int i=0; i<1000; ++i) {
+        CHECK(!size.read(100));
+        size.burst_end();
+    }
+
+    CHECK_EQ(size.size(), adaptive_read_size::min_size);
+}
+
+TEST(ReadSize, Growth) {
+    adaptive_read_size size;
+
+    // Every full read doubles the next read, up to the maximum.
+    while (size.size() < adaptive_read_size::max_size) {
+        size_t previous = size.size();
+        CHECK(size.read(previous));
+        CHECK_EQ(size.size(), previous * 2);
+    }
+
+    CHECK(size.read(adaptive_read_size::max_size));
+    CHECK_EQ(size.size(), adaptive_read_size::max_size);
+    size.burst_end();
+}
+
+TEST(ReadSize, Shrink) {
+    adaptive_read_size size;
+    CHECK(size.read(size.size()));
+    CHECK(size.read(size.size()));
+    size.burst_end();
+
+    const size_t grown = size.size();
+    CHECK_EQ(grown, adaptive_read_size::min_size * 4);
+
+    // A large burst in between resets the count of small bursts.
+    for (int i=0; i<adaptive_read_size::shrink_after - 1; ++i) {
+        size.read(100);
+        size.burst_end();
+    }
+
+    size.read(grown / 2);
+    size.burst_end();
+    CHECK_EQ(size.size(), grown);
+
+    for (int i=0; i<adaptive_read_size::shrink_after; ++i) {
+        size.read(100);
+        size.burst_end();
+    }
+
+    CHECK_EQ(size.size(), grown / 2);
+
+    for (int i=0; i<adaptive_read_size::shrink_after * 10; ++i) {
+        size.read(100);
+        size.burst_end();
+    }
+
+    CHECK_EQ(size.size(), adaptive_read_size::min_size);
+}
+
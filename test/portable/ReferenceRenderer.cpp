@@ -0,0 +1,364 @@
+//
+//  Neovim Mac Test
+//  ReferenceRenderer.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "frame_builder.hpp"
+#include "reference_renderer.hpp"
+#include "check.hpp"
+
+static constexpr uint32_t red   = 0xFF0000FF;
+static constexpr uint32_t green = 0xFF00FF00;
+static constexpr uint32_t blue  = 0xFFFF0000;
+static constexpr uint32_t white = 0xFFFFFFFF;
+
+/// 4x8 pixel cells, with the baseline 6 pixels from the top of the cell.
+static uniform_data make_uniforms() {
+    uniform_data uniforms = {};
+    uniforms.cell_pixel_size = simd_make_float2(4, 8);
+    uniforms.baseline = simd_make_float2(0, 6);
+    return uniforms;
+}
+
+/// Returns the 8 bit sRGB encoding of a linear value, rounded to nearest.
+static uint32_t encode_srgb(double linear) {
+    double srgb = linear <= 0.0031308 ? linear * 12.92 :
+                                        1.055 * pow(linear, 1 / 2.4) - 0.055;
+    return static_cast<uint32_t>(lround(srgb * 255));
+}
+
+/// Returns the linear value of an 8 bit sRGB component.
+static double decode_srgb(uint32_t component) {
+    double srgb = component / 255.0;
+    return srgb <= 0.04045 ? srgb / 12.92 : pow((srgb + 0.055) / 1.055, 2.4);
+}
+
+/// FNV-1a hash of the framebuffer.
+static uint64_t hash_framebuffer(const reference_renderer &renderer) {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char*>(renderer.data());
+    size_t size = renderer.width() * renderer.height() * sizeof(uint32_t);
+    uint64_t hash = 14695981039346656037ull;
+
+    for (size_t i=0; i<size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+
+    return hash;
+}
+
+TEST(ReferenceRenderer, Backgrounds) {
+    reference_renderer renderer(16, 16);
+    renderer.clear(white);
+
+    background_data backgrounds[] = {
+        background_data(simd_make_short2(0, 0), 3, red),
+        background_data(simd_make_short2(1, 1), 2, blue)
+    };
+
+    renderer.draw_backgrounds(make_uniforms(), backgrounds, 2);
+
+    CHECK_EQ(renderer.pixel(0, 0), red);
+    CHECK_EQ(renderer.pixel(11, 7), red);
+    CHECK_EQ(renderer.pixel(12, 0), white);
+    CHECK_EQ(renderer.pixel(3, 8), white);
+    CHECK_EQ(renderer.pixel(4, 8), blue);
+    CHECK_EQ(renderer.pixel(11, 15), blue);
+    CHECK_EQ(renderer.pixel(12, 15), white);
+}
+
+TEST(ReferenceRenderer, GlyphsAreCroppedToTheirCell) {
+    glyph_atlas atlas(64, 64);
+
+    // A 3x10 glyph, taller than the cell, each pixel is unique.
+    std::vector<uint32_t> pixels(30);
+
+    for (uint32_t i=0; i<pixels.size(); ++i) {
+        pixels[i] = 0xFF000000 | i;
+    }
+
+    atlas.add(pixels.data(), 1, 1);
+
+    glyph_rect rect = {};
+    rect.size = simd_make_short2(3, 10);
+    rect.position = simd_make_short2(1, -7);
+    rect.texture_origin = atlas.add(pixels.data(), 3, 10);
+
+    glyph_data glyph(simd_make_short2(1, 0), 1, rect);
+
+    reference_renderer renderer(16, 16);
+    renderer.clear(white);
+    renderer.draw_glyphs(make_uniforms(), &glyph, nullptr, 1, atlas);
+
+    // The glyph starts one pixel above the cell, its first row is cropped.
+    CHECK_EQ(renderer.pixel(5, 0), 0xFF000003);
+    CHECK_EQ(renderer.pixel(7, 0), 0xFF000005);
+    CHECK_EQ(renderer.pixel(6, 7), 0xFF000019);
+
+    // Pixels outside of the glyph, or in the next row, are untouched.
+    CHECK_EQ(renderer.pixel(4, 0), white);
+    CHECK_EQ(renderer.pixel(8, 0), white);
+    CHECK_EQ(renderer.pixel(5, 8), white);
+}
+
+TEST(ReferenceRenderer, ColorClassGlyphs) {
+    const uint16_t cls = glyph_color_class_make(GLYPH_COLOR_CLASS_LEVELS - 1, 0);
+    const uint32_t fg_grey = glyph_color_class_grey(GLYPH_COLOR_CLASS_LEVELS - 1);
+    const uint32_t bg_grey = glyph_color_class_grey(0);
+
+    // Full coverage, no coverage.
+    uint32_t pixels[] = {
+        0xFF000000 | (fg_grey * 0x010101),
+        0xFF000000 | (bg_grey * 0x010101)
+    };
+
+    glyph_atlas atlas(64, 64);
+    glyph_rect rect = {};
+    rect.size = simd_make_short2(2, 1);
+    rect.position = simd_make_short2(0, -1);
+    rect.texture_origin = atlas.add(pixels, 2, 1);
+
+    const uint32_t foreground = 0xFF3080E0;
+    const uint32_t background = 0xFF201010;
+    glyph_data glyph(simd_make_short2(0, 0), 1, rect, cls);
+    glyph_colors colors(foreground, background);
+
+    reference_renderer renderer(16, 16);
+    renderer.draw_glyphs(make_uniforms(), &glyph, &colors, 1, atlas);
+
+    CHECK_EQ(renderer.pixel(0, 5), foreground);
+    CHECK_EQ(renderer.pixel(1, 5), background);
+}
+
+TEST(ReferenceRenderer, ColorClassBlend) {
+    const uint16_t cls = glyph_color_class_make(2, 1);
+    const double class_background = decode_srgb(glyph_color_class_grey(1));
+    const double class_range = decode_srgb(glyph_color_class_grey(2)) - class_background;
+
+    // 11 texels spanning the class's greys, so the last group of four pixels
+    // is partial.
+    uint32_t pixels[11];
+
+    for (uint32_t i=0; i<11; ++i) {
+        pixels[i] = 0xFF000000 | ((50 + i * 12) * 0x010101);
+    }
+
+    glyph_atlas atlas(64, 64);
+    glyph_rect rect = {};
+    rect.size = simd_make_short2(11, 1);
+    rect.position = simd_make_short2(0, -1);
+    rect.texture_origin = atlas.add(pixels, 11, 1);
+
+    const uint32_t foreground = 0xFF3080E0;
+    const uint32_t background = 0xFF201010;
+    glyph_data glyph(simd_make_short2(0, 0), 3, rect, cls);
+    glyph_colors colors(foreground, background);
+
+    reference_renderer renderer(16, 16);
+    renderer.clear(white);
+    renderer.draw_glyphs(make_uniforms(), &glyph, &colors, 1, atlas);
+
+    for (uint32_t i=0; i<11; ++i) {
+        double coverage = std::clamp((decode_srgb(pixels[i] & 0xFF) - class_background) /
+                                     class_range, 0.0, 1.0);
+        uint32_t expected = 0xFF000000;
+
+        for (uint32_t shift=0; shift<24; shift += 8) {
+            double fg = decode_srgb((foreground >> shift) & 0xFF);
+            double bg = decode_srgb((background >> shift) & 0xFF);
+            expected |= encode_srgb(bg + coverage * (fg - bg)) << shift;
+        }
+
+        CHECK_EQ(renderer.pixel(i, 5), expected);
+    }
+
+    // The cell's last pixel is outside of the glyph, and untouched.
+    CHECK_EQ(renderer.pixel(11, 5), white);
+}
+
+TEST(ReferenceRenderer, Lines) {
+    line_metrics solid = {2, 0, 1};
+    line_metrics dotted = {0, 2, 1};
+
+    line_data lines[] = {
+        line_data(simd_make_short2(0, 0), red, solid),
+        line_data(simd_make_short2(1, 0), blue, dotted, 0),
+        line_data(simd_make_short2(2, 0), blue, dotted, 1)
+    };
+
+    reference_renderer renderer(16, 16);
+    renderer.clear(white);
+    renderer.draw_lines(make_uniforms(), lines, 3);
+
+    // The solid line is 2 pixels above the baseline.
+    for (size_t x=0; x<4; ++x) {
+        CHECK_EQ(renderer.pixel(x, 4), red);
+        CHECK_EQ(renderer.pixel(x, 5), white);
+    }
+
+    // Dots are 2 pixels long, separated by 2 pixels, and continue across cells.
+    const uint32_t expected[] = {blue, blue, white, white};
+
+    for (size_t x=4; x<12; ++x) {
+        CHECK_EQ(renderer.pixel(x, 6), expected[x % 4]);
+    }
+}
+
+TEST(ReferenceRenderer, Cursors) {
+    uniform_data uniforms = make_uniforms();
+    uniforms.cursor_position = simd_make_short2(1, 1);
+    uniforms.cursor_color = green;
+    uniforms.cursor_line_width = 1;
+    uniforms.cursor_cell_width = 1;
+
+    reference_renderer renderer(16, 16);
+    renderer.clear(white);
+    renderer.draw_cursor(uniforms, 1, 0);
+
+    // Vertical bars are on the left of the cell.
+    CHECK_EQ(renderer.pixel(4, 8), green);
+    CHECK_EQ(renderer.pixel(4, 15), green);
+    CHECK_EQ(renderer.pixel(5, 8), white);
+
+    renderer.clear(white);
+    renderer.draw_cursor(uniforms, 1, 1);
+
+    // Horizontal bars are on the bottom of the cell.
+    CHECK_EQ(renderer.pixel(4, 15), green);
+    CHECK_EQ(renderer.pixel(7, 15), green);
+    CHECK_EQ(renderer.pixel(4, 14), white);
+
+    renderer.clear(white);
+    renderer.draw_cursor(uniforms, 4, 0);
+
+    // Block outlines.
+    CHECK_EQ(renderer.pixel(4, 8), green);
+    CHECK_EQ(renderer.pixel(7, 8), green);
+    CHECK_EQ(renderer.pixel(7, 15), green);
+    CHECK_EQ(renderer.pixel(5, 10), white);
+    CHECK_EQ(renderer.pixel(8, 8), white);
+}
+
+TEST(ReferenceRenderer, GoldenFrame) {
+    const size_t width = 8;
+    const size_t height = 3;
+    glyph_atlas atlas(64, 64);
+
+    // Every letter gets a 3x5 glyph of its own color.
+    glyph_rect letters[26];
+
+    for (int i=0; i<26; ++i) {
+        std::vector<uint32_t> pixels(15, 0xFF000000 | (i * 0x090909));
+        letters[i].size = simd_make_short2(3, 5);
+        letters[i].position = simd_make_short2(0, -5);
+        letters[i].texture_origin = atlas.add(pixels.data(), 3, 5);
+    }
+
+    std::vector<nvim::cell> cells;
+
+    for (size_t i=0; i<width * height; ++i) {
+        nvim::cell_attributes attrs = {};
+        attrs.foreground = nvim::rgb_color(255, 255, 255);
+        attrs.background = nvim::rgb_color(0, 0, (i / 3) * 30);
+        attrs.special = nvim::rgb_color(255, 0, 0);
+        attrs.flags = i % 5 ? 0 : nvim::cell_attributes::undercurl;
+
+        char text[] = {static_cast<char>('a' + (i % 26)), 0};
+        cells.push_back(nvim::cell(i % 7 ? text : " ", &attrs));
+    }
+
+    nvim::cursor_attributes cursor_attrs = {};
+    cursor_attrs.background = nvim::rgb_color(0, 255, 0);
+    cursor_attrs.shape = nvim::cursor_shape::block;
+    nvim::cursor cursor(1, 2, cells.data() + width + 2, cursor_attrs);
+
+    std::vector<background_data> backgrounds(cells.size());
+    std::vector<glyph_data> glyphs(cells.size());
+    std::vector<line_data> lines(cells.size() * 2);
+
+    frame_builder builder(line_metrics{1, 0, 1}, line_metrics{0, 2, 1}, line_metrics{3, 0, 1});
+    frame_counts counts = builder.build(adjusted_grid(cells.data(), width, height, cursor),
+                                        backgrounds.data(), glyphs.data(), nullptr,
+                                        lines.data(),
+                                        [&](const nvim::cell &cell, simd_short2 gridpos) {
+        return glyph_data(gridpos, cell.width(), letters[cell.grapheme_view()[0] - 'a']);
+    });
+
+    reference_renderer renderer(width * 4, height * 8);
+    uniform_data uniforms = make_uniforms();
+
+    renderer.clear(white);
+    renderer.draw_backgrounds(uniforms, backgrounds.data(), counts.backgrounds);
+    renderer.draw_glyphs(uniforms, glyphs.data(), nullptr, counts.glyphs, atlas);
+    renderer.draw_lines(uniforms, lines.data(), counts.lines);
+
+    // Spot check the cursor cell, then compare the whole frame.
+    CHECK_EQ(renderer.pixel(8, 8), 0xFF00FF00);
+    CHECK_EQ(renderer.pixel(8, 9), 0xFF000000 | (10 * 0x090909));
+    CHECK_EQ(hash_framebuffer(renderer), 616110175613065852ull);
+}
+
+BENCHMARK(ReferenceRenderer, RenderPerformance) {
+    const size_t width = 200;
+    const size_t height = 60;
+    glyph_atlas atlas(512, 512);
+    std::mt19937 rng(3);
+
+    std::vector<uint32_t> pixels(8 * 14);
+
+    for (uint32_t &pixel : pixels) {
+        pixel = 0xFF000000 | (rng() & 0xFFFFFF);
+    }
+
+    glyph_rect rect = {};
+    rect.size = simd_make_short2(8, 14);
+    rect.position = simd_make_short2(0, -12);
+    rect.texture_origin = atlas.add(pixels.data(), 8, 14);
+
+    uniform_data uniforms = {};
+    uniforms.cell_pixel_size = simd_make_float2(8, 16);
+    uniforms.baseline = simd_make_float2(0, 12);
+
+    std::vector<background_data> backgrounds;
+    std::vector<glyph_data> glyphs;
+    std::vector<glyph_colors> colors;
+    std::vector<line_data> lines;
+
+    for (int16_t row=0; row<height; ++row) {
+        for (int16_t col=0; col<width; col += 20) {
+            backgrounds.push_back(background_data(simd_make_short2(col, row), 20,
+                                                  0xFF000000 | (rng() & 0xFFFFFF)));
+        }
+
+        for (int16_t col=0; col<width; ++col) {
+            simd_short2 gridpos = simd_make_short2(col, row);
+
+            if (col % 3) {
+                glyphs.push_back(glyph_data(gridpos, 1, rect));
+            } else {
+                glyphs.push_back(glyph_data(gridpos, 1, rect, glyph_color_class_make(3, 0)));
+            }
+
+            colors.push_back(glyph_colors(0xFF3080E0, 0xFF201010));
+
+            if (col % 4 == 0) {
+                lines.push_back(line_data(gridpos, red, line_metrics{0, 2, 2}, col % 8));
+            }
+        }
+    }
+
+    reference_renderer renderer(width * 8, height * 16);
+
+    check::measure([&] {
+        renderer.draw_backgrounds(uniforms, backgrounds.data(), backgrounds.size());
+        renderer.draw_glyphs(uniforms, glyphs.data(), colors.data(), glyphs.size(), atlas);
+        renderer.draw_lines(uniforms, lines.data(), lines.size());
+    });
+}
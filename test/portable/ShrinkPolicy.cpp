@@ -0,0 +1,95 @@
+//
+//  Neovim Mac Test
+//  ShrinkPolicy.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include "shrink_policy.hpp"
+#include "check.hpp"
+
+using nvim::shrink_policy;
+
+TEST(ShrinkPolicy, SmallBuffersKeepCapacity) {
+    shrink_policy policy;
+
+    for (int i=0; i<1000; ++i) {
+        policy.used(10);
+        CHECK_EQ(policy.drained(shrink_policy::target_capacity), 0);
+    }
+}
+
+TEST(ShrinkPolicy, LargeBuffersWaitForQuietDrains) {
+    shrink_policy policy;
+    size_t capacity = 512 * 1024 * 1024;
+
+    // Repeated large bursts keep the buffer.
+    for (int i=0; i<shrink_policy::shrink_after * 2; ++i) {
+        policy.used(i % 8 == 7 ? 200 * 1024 * 1024 : 1024);
+        CHECK_EQ(policy.drained(capacity), 0);
+    }
+
+    for (int i=0; i<shrink_policy::shrink_after - 1; ++i) {
+        policy.used(1024);
+        CHECK_EQ(policy.drained(capacity), 0);
+    }
+
+    policy.used(1024);
+    CHECK_EQ(policy.drained(capacity), shrink_policy::target_capacity);
+}
+
+TEST(ShrinkPolicy, QuietDrainsShrink) {
+    shrink_policy policy;
+    size_t capacity = 4 * 1024 * 1024;
+
+    for (int i=0; i<shrink_policy::shrink_after - 1; ++i) {
+        policy.used(i == 5 ? 256 * 1024 : 1024);
+        CHECK_EQ(policy.drained(capacity), 0);
+    }
+
+    // Shrinks to twice the largest quiet burst.
+    policy.used(1024);
+    CHECK_EQ(policy.drained(capacity), 512 * 1024);
+}
+
+TEST(ShrinkPolicy, ShrinksNoSmallerThanTarget) {
+    shrink_policy policy;
+    size_t capacity = 1024 * 1024;
+
+    for (int i=0; i<shrink_policy::shrink_after - 1; ++i) {
+        policy.used(100);
+        CHECK_EQ(policy.drained(capacity), 0);
+    }
+
+    policy.used(100);
+    CHECK_EQ(policy.drained(capacity), shrink_policy::target_capacity);
+}
+
+TEST(ShrinkPolicy, BusyBurstResets) {
+    shrink_policy policy;
+    size_t capacity = 1024 * 1024;
+
+    for (int i=0; i<shrink_policy::shrink_after * 4; ++i) {
+        // Every 16th burst uses more than a quarter of the buffer.
+        policy.used(i % 16 == 15 ? capacity / 2 : 100);
+        CHECK_EQ(policy.drained(capacity), 0);
+    }
+}
+
+TEST(ShrinkPolicy, PeakIsResetOnDrain) {
+    shrink_policy policy;
+    size_t capacity = 1024 * 1024;
+
+    // The peak of a busy burst doesn't carry over into the next.
+    policy.used(capacity);
+    CHECK_EQ(policy.drained(capacity), 0);
+
+    for (int i=0; i<shrink_policy::shrink_after - 1; ++i) {
+        CHECK_EQ(policy.drained(capacity), 0);
+    }
+
+    CHECK_EQ(policy.drained(capacity), shrink_policy::target_capacity);
+}
+
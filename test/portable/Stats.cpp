@@ -0,0 +1,124 @@
+//
+//  Neovim Mac Test
+//  Stats.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <string>
+#include <thread>
+#include <vector>
+#include "stats.hpp"
+#include "check.hpp"
+
+// Stats.mm counts events by driving a ui_controller, which needs dispatch.
+// Here the counters are fed directly.
+
+TEST(Stats, RedrawCounts) {
+    nvim::redraw_stats stats;
+    stats.add_event(nvim::redraw_event_type::grid_resize, 1, 0);
+    stats.add_event(nvim::redraw_event_type::hl_attr_define, 2, 0);
+    stats.add_event(nvim::redraw_event_type::grid_line, 2, 0);
+    stats.add_cells(nvim::redraw_event_type::grid_line, 3, 3);
+    stats.add_cells(nvim::redraw_event_type::grid_line, 5, 3);
+    stats.add_event(nvim::redraw_event_type::ignored, 1, 0);
+    stats.add_event(nvim::redraw_event_type::unknown, 0, 0);
+    stats.add_event(nvim::redraw_event_type::flush, 1, 0);
+
+    nvim::redraw_counts lines = stats.get(nvim::redraw_event_type::grid_line);
+
+    CHECK_EQ(lines.events, 1);
+    CHECK_EQ(lines.calls, 2);
+    CHECK_EQ(lines.cells, 8);
+    CHECK_EQ(lines.bytes, 1 + 2 + 3);
+
+    CHECK_EQ(stats.get(nvim::redraw_event_type::hl_attr_define).calls, 2);
+    CHECK_EQ(stats.get(nvim::redraw_event_type::flush).events, 1);
+    CHECK_EQ(stats.get(nvim::redraw_event_type::ignored).events, 1);
+    CHECK_EQ(stats.get(nvim::redraw_event_type::unknown).events, 1);
+    CHECK_EQ(stats.get(nvim::redraw_event_type::grid_scroll).events, 0);
+    CHECK_EQ(stats.total().events, 6);
+
+    stats.reset();
+    CHECK_EQ(stats.total().events, 0);
+    CHECK_EQ(stats.total().cells, 0);
+}
+
+TEST(Stats, Report) {
+    nvim::rpc_stats rpc;
+    rpc.add_read(100);
+    rpc.add_read(50);
+    rpc.add_write(10);
+    rpc.add_unpack(3, 1000);
+
+    nvim::rpc_counts counts = rpc.get();
+    CHECK_EQ(counts.reads, 2);
+    CHECK_EQ(counts.bytes_read, 150);
+    CHECK_EQ(counts.writes, 1);
+    CHECK_EQ(counts.bytes_written, 10);
+    CHECK_EQ(counts.messages, 3);
+    CHECK_EQ(counts.unpack_nanoseconds, 1000);
+
+    nvim::redraw_stats redraw;
+    redraw.add_event(nvim::redraw_event_type::grid_resize, 1, 0);
+    std::string report = nvim::stats_report(redraw, rpc);
+
+    CHECK(report.find("grid_resize") != std::string::npos);
+    CHECK(report.find("grid_line") == std::string::npos);
+    CHECK(report.find("150 bytes in (2 reads)") != std::string::npos);
+}
+
+TEST(Stats, ConcurrentOutputCapacity) {
+    // Every sending thread records its packing buffer's capacity and shrinks.
+    nvim::rpc_stats rpc;
+    std::vector<std::thread> threads;
+
+    for (uint64_t index=0; index<8; ++index) {
+        threads.emplace_back([&rpc, index] {
+            for (uint64_t i=0; i<10000; ++i) {
+                rpc.set_output_capacity((i * 8) + index);
+                rpc.add_shrink();
+            }
+        });
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    nvim::rpc_counts counts = rpc.get();
+    CHECK_EQ(counts.shrinks, 80000);
+    CHECK_EQ(counts.output_peak_capacity, 79999);
+}
+
+TEST(Stats, ConcurrentWrites) {
+    // Writes are counted on inline writers' threads as well as the IO queue,
+    // so no increment may be lost, and a reset must not be undone.
+    nvim::rpc_stats rpc;
+    std::vector<std::thread> threads;
+
+    for (int index=0; index<8; ++index) {
+        threads.emplace_back([&rpc] {
+            for (uint64_t i=0; i<10000; ++i) {
+                rpc.add_write(2);
+                rpc.add_inline_write();
+            }
+        });
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    nvim::rpc_counts counts = rpc.get();
+    CHECK_EQ(counts.writes, 80000);
+    CHECK_EQ(counts.inline_writes, 80000);
+    CHECK_EQ(counts.bytes_written, 160000);
+
+    rpc.reset();
+    counts = rpc.get();
+    CHECK_EQ(counts.writes, 0);
+    CHECK_EQ(counts.bytes_written, 0);
+}
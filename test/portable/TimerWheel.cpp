@@ -0,0 +1,208 @@
+//
+//  Neovim Mac Test
+//  TimerWheel.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <random>
+#include <vector>
+#include "timer_wheel.hpp"
+#include "check.hpp"
+
+using nvim::timer_wheel;
+using nvim::wheel_timer;
+
+/// A timer that records when it expired, by a fake clock.
+struct fake_timer : wheel_timer {
+    uint64_t deadline = 0;
+    uint64_t expired_at = UINT64_MAX;
+};
+
+/// Advances the wheel to now, marking expired timers. Returns the number of
+/// timers that expired.
+static size_t advance(timer_wheel &wheel, uint64_t now) {
+    size_t expired = 0;
+
+    for (wheel_timer *timer = wheel.advance(now); timer; timer = timer->next) {
+        static_cast<fake_timer*>(timer)->expired_at = now;
+        expired += 1;
+    }
+
+    return expired;
+}
+
+TEST(TimerWheel, Empty) {
+    timer_wheel wheel(10);
+    CHECK_EQ(wheel.size(), 0);
+    CHECK_EQ(wheel.next_deadline(), UINT64_MAX);
+    CHECK_EQ(wheel.advance(1000000), nullptr);
+}
+
+TEST(TimerWheel, ExpiresAtDeadline) {
+    timer_wheel wheel(10);
+    fake_timer timer;
+    wheel.add(&timer, 95);
+
+    CHECK(timer.is_scheduled());
+    CHECK_EQ(wheel.size(), 1);
+    CHECK_EQ(wheel.next_deadline(), 100);
+
+    // Deadlines are rounded up to the next tick, timers never expire early.
+    CHECK_EQ(advance(wheel, 95), 0);
+    CHECK_EQ(advance(wheel, 99), 0);
+    CHECK_EQ(advance(wheel, 100), 1);
+
+    CHECK(!timer.is_scheduled());
+    CHECK_EQ(timer.expired_at, 100);
+    CHECK_EQ(wheel.size(), 0);
+}
+
+TEST(TimerWheel, PastDeadline) {
+    timer_wheel wheel(10);
+    CHECK_EQ(advance(wheel, 1000), 0);
+
+    fake_timer timer;
+    wheel.add(&timer, 0);
+    CHECK_EQ(advance(wheel, 1000), 1);
+}
+
+TEST(TimerWheel, Remove) {
+    timer_wheel wheel(1);
+    fake_timer timers[3];
+
+    for (fake_timer &timer : timers) {
+        wheel.add(&timer, 50);
+    }
+
+    wheel.remove(&timers[1]);
+    CHECK(!timers[1].is_scheduled());
+    CHECK_EQ(wheel.size(), 2);
+
+    // Removing an unscheduled timer does nothing.
+    wheel.remove(&timers[1]);
+    CHECK_EQ(wheel.size(), 2);
+
+    CHECK_EQ(advance(wheel, 50), 2);
+    CHECK_EQ(timers[0].expired_at, 50);
+    CHECK_EQ(timers[1].expired_at, UINT64_MAX);
+    CHECK_EQ(timers[2].expired_at, 50);
+
+    wheel.remove(&timers[0]);
+    CHECK_EQ(wheel.size(), 0);
+    CHECK_EQ(wheel.next_deadline(), UINT64_MAX);
+}
+
+TEST(TimerWheel, Clear) {
+    timer_wheel wheel(1);
+    fake_timer timers[3];
+    wheel.add(&timers[0], 0);
+    wheel.add(&timers[1], 5000);
+    wheel.add(&timers[2], UINT64_MAX);
+
+    size_t removed = 0;
+
+    for (wheel_timer *timer = wheel.clear(); timer; timer = timer->next) {
+        CHECK(!timer->is_scheduled());
+        removed += 1;
+    }
+
+    CHECK_EQ(removed, 3);
+    CHECK_EQ(wheel.size(), 0);
+    CHECK_EQ(wheel.next_deadline(), UINT64_MAX);
+    CHECK_EQ(wheel.advance(UINT64_MAX), nullptr);
+}
+
+TEST(TimerWheel, BatchOrder) {
+    timer_wheel wheel(1);
+    std::vector<fake_timer> timers(200);
+
+    for (size_t i=0; i<timers.size(); ++i) {
+        timers[i].deadline = 1000 - i * 5;
+        wheel.add(&timers[i], timers[i].deadline);
+    }
+
+    // One call expires every due timer, earliest first.
+    uint64_t last = 0;
+    size_t expired = 0;
+
+    for (wheel_timer *timer = wheel.advance(2000); timer; timer = timer->next) {
+        uint64_t deadline = static_cast<fake_timer*>(timer)->deadline;
+        CHECK_GE(deadline, last);
+        last = deadline;
+        expired += 1;
+    }
+
+    CHECK_EQ(expired, timers.size());
+    CHECK_EQ(wheel.size(), 0);
+}
+
+TEST(TimerWheel, LongTimeouts) {
+    timer_wheel wheel(1);
+    CHECK_EQ(advance(wheel, 12345), 0);
+
+    // Deadlines spanning every level, and beyond the last.
+    uint64_t delays[] = {1, 63, 64, 65, 4095, 4096, 4097, 262143, 262144,
+                         16777215, 16777216, 100000000};
+
+    std::vector<fake_timer> timers(std::size(delays));
+
+    for (size_t i=0; i<timers.size(); ++i) {
+        timers[i].deadline = 12345 + delays[i];
+        wheel.add(&timers[i], timers[i].deadline);
+    }
+
+    // Jump straight to each deadline, as the loop would.
+    uint64_t now = 12345;
+
+    while (wheel.size()) {
+        uint64_t next = wheel.next_deadline();
+        CHECK_GT(next, now);
+        now = next;
+        advance(wheel, now);
+    }
+
+    for (fake_timer &timer : timers) {
+        CHECK_EQ(timer.expired_at, timer.deadline);
+    }
+}
+
+TEST(TimerWheel, Accuracy) {
+    constexpr uint64_t resolution = 1000000;
+
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<uint64_t> delays(0, 30 * resolution * 1000);
+    std::uniform_int_distribution<uint64_t> steps(1, resolution / 2);
+
+    timer_wheel wheel(resolution);
+    std::vector<fake_timer> timers(5000);
+    uint64_t now = 1000 * resolution;
+    advance(wheel, now);
+
+    // Add timers while the fake clock ticks forward unevenly.
+    for (fake_timer &timer : timers) {
+        timer.deadline = now + delays(random);
+        wheel.add(&timer, timer.deadline);
+        now += steps(random);
+        advance(wheel, now);
+    }
+
+    // Then wake only when the wheel asks to.
+    while (wheel.size()) {
+        now = std::max(now + 1, wheel.next_deadline() + steps(random) / 100);
+        advance(wheel, now);
+    }
+
+    uint64_t worst = 0;
+
+    for (fake_timer &timer : timers) {
+        CHECK_GE(timer.expired_at, timer.deadline);
+        worst = std::max(worst, timer.expired_at - timer.deadline);
+    }
+
+    // Never early, and late by at most a tick plus wake up jitter.
+    CHECK_LT(worst, resolution + resolution / 2);
+}
+
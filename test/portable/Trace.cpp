@@ -0,0 +1,230 @@
+//
+//  Neovim Mac Test
+//  Trace.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "trace.hpp"
+#include "check.hpp"
+
+// The redraw spans test is in Trace.mm, it drives a ui_controller, which
+// depends on dispatch.
+
+/// Stops tracing when it goes out of scope, even if the test fails.
+struct stop_tracing {
+    ~stop_tracing() {
+        nvim::trace_stop();
+    }
+};
+
+/// Returns the number of events with the given name.
+static size_t count(const std::vector<nvim::trace_event> &events, std::string_view name) {
+    return std::count_if(events.begin(), events.end(), [name](const auto &event) {
+        return name == event.name;
+    });
+}
+
+TEST(Trace, Disabled) {
+    stop_tracing stop;
+    nvim::trace_start();
+    nvim::trace_stop();
+
+    {
+        nvim::trace_span span("disabled");
+    }
+
+    nvim::trace_record("disabled", nvim::trace_clock(), nvim::trace_clock());
+    CHECK_EQ(nvim::trace_snapshot().size(), 0);
+}
+
+TEST(Trace, StartDiscardsOldSpans) {
+    stop_tracing stop;
+    nvim::trace_start();
+    nvim::trace_span("old");
+    CHECK_EQ(nvim::trace_snapshot().size(), 1);
+
+    nvim::trace_start();
+    CHECK_EQ(nvim::trace_snapshot().size(), 0);
+}
+
+TEST(Trace, NestedSpans) {
+    stop_tracing stop;
+    nvim::trace_start();
+
+    {
+        nvim::trace_span outer("outer");
+        nvim::trace_span inner("inner");
+    }
+
+    std::vector<nvim::trace_event> events = nvim::trace_snapshot();
+    CHECK_EQ(events.size(), 2);
+
+    // Events are ordered by start time, the outer span started first.
+    CHECK(std::string_view(events[0].name) == "outer");
+    CHECK(std::string_view(events[1].name) == "inner");
+    CHECK_LE(events[0].begin, events[1].begin);
+    CHECK_GE(events[0].end, events[1].end);
+    CHECK_EQ(events[0].thread, events[1].thread);
+}
+
+TEST(Trace, Threads) {
+    stop_tracing stop;
+    nvim::trace_start();
+    std::vector<std::thread> threads;
+
+    for (int i=0; i<4; ++i) {
+        threads.emplace_back([] {
+            for (int j=0; j<100; ++j) {
+                nvim::trace_span span("worker");
+            }
+        });
+    }
+
+    nvim::trace_span("main");
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    std::vector<nvim::trace_event> events = nvim::trace_snapshot();
+    CHECK_EQ(events.size(), 401);
+    CHECK_EQ(count(events, "worker"), 400);
+    CHECK_EQ(count(events, "main"), 1);
+
+    std::set<uint32_t> thread_ids;
+
+    for (const nvim::trace_event &event : events) {
+        thread_ids.insert(event.thread);
+    }
+
+    CHECK_EQ(thread_ids.size(), 5);
+    CHECK(std::is_sorted(events.begin(), events.end(), [](auto &left, auto &right) {
+        return left.begin < right.begin;
+    }));
+}
+
+TEST(Trace, Wraparound) {
+    stop_tracing stop;
+    nvim::trace_start();
+    const size_t capacity = nvim::trace_buffer::capacity;
+    const uint64_t base = nvim::trace_clock();
+
+    for (uint64_t i=0; i<capacity + 100; ++i) {
+        nvim::trace_record("wrap", base + i, base + i + 1);
+    }
+
+    // Only the newest capacity events are kept.
+    std::vector<nvim::trace_event> events = nvim::trace_snapshot();
+    CHECK_EQ(events.size(), capacity);
+    CHECK_EQ(events.front().begin, base + 100);
+    CHECK_EQ(events.back().begin, base + capacity + 99);
+}
+
+TEST(Trace, ConcurrentSnapshots) {
+    stop_tracing stop;
+    nvim::trace_start();
+    std::atomic<bool> done = false;
+    const uint64_t base = nvim::trace_clock();
+
+    std::thread writer([&] {
+        for (uint64_t i=0; i<2000000; ++i) {
+            nvim::trace_record("stress", base + i, base + i * 2);
+        }
+
+        done = true;
+    });
+
+    size_t snapshots = 0;
+
+    while (!done || !snapshots) {
+        std::vector<nvim::trace_event> events = nvim::trace_snapshot();
+        snapshots += 1;
+
+        // Torn events would mix fields from different records.
+        for (const nvim::trace_event &event : events) {
+            CHECK(std::string_view(event.name) == "stress");
+            CHECK_EQ(event.end - base, (event.begin - base) * 2);
+        }
+
+        CHECK_LE(events.size(), nvim::trace_buffer::capacity);
+    }
+
+    writer.join();
+    CHECK_GT(snapshots, 0);
+}
+
+TEST(Trace, ChromeJson) {
+    stop_tracing stop;
+    nvim::trace_start();
+
+    {
+        nvim::trace_span outer("outer");
+        nvim::trace_span inner("inner");
+    }
+
+    std::string json = nvim::trace_json();
+    CHECK_EQ(json.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0);
+    CHECK(json.find("\"name\":\"outer\",\"ph\":\"X\"") != std::string::npos);
+    CHECK(json.find("\"name\":\"inner\",\"ph\":\"X\"") != std::string::npos);
+    CHECK(json.find("\"name\":\"thread_name\",\"ph\":\"M\"") != std::string::npos);
+    CHECK(json.ends_with("]}\n"));
+
+    // Brackets are balanced and all strings are terminated.
+    int depth = 0;
+    bool in_string = false;
+
+    for (size_t i=0; i<json.size(); ++i) {
+        char c = json[i];
+
+        if (in_string) {
+            if (c == '\\') {
+                i += 1;
+            } else if (c == '"') {
+                in_string = false;
+            }
+        } else if (c == '"') {
+            in_string = true;
+        } else if (c == '{' || c == '[') {
+            depth += 1;
+        } else if (c == '}' || c == ']') {
+            depth -= 1;
+            CHECK_GE(depth, 0);
+        }
+    }
+
+    CHECK_EQ(depth, 0);
+    CHECK(!in_string);
+
+    std::string path = std::filesystem::temp_directory_path() / "trace-test.json";
+    CHECK_EQ(nvim::trace_write(path.c_str()), 0);
+
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    CHECK(contents.str() == json);
+
+    CHECK_NE(nvim::trace_write("/nonexistent/trace.json"), 0);
+}
+
+BENCHMARK(Trace, SpanPerformance) {
+    stop_tracing stop;
+    nvim::trace_start();
+
+    check::measure([&] {
+        for (int i=0; i<1000000; ++i) {
+            nvim::trace_span span("perf");
+        }
+    });
+}
+
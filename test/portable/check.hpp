@@ -0,0 +1,139 @@
+//
+//  Neovim Mac Test
+//  check.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <functional>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define CHECK_ASAN 1
+#endif
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+#define CHECK_ASAN 1
+#endif
+
+#ifdef CHECK_ASAN
+#include <sanitizer/asan_interface.h>
+#endif
+
+// Tests for the platform neutral parts of the project. They are built into
+// the XCTest bundle, where PortableTests.mm adds each test to a test<Suite>
+// XCTestCase, and into portable_tests with main.cpp, so they can be built
+// and tested without Xcode. Like XCTest assertions, a failed check records
+// the failure and the test carries on.
+
+namespace check {
+
+/// Registers a test function. Use the TEST and BENCHMARK macros instead.
+struct registrar {
+    registrar(const char *suite, const char *name,
+              void (*function)(), bool benchmark);
+};
+
+/// Records a failed check in the running test.
+void fail(const char *file, int line, const std::string &message);
+
+/// Calls function 10 times and reports the average and worst wall time,
+/// like XCTest's measureBlock.
+void measure(const std::function<void()> &function);
+
+/// Formats a value for a failure message, if it can be streamed.
+template<typename T>
+std::string describe(const T &value) {
+    if constexpr (requires(std::ostream &os) { os << value; }) {
+        std::ostringstream stream;
+
+        if constexpr (std::is_same_v<T, unsigned char> ||
+                      std::is_same_v<T, signed char>) {
+            stream << static_cast<int>(value);
+        } else {
+            stream << value;
+        }
+
+        return stream.str();
+    } else {
+        return "?";
+    }
+}
+
+template<typename Left, typename Right, typename Compare>
+void compare(const Left &left, const Right &right, Compare compare,
+             const char *expression, const char *file, int line) {
+    if (!compare(left, right)) {
+        fail(file, line, std::string(expression) + " (" + describe(left) +
+                         " vs " + describe(right) + ")");
+    }
+}
+
+} // namespace check
+
+#define CHECK_CONCAT_IMPL(a, b) a##b
+#define CHECK_CONCAT(a, b) CHECK_CONCAT_IMPL(a, b)
+
+#define CHECK_REGISTER(suite, name, benchmark)                                 \
+static void CHECK_CONCAT(suite##_, name)();                                    \
+static check::registrar CHECK_CONCAT(suite##_registrar_, name)(               \
+    #suite, #name, CHECK_CONCAT(suite##_, name), benchmark);                   \
+static void CHECK_CONCAT(suite##_, name)()
+
+/// Defines a test, run by default.
+#define TEST(suite, name) CHECK_REGISTER(suite, name, false)
+
+/// Defines a benchmark, run when the runner is given --benchmarks.
+#define BENCHMARK(suite, name) CHECK_REGISTER(suite, name, true)
+
+#define CHECK(expression)                                                      \
+    do {                                                                       \
+        if (!(expression)) check::fail(__FILE__, __LINE__, #expression);       \
+    } while (0)
+
+#define CHECK_COMPARE(left, right, op)                                         \
+    check::compare((left), (right),                                            \
+                   [](const auto &l, const auto &r) { return l op r; },        \
+                   #left " " #op " " #right, __FILE__, __LINE__)
+
+#define CHECK_EQ(left, right) CHECK_COMPARE(left, right, ==)
+#define CHECK_NE(left, right) CHECK_COMPARE(left, right, !=)
+#define CHECK_LT(left, right) CHECK_COMPARE(left, right, <)
+#define CHECK_LE(left, right) CHECK_COMPARE(left, right, <=)
+#define CHECK_GT(left, right) CHECK_COMPARE(left, right, >)
+#define CHECK_GE(left, right) CHECK_COMPARE(left, right, >=)
+
+#ifdef CHECK_ASAN
+/// Checks that AddressSanitizer hasn't poisoned addr. An optional string
+/// literal describes the failure.
+#define CHECK_ADDRESS_VALID(addr, ...)                                         \
+    do {                                                                       \
+        if (__asan_address_is_poisoned((addr)))                                \
+            check::fail(__FILE__, __LINE__, "(" #addr ") address is valid"     \
+                        __VA_OPT__(" - " __VA_ARGS__));                        \
+    } while (0)
+
+/// Checks that AddressSanitizer has poisoned addr. An optional string
+/// literal describes the failure.
+#define CHECK_ADDRESS_POISONED(addr, ...)                                      \
+    do {                                                                       \
+        if (!__asan_address_is_poisoned((addr)))                               \
+            check::fail(__FILE__, __LINE__, "(" #addr ") address is poisoned"  \
+                        __VA_OPT__(" - " __VA_ARGS__));                        \
+    } while (0)
+#else
+// No-ops if address sanitizer is not available.
+#define CHECK_ADDRESS_VALID(addr, ...) (void)(addr)
+#define CHECK_ADDRESS_POISONED(addr, ...) (void)(addr)
+#endif
+
+#endif // CHECK_HPP
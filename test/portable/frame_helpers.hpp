@@ -0,0 +1,60 @@
+//
+//  Neovim Mac Test
+//  frame_helpers.hpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#ifndef FRAME_HELPERS_HPP
+#define FRAME_HELPERS_HPP
+
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "frame_builder.hpp"
+
+// Helpers shared by FrameBuilder.cpp and the XCTest only FrameBuilder.mm.
+
+/// Builds frame_builder's bands on a thread each, in place of dispatch_apply_f.
+inline void apply_auto(size_t count, void *context, void (*function)(void*, size_t)) {
+    std::vector<std::thread> threads;
+
+    for (size_t i=0; i<count; ++i) {
+        threads.emplace_back(function, context, i);
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+inline glyph_data make_glyph(const nvim::cell &cell, simd_short2 gridpos) {
+    glyph_rect rect = {};
+    rect.texture_origin.x = cell.grapheme_view()[0];
+    return glyph_data(gridpos, cell.width(), rect);
+}
+
+/// A glyph source that only finds glyphs it has previously been asked to get.
+struct test_glyph_source {
+    std::unordered_set<char> cached;
+    size_t get_count = 0;
+
+    bool find(const nvim::cell &cell, simd_short2 gridpos, glyph_data *data) const {
+        if (cached.count(cell.grapheme_view()[0])) {
+            *data = make_glyph(cell, gridpos);
+            return true;
+        }
+
+        return false;
+    }
+
+    glyph_data get(const nvim::cell &cell, simd_short2 gridpos) {
+        get_count += 1;
+        cached.insert(cell.grapheme_view()[0]);
+        return make_glyph(cell, gridpos);
+    }
+};
+
+#endif // FRAME_HELPERS_HPP
@@ -0,0 +1,110 @@
+//
+//  Neovim Mac Test
+//  main.cpp
+//
+//  Copyright © 2026 Jay Sandhu. All rights reserved.
+//  This file is distributed under the MIT License.
+//  See LICENSE.txt for details.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "check.hpp"
+
+namespace check {
+namespace {
+
+struct test {
+    const char *suite;
+    const char *name;
+    void (*function)();
+    bool benchmark;
+};
+
+std::vector<test>& tests() {
+    static std::vector<test> tests;
+    return tests;
+}
+
+size_t failures = 0;
+
+} // namespace
+
+registrar::registrar(const char *suite, const char *name,
+                     void (*function)(), bool benchmark) {
+    tests().push_back({suite, name, function, benchmark});
+}
+
+void fail(const char *file, int line, const std::string &message) {
+    fprintf(stderr, "%s:%d: error: %s\n", file, line, message.c_str());
+    failures += 1;
+}
+
+void measure(const std::function<void()> &function) {
+    using clock = std::chrono::steady_clock;
+    double total = 0;
+    double worst = 0;
+
+    for (int i=0; i<10; ++i) {
+        auto start = clock::now();
+        function();
+        std::chrono::duration<double> elapsed = clock::now() - start;
+
+        total += elapsed.count();
+        worst = std::max(worst, elapsed.count());
+    }
+
+    printf("    average: %.6fs, worst: %.6fs\n", total / 10, worst);
+}
+
+} // namespace check
+
+/// Usage: portable_tests [--benchmarks] [suite...]
+///
+/// Runs the tests in the given suites, or every suite if none are given.
+/// Benchmarks are only run with --benchmarks, and tests are then skipped.
+int main(int argc, char **argv) {
+    bool benchmarks = false;
+    std::vector<const char*> suites;
+
+    for (int i=1; i<argc; ++i) {
+        if (strcmp(argv[i], "--benchmarks") == 0) {
+            benchmarks = true;
+        } else {
+            suites.push_back(argv[i]);
+        }
+    }
+
+    size_t ran = 0;
+    size_t failed = 0;
+
+    for (const check::test &test : check::tests()) {
+        if (test.benchmark != benchmarks) continue;
+
+        bool selected = suites.empty() ||
+                        std::any_of(suites.begin(), suites.end(), [&](const char *suite) {
+            return strcmp(suite, test.suite) == 0;
+        });
+
+        if (!selected) continue;
+
+        size_t failures = check::failures;
+        printf("%s.%s\n", test.suite, test.name);
+        fflush(stdout);
+
+        test.function();
+        ran += 1;
+
+        if (check::failures != failures) {
+            printf("    failed\n");
+            failed += 1;
+        }
+    }
+
+    printf("%zu run, %zu failed\n", ran, failed);
+    return ran && !failed ? 0 : 1;
+}